@@ -0,0 +1,816 @@
+// ! Master/Slave Co-simulation ! ==============================================
+
+// builds both sketches into one process, each in its own namespace with its
+// own Serial, joined by hal::bus() and stepped in lockstep on virtual
+// clocks. a scripted user turns the knobs and the run ends with a report on
+// loop() cost and breath timing
+//
+//   ./cosim [-t seconds] [-v] [-g] [-a] [-e] [-k] [-c] [-p] [-l patient]
+//     -t  virtual run time, default 60
+//     -v  echo both boards' Serial output
+//     -g  run the slave alone over the volume x inhale grid and report the
+//         inhale stroke timing error instead
+//     -a  block the airway, then disconnect it, for the alarms to catch
+//     -e  boot the master with a baseline left in EEPROM by an earlier boot,
+//         a little off the room's, rather than blank EEPROM
+//     -k  spin two knobs hard at once, for the decoder to keep every step
+//     -c  give the master a bench fitted volume curve for the slave, which
+//         has the nominal one in flash, to upload and keep
+//     -p  select Pressure Control and steer inhales to a 20 cmH2O peak
+//     -l  ventilate one of the patients below rather than the adult
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_MPRLS.h>
+#include <Fonts/FreeSans12pt7b.h>
+#include <Fonts/FreeSans18pt7b.h>
+#include <Fonts/FreeSansBold12pt7b.h>
+#include <Fonts/FreeSansBold18pt7b.h>
+#include <SpeedyStepper.h>
+#include <UTFTGLUE.h>
+#include <avr/eeprom.h>
+#include <util/atomic.h>
+#include <util/twi.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+
+hal::Board masterBoard("master");
+hal::Board slaveBoard("slave");
+
+// * SKETCHES ==================================================================
+
+namespace master {
+HardwareSerial Serial(masterBoard);
+#include "../master/master.ino"
+#include "../master/alarm.cpp"
+#include "../master/animation.cpp"
+#include "../master/analysis.cpp"
+#include "../master/baseline.cpp"
+#include "../master/chart.cpp"
+#include "../master/comm.cpp"
+#include "../master/dial.cpp"
+#include "../master/i2c.cpp"
+#include "../master/knobs.cpp"
+#include "../master/logger.cpp"
+#include "../master/memory.cpp"
+#include "../master/pressure.cpp"
+#include "../master/scheduler.cpp"
+#include "../master/stream.cpp"
+#include "../master/util.cpp"
+}  // namespace master
+
+namespace slave {
+HardwareSerial Serial(slaveBoard);
+TwoWire        Wire(slaveBoard);
+#include "../slave/slave.ino"
+#include "../slave/calibration.cpp"
+#include "../slave/control.cpp"
+#include "../slave/logger.cpp"
+#include "../slave/memory.cpp"
+#include "../slave/stepgen.cpp"
+}  // namespace slave
+
+#include "logdecode.h"
+
+// * PLANT =====================================================================
+
+MPRLSModel pressureSensor;
+
+// the motor shaft, turned a step on each rising edge of the slave's STEP pin
+// in the direction on its DIR pin. it starts part way round so setup() has to
+// home it. steps from the step generator are timed against the interval the
+// timer was loaded with, which is the jitter the motor sees
+struct Shaft {
+    long       position = 600;
+    uint64_t   steps = 0, lastNs = 0;
+    double     sps = 0;  // signed, from the last interval
+    hal::Stats late, jitter;
+
+    void output(uint8_t pin) {
+        if (pin != slave::STEP || !slaveBoard.level[pin])
+            return;
+        uint64_t now = slaveBoard.ns;
+        int      dir = slaveBoard.level[slave::DIR] ? -1 : 1;
+        if (slave::stepgen.running) {
+            late.add(slave::stepgen.lateLast / 2.0);
+            // a tracking move's holds go by without a step, its intervals
+            // aren't one compare each
+            if (slave::stepgen.done > 0 && !slave::stepgen.tracking) {
+                const hal::Timer16 &t = slaveBoard.timer1;
+                jitter.add((double(now - lastNs) - (t.compare + 1.0) * t.tickNs()) / 1e3);
+            }
+        }
+        sps = lastNs ? dir * 1e9 / double(now - lastNs) : 0;
+        position += dir;
+        steps++;
+        lastNs = now;
+    }
+
+    // a shaft that has gone twice its last interval without a step is stopped
+    double velocity() const {
+        return sps && slaveBoard.ns - lastNs > 2e9 / std::fabs(sps) ? 0 : sps;
+    }
+} shaft;
+
+// the patients a run can ventilate, picked with -l, the first by default
+struct Patient {
+    const char *name;
+    double      compliance, resistance, peep, leak;  // L/cmH2O, cmH2O/L/s, cmH2O, L/s/cmH2O
+};
+
+const Patient patients[] = {
+    {"adult", 0.040, 10, 5, 0},     // healthy, sedated
+    {"ards", 0.020, 12, 10, 0},     // stiff lungs on a high PEEP
+    {"copd", 0.060, 25, 5, 0},      // obstructed airway, slow to empty
+    {"child", 0.015, 30, 5, 0},     // small and narrow
+    {"leak", 0.040, 10, 5, 0.010},  // a mask that leaks 12 L/min at 20 cmH2O
+};
+
+// a single compartment lung behind the bag, read by the sensor at the wye.
+// air the bellows pushes out goes through the airway resistance into a lung
+// of fixed compliance, so the wye reads the lung plus resistance times flow.
+// the bag held squeezed keeps the patient valve shut and the lung holds its
+// plateau. once the arm runs back the lung empties through the airway and the
+// exhale limb to the PEEP valve, which shuts at its setting, and the wye
+// reads the valve plus the limb's drop. a leak at the wye loses flow in
+// proportion to its pressure all the time, and off the circuit the lung
+// empties to the room and the wye reads nothing. it sits at atmosphere until
+// the first breath. the bellows volume is the nominal arm geometry the
+// slave's flash curve is made from, run forward, and the lung is run on at
+// every step and every read, so the sensor can take the mean over its
+// conversion however the two boards' clocks sit
+struct Lung {
+    static constexpr double   STEP = 0.0005;    // longest integration step (s)
+    static constexpr uint64_t KEPT = 50000000;  // history held for the sensor (ns)
+
+    double   compliance = 0.04, resistance = 10, peep = 5, leak = 0;  // as Patient
+    double   limb = 3;               // exhale limb and valve, cmH2O/L/s
+    double   volume = 0, cmH2O = 0;  // L over relaxed, at the wye now
+    double   bellows = 0;            // L the arm has pushed out of the bag
+    double   area = 0, reading = 0;  // cmH2O s at the wye so far, last mean read
+    uint64_t last  = 0;
+    uint32_t noise = 1;
+    bool     open  = false;  // off the circuit, the sensor sees the room
+    std::deque<std::pair<uint64_t, double>> history;  // (ns, area)
+
+    static double litres(double steps) {
+        double deg = steps / 88.889;
+        return std::max(0.0, 0.2 + (deg - 7.5) * 0.6 / 17.5);
+    }
+
+    void set(const Patient &p) {
+        compliance = p.compliance;
+        resistance = p.resistance;
+        peep       = p.peep;
+        leak       = p.leak;
+    }
+
+    // runs the lung on to ns with the arm where it is now
+    void advance(uint64_t ns) {
+        long x = std::max(0L, shaft.position);
+        if (!last)
+            bellows = litres(x);  // where the arm was left, nothing pushed yet
+        if (ns <= last)
+            return;
+        double v    = shaft.velocity();
+        double flow = std::max(0.0, v) * (litres(x + 1) - litres(x));  // L/s
+        double in   = std::max(0.0, litres(x) - bellows);
+        bool   held = v >= 0 && litres(x) > 0;
+        bellows     = litres(x);
+        double dt   = (ns - last) / 1e9;
+        int    n    = int(std::ceil(dt / STEP));
+        double h    = dt / n;
+        for (int i = 1; i <= n; i++) {
+            double lung = volume / compliance, out = 0;
+            if (open) {
+                out   = lung / resistance;
+                cmH2O = 0;
+            } else if (flow > 0 || held) {
+                cmH2O = lung + resistance * flow;
+            } else if (lung > peep) {
+                out   = (lung - peep) / (resistance + limb);
+                cmH2O = lung - resistance * out;
+            } else {
+                cmH2O = lung;
+            }
+            volume = std::max(0.0, volume + in / n - (out + leak * cmH2O) * h);
+            area += cmH2O * h;
+            history.push_back({last + uint64_t((ns - last) * double(i) / n), area});
+        }
+        last = ns;
+        while (history.size() > 2 && history.front().first + KEPT < ns)
+            history.pop_front();
+    }
+
+    // area up to ns, between the points either side
+    double areaAt(uint64_t ns) const {
+        auto b = std::lower_bound(history.begin(), history.end(), ns,
+                                  [](const std::pair<uint64_t, double> &p, uint64_t t) {
+                                      return p.first < t;
+                                  });
+        if (b == history.begin())
+            return b->second;
+        if (b == history.end())
+            return history.back().second;
+        auto a = b - 1;
+        return a->second + (b->second - a->second) * double(ns - a->first) /
+                               double(b->first - a->first);
+    }
+
+    // the sensor's conversion from..to, as absolute pressure with its noise
+    double hpa(uint64_t from, uint64_t to) {
+        advance(to);
+        reading = (areaAt(to) - areaAt(from)) / ((to - from) / 1e9);
+        noise   = noise * 1103515245 + 12345;
+        return (reading + (int((noise >> 16) % 201) - 100) / 1000.0) / 1.0197 + 1013.25;
+    }
+} lung;
+
+// breath phase boundaries seen on the slave, checked after every clock tick
+struct BreathProbe {
+    int      state   = -1;
+    uint64_t entered = 0;
+    int      target  = 0;
+    hal::Stats inhale, inhaleError, stroke, exhale, cycle, rest, tidal;
+    uint64_t   cycleStart = 0, firstNs = 0;
+    double     lungStart  = 0;  // L, as the inhale began
+
+    void check() {
+        int s = slave::breath.state;
+        if (s == state)
+            return;
+        uint64_t now = slaveBoard.ns;
+        double   ms  = (now - entered) / 1e6;
+        if (state == 0)
+            rest.add(ms);
+        if (state == 1) {
+            inhale.add(ms);
+            inhaleError.add(ms - target);
+        }
+        if (state == 2)
+            exhale.add(ms);
+        if (state == 1 || s == 1)
+            lung.advance(now);
+        if (state == 1) {
+            stroke.add(slave::breath.inhaleDiff);
+            tidal.add((lung.volume - lungStart) * 1000);
+        }
+        if (s == 1) {
+            lungStart = lung.volume;
+            if (!firstNs)
+                firstNs = now;
+            if (cycleStart)
+                cycle.add((now - cycleStart) / 1e6);
+            cycleStart = now;
+            target     = slave::breath.inhalePeriod;
+        }
+        state   = s;
+        entered = now;
+    }
+} breaths;
+
+// spacing of the master's pressure samples, read back from its ring, and the
+// peak, plateau and PEEP it reports for each breath
+struct SampleProbe {
+    uint16_t      head    = 0;
+    unsigned long breaths = 0;
+    hal::Stats    interval, peak, plateau, peep;
+
+    void check() {
+        if (master::analysis.breaths != breaths) {
+            breaths = master::analysis.breaths;
+            peak.add(master::cmH20.peak.raw() / 65536.0);
+            plateau.add(master::cmH20.plateau.raw() / 65536.0);
+            peep.add(master::cmH20.peep.raw() / 65536.0);
+        }
+        uint16_t h = master::mprls.head;
+        for (; head != h; head++) {
+            if (head == 0)
+                continue;
+            const auto &ring = master::mprls.ring;
+            unsigned long a  = ring[uint8_t(head - 1) % master::PRESSURE_SAMPLES].us;
+            unsigned long b  = ring[uint8_t(head) % master::PRESSURE_SAMPLES].us;
+            interval.add((b - a) / 1e3);
+        }
+    }
+} samples;
+
+// faults for the master's I2C engine to ride out: the sensor holds SDA low
+// part way through a byte at STUCK_AT, and the slave drops off the bus for
+// the window after NACK_AT, as it would across a reset
+struct BusFaults {
+    static constexpr double STUCK_AT = 20.0, NACK_AT = 40.0, NACK_FOR = 6.0;
+
+    bool stuck = false, detached = false, reattached = false;
+
+    void check() {
+        double s = masterBoard.ns / 1e9;
+        if (!stuck && s >= STUCK_AT) {
+            stuck                 = true;
+            masterBoard.twi.stuck = 5;
+        }
+        if (!detached && s >= NACK_AT) {
+            detached = true;
+            hal::bus().devices.erase(slave::SLAVE_ADDR);
+        }
+        if (detached && !reattached && s >= NACK_AT + NACK_FOR) {
+            reattached = true;
+            hal::bus().attach(slave::SLAVE_ADDR, &slave::Wire);
+        }
+    }
+} faults;
+
+// faults for the alarms to catch, with -a: the airway blocks at OCCLUDE_AT so
+// every breath pushes past MAX_PEAK, clears OCCLUDE_FOR later, the latched
+// alarm is acked at ACK_AT and the circuit comes off at DISCONNECT_AT. the
+// time from the sensor first reading past the limit to the speaker starting
+// is taken here on the harness clock, apart from the sketch's own measure
+struct AlarmFaults {
+    static constexpr double OCCLUDE_AT = 24.0, OCCLUDE_FOR = 8.0, ACK_AT = 34.0,
+                            DISCONNECT_AT = 36.0;
+
+    bool       on = false, occluded = false, cleared = false, disconnected = false;
+    double     compliance = 0;  // the patient's, put back once the block clears
+    uint64_t   overNs = 0, disconnectNs = 0, tones = 0;
+    double     overToTone = -1, disconnectToTone = -1;  // ms, -1 till heard
+
+    void check() {
+        if (!on)
+            return;
+        double s = masterBoard.ns / 1e9;
+        if (!occluded && s >= OCCLUDE_AT) {
+            occluded        = true;
+            compliance      = lung.compliance;
+            lung.compliance = 0.01;
+        }
+        if (occluded && !cleared && s >= OCCLUDE_AT + OCCLUDE_FOR) {
+            cleared         = true;
+            lung.compliance = compliance;
+        }
+        if (!disconnected && s >= DISCONNECT_AT) {
+            disconnected = true;
+            disconnectNs = masterBoard.ns;
+            lung.open    = true;
+        }
+    }
+
+    // the wye as the sensor read it over the conversion ending at ns
+    void sampled(uint64_t ns) {
+        if (occluded && !overNs && lung.reading > master::MAX_PEAK.raw() / 65536.0)
+            overNs = ns;
+    }
+
+    // the first tone after each fault is the one that counts
+    void output(uint8_t pin) {
+        if (pin != master::speaker || !masterBoard.toneHz[pin])
+            return;
+        tones++;
+        if (overNs && overToTone < 0)
+            overToTone = (masterBoard.ns - overNs) / 1e6;
+        if (disconnectNs && disconnectToTone < 0 &&
+            master::alarms.sounding == master::ALARM_LOW)
+            disconnectToTone = (masterBoard.ns - disconnectNs) / 1e6;
+    }
+} alarmFaults;
+
+// with -p, the inhales the slave steers at PEAK, each measured at the wye
+// as the sensor reads it: how far past the target it went, how long
+// it took to get 90% of the way from where it started, and where it was as
+// the inhale ended. the slave's wait on each sample it uses is taken here,
+// which with the master's conversion to off the bus is the whole way from
+// the sensor to the stepper. an inhale going more than OVERSHOOT past the
+// target fails the run
+struct PressureProbe {
+    static constexpr double PEAK = 20.0, OVERSHOOT = 2.0;
+
+    bool       on = false, steering = false;
+    int        state = -1;
+    unsigned   used  = 0;
+    uint64_t   entered = 0, riseNs = 0;
+    double     start = 0, top = 0, last = 0;
+    long       missed = 0;  // inhales that never got 90% of the way
+    long       over   = 0;  // inhales past PEAK + OVERSHOOT
+    hal::Stats overshoot, rise, plateau, delivered, wait;
+
+    void sampled(uint64_t ns) {
+        if (!steering)
+            return;
+        top  = std::max(top, lung.reading);
+        last = lung.reading;
+        if (!riseNs && lung.reading >= start + 0.9 * (PEAK - start))
+            riseNs = ns;
+    }
+
+    void check() {
+        if (!on)
+            return;
+        if (slave::control.used > used)
+            wait.add(double(slave::control.latency) - slave::feed.age);
+        used  = slave::control.used;
+        int s = slave::breath.state;
+        if (s == state)
+            return;
+        if (state == 1 && steering) {
+            steering = false;
+            overshoot.add(top - PEAK);
+            if (top - PEAK > OVERSHOOT)
+                over++;
+            plateau.add(last);
+            delivered.add(slave::breath.delivered);
+            if (riseNs)
+                rise.add((riseNs - entered) / 1e6);
+            else
+                missed++;
+        }
+        if (s == 1 && slave::breath.pressureControl && slave::breath.peak == int(PEAK * 256)) {
+            steering = true;
+            entered  = slaveBoard.ns;
+            start = top = last = lung.reading;
+            riseNs             = 0;
+        }
+        state = s;
+    }
+
+    void print() const {
+        std::printf("  pressure control         target %.1f cmH2O, %llu inhales steered,"
+                    " %ld short of 90%%\n",
+                    PEAK, (unsigned long long)overshoot.count, missed);
+        overshoot.print("wye peak - target", "cmH2O");
+        std::printf("  overshoot                %ld inhales over %.1f cmH2O%s\n", over, OVERSHOOT,
+                    over ? ", FAIL" : "");
+        rise.print("rise to 90%", "ms");
+        plateau.print("wye at inhale end", "cmH2O");
+        delivered.print("delivered", "mL");
+        std::printf("  pressure stream          %lu sent, %lu dropped, conversion to off the"
+                    " bus last=%lu max=%lu us\n",
+                    master::stream.sent, master::stream.dropped, master::stream.latency,
+                    master::stream.latencyMax);
+        std::printf("  pressure loop            %lu received, %u stale last inhale, conversion"
+                    " to speed max %u us last inhale\n",
+                    slave::feed.received, slave::control.stale, slave::control.latencyMax);
+        wait.print("sample wait on slave", "us");
+        std::printf("  sensor to stepper        %.0f us at most\n",
+                    master::stream.latencyMax + wait.max);
+    }
+} pressure;
+
+// every volume and inhale setting in turn, GRID_STROKES strokes each with no
+// rest between. the first stroke at a setting has only what its trim band
+// learned from the settings before it, the last has had its own corrections
+struct GridProbe {
+    static const int GRID_STROKES = 4;
+    static const int VOLUMES      = (slave::MAX_TV - slave::MIN_TV) / slave::INC_TV + 1;
+    static const int INHALES      = (slave::MAX_IT - slave::MIN_IT) / slave::INC_IT + 1;
+
+    int        cell = 0, stroke = 0, state = -1;
+    int        last[VOLUMES][INHALES] = {};
+    long       limited = 0;
+    hal::Stats first, trimmed, fitted;
+    hal::Scheduler *scheduler = nullptr;
+
+    void set() {
+        using namespace slave;
+        breath.volume       = volumeTarget = MIN_TV + cell / INHALES * INC_TV;
+        breath.inhalePeriod = inhaleTarget = MIN_IT + cell % INHALES * INC_IT;
+        breath.restPeriod   = 0;
+        atVolumeTarget = atInhaleTarget = true;
+    }
+
+    void check() {
+        int s = slave::breath.state;
+        if (s == state)
+            return;
+        if (state == -1)
+            set();
+        if (state == 1 && s == 2) {
+            int error = slave::breath.inhaleDiff;
+            if (stroke == 0)
+                first.add(error);
+            if (++stroke == GRID_STROKES) {
+                trimmed.add(error);
+                last[cell / INHALES][cell % INHALES] = error;
+                limited += slave::breath.planLimited;
+                if (!slave::breath.planLimited)
+                    fitted.add(std::abs(error));
+                stroke = 0;
+                if (++cell == VOLUMES * INHALES)
+                    scheduler->stop();
+                else
+                    set();
+            }
+        }
+        state = s;
+    }
+
+    void print() const {
+        std::printf("planner grid: %d volumes x %d inhale times, %d strokes each\n",
+                    VOLUMES, INHALES, GRID_STROKES);
+        first.print("first stroke error", "ms");
+        trimmed.print("trimmed stroke error", "ms");
+        fitted.print("|error| where it fits", "ms");
+        std::printf("  settings the plan can't fit %ld\n", limited);
+        std::printf("\ntrimmed error (ms) by volume (mL) and inhale time (ms)\n      ");
+        for (int i = 0; i < INHALES; i += 5)
+            std::printf("%6d", slave::MIN_IT + i * slave::INC_IT);
+        std::printf("\n");
+        for (int v = 0; v < VOLUMES; v += 5) {
+            std::printf("%6d", slave::MIN_TV + v * slave::INC_TV);
+            for (int i = 0; i < INHALES; i += 5)
+                std::printf("%6d", last[v][i]);
+            std::printf("\n");
+        }
+    }
+} grid;
+
+// * SCENARIO ==================================================================
+
+// a user who selects Mandatory Mode, walks volume up and inhale time down and
+// pushes the knob to send each change
+void scenario(hal::Knob &volume, hal::Knob &bpm, hal::Knob &inhale) {
+    masterBoard.input[master::slcPin1] = [] { return LOW; };
+
+    volume.turn(3000, 5, 400);
+    volume.press(4000, 300);
+    inhale.turn(8000, -6, 600);
+    volume.press(9000, 300);
+    bpm.turn(14000, 4, 400);
+    volume.press(15000, 300);
+    volume.turn(30000, -8, 200);  // a quick spin
+    volume.press(31000, 300);
+}
+
+// with -k, volume and inhale time are both spun across their scales in a
+// tenth of a second, 2 ms a quadrature step, while each change redraws its
+// needle
+void spin(hal::Knob &volume, hal::Knob &inhale) {
+    volume.turn(20000, -24, 100);
+    inhale.turn(20000, 24, 100);
+    volume.press(21000, 300);
+}
+
+// with -p, a user who selects Pressure Control, walks the peak target from
+// its default down to PressureProbe::PEAK on the first knob and pushes it
+void pressureScenario(hal::Knob &volume) {
+    masterBoard.input[master::slcPin3] = [] { return LOW; };
+
+    int detents = int((PressureProbe::PEAK - master::DEFAULT_PEAK.raw() / 65536.0) / 0.5);
+    volume.turn(3000, detents, 4000);
+    volume.press(8000, 300);
+}
+
+// with -c, the curve a bench run might fit for a stiffer bag than the
+// nominal one, the stroke running up to 8% longer toward the top
+uint16_t fittedCurve[CURVE_POINTS];
+
+void fitCurve() {
+    for (int k = 0; k < CURVE_POINTS; k++)
+        fittedCurve[k] =
+            uint16_t(std::lround(slave::curveSteps[k] * (1 + 0.08 * k / (CURVE_POINTS - 1))));
+    master::upload.steps = fittedCurve;
+}
+
+// * MAIN ======================================================================
+
+int main(int argc, char **argv) {
+    double         seconds = 60;
+    bool           gridRun = false, cached = false, spun = false, fitted = false;
+    const Patient *patient = &patients[0];
+    for (int n = 1; n < argc; n++) {
+        if (!std::strcmp(argv[n], "-t") && n + 1 < argc)
+            seconds = std::atof(argv[++n]);
+        else if (!std::strcmp(argv[n], "-v"))
+            masterBoard.echo = slaveBoard.echo = true;
+        else if (!std::strcmp(argv[n], "-g"))
+            gridRun = true;
+        else if (!std::strcmp(argv[n], "-a"))
+            alarmFaults.on = true;
+        else if (!std::strcmp(argv[n], "-e"))
+            cached = true;
+        else if (!std::strcmp(argv[n], "-k"))
+            spun = true;
+        else if (!std::strcmp(argv[n], "-c"))
+            fitted = true;
+        else if (!std::strcmp(argv[n], "-p"))
+            pressure.on = true;
+        else if (!std::strcmp(argv[n], "-l") && n + 1 < argc) {
+            const char *name = argv[++n];
+            patient          = nullptr;
+            for (const Patient &p : patients)
+                if (!std::strcmp(p.name, name))
+                    patient = &p;
+            if (!patient) {
+                std::fprintf(stderr, "cosim: no patient %s, try", name);
+                for (const Patient &p : patients)
+                    std::fprintf(stderr, " %s", p.name);
+                std::fprintf(stderr, "\n");
+                return 1;
+            }
+        }
+    }
+    lung.set(*patient);
+
+    if (gridRun) {
+        hal::Scheduler scheduler;
+        slaveBoard.input[slave::LIMIT] = [] { return shaft.position > 0; };
+        slaveBoard.output              = [](uint8_t pin) { shaft.output(pin); };
+        slaveBoard.timer1.vector       = slave::TIMER1_COMPA_vect;
+        slaveBoard.probe               = [] { grid.check(); };
+        grid.scheduler                 = &scheduler;
+        scheduler.add(slaveBoard, slave::setup, slave::loop);
+        scheduler.run(UINT64_MAX);
+        grid.print();
+        shaft.late.print("step late", "us");
+        shaft.jitter.print("step interval jitter", "us");
+        std::printf("  heap changes             %u after setup (%llu String objects in all)\n",
+                    slave::memory.heapChanges, (unsigned long long)slaveBoard.strings);
+        return 0;
+    }
+
+    hal::Knob enc1(masterBoard, master::enc1clkPin, master::enc1dtPin, master::enc1buttonPin);
+    hal::Knob enc2(masterBoard, master::enc2clkPin, master::enc2dtPin, master::enc2buttonPin);
+    hal::Knob enc3(masterBoard, master::enc3clkPin, master::enc3dtPin, master::enc3buttonPin);
+    if (pressure.on)
+        pressureScenario(enc1);
+    else
+        scenario(enc1, enc2, enc3);
+    if (spun)
+        spin(enc1, enc3);
+
+    pressureSensor.hpa = [](uint64_t from, uint64_t to) {
+        double hpa = lung.hpa(from, to);
+        alarmFaults.sampled(to);
+        pressure.sampled(to);
+        return hpa;
+    };
+    // the room reads 1033.21 cmH2O absolute at rest
+    if (cached) {
+        int32_t raw                     = master::q16(1033.5).raw();
+        master::baselineRecord record = {raw, ~raw};
+        std::memcpy(masterBoard.eeprom + master::BASELINE_ADDRESS, &record, sizeof(record));
+    }
+    if (fitted)
+        fitCurve();
+    if (alarmFaults.on)
+        enc2.press(uint64_t(AlarmFaults::ACK_AT * 1000), 300);
+
+    // the bellows arm closes the limit switch at its home stop
+    slaveBoard.input[slave::LIMIT] = [] { return shaft.position > 0; };
+    slaveBoard.output              = [](uint8_t pin) {
+        shaft.output(pin);
+        lung.advance(slaveBoard.ns);
+    };
+    slaveBoard.timer1.vector       = slave::TIMER1_COMPA_vect;
+
+    // a device holding SDA low lets go after enough SCL clocks
+    masterBoard.timer1.vector          = master::TIMER1_COMPA_vect;
+    masterBoard.twi.vector             = master::TWI_vect;
+    masterBoard.input[master::I2C_SDA] = [] { return masterBoard.twi.stuck ? LOW : HIGH; };
+    masterBoard.output                 = [](uint8_t pin) {
+        if (pin == master::I2C_SCL && masterBoard.level[pin] == LOW)
+            masterBoard.twi.clock();
+        alarmFaults.output(pin);
+    };
+
+    hal::Stats masterLoop, slaveLoop;
+    masterBoard.loopDone = [&](uint64_t ns) { masterLoop.add(ns / 1e3); };
+    slaveBoard.loopDone  = [&](uint64_t ns) { slaveLoop.add(ns / 1e3); };
+    masterBoard.probe    = [] { samples.check(); faults.check(); alarmFaults.check(); };
+
+    // both boards log in binary, echoed back as text at the time it was logged
+    LogDecoder masterLog, slaveLog;
+    auto       decode = [](hal::Board &b, LogDecoder &d) {
+        return [&b, &d](uint8_t c) {
+            bool done;
+            if (!d.feed(c, &done))
+                return false;
+            if (done)
+                b.print(d.ms * 1000000, d.text);
+            return true;
+        };
+    };
+    masterBoard.serial = decode(masterBoard, masterLog);
+    slaveBoard.serial  = decode(slaveBoard, slaveLog);
+    slaveBoard.probe     = [] { breaths.check(); pressure.check(); };
+
+    hal::Scheduler scheduler;
+    scheduler.add(masterBoard, master::setup, master::loop);
+    scheduler.add(slaveBoard, slave::setup, slave::loop);
+    scheduler.run(uint64_t(seconds * 1e9));
+
+    hal::Bus &bus = hal::bus();
+    std::printf("cosim: %.1f s virtual\n", seconds);
+    std::printf("patient %s: compliance %.0f mL/cmH2O, resistance %.0f cmH2O/L/s, PEEP %.0f"
+                " cmH2O, leak %.0f mL/s/cmH2O\n",
+                patient->name, patient->compliance * 1000, patient->resistance, patient->peep,
+                patient->leak * 1000);
+    std::printf("master\n");
+    masterLoop.print("loop()", "us");
+    std::printf("  display                  %llu pixels in %llu windows\n",
+                (unsigned long long)master::display.pixels,
+                (unsigned long long)master::display.windows);
+    std::printf("  pressure conversions     %llu\n",
+                (unsigned long long)pressureSensor.conversions);
+    std::printf("  pressure samples         %lu (%u Hz last second, %lu dropped, %lu faults)\n",
+                master::mprls.samples, master::mprls.rate,
+                master::mprls.dropped, master::mprls.faults);
+    samples.interval.print("sample interval", "ms");
+    samples.peak.print("breath peak", "cmH2O");
+    samples.plateau.print("breath plateau", "cmH2O");
+    samples.peep.print("breath peep", "cmH2O");
+    std::printf("  scheduler                %lu passes, %lu idle\n",
+                master::sched.passes, master::sched.idle);
+    for (uint8_t i = 0; i < master::sched.count; i++) {
+        const master::task &k = master::sched.tasks[i];
+        char name[12];
+        strcpy_P(name, k.name);
+        std::printf("    %-9s %6lu us  %7lu runs  late max %6lu us  cost max %6lu us"
+                    "  %lu overruns  %lu skipped\n",
+                    name, k.period, k.runs, k.lateMax, k.costMax, k.overruns, k.skipped);
+    }
+    std::printf("  heap changes             %u after setup (%llu String objects in all)\n",
+                master::memory.heapChanges, (unsigned long long)masterBoard.strings);
+    std::printf("  animation                %lu frames drawn, %lu out of budget\n",
+                master::animation.frames, master::animation.deferred);
+    std::printf("  knobs                    %d/%d/%d steps turned, %d/%d/%d counted,"
+                " positions %d/%d/%d\n",
+                enc1.turned(masterBoard.ns), enc2.turned(masterBoard.ns),
+                enc3.turned(masterBoard.ns), master::knobs.count[0], master::knobs.count[1],
+                master::knobs.count[2], master::volume.targetPosition,
+                master::bpm.targetPosition, master::inhale.targetPosition);
+    std::printf("  boot                     sensor %lu ms, ui %lu ms, first inhale seen %lu ms\n",
+                master::boot.sensor, master::boot.ui, master::boot.breath);
+    master::baselineRecord kept;
+    std::memcpy(&kept, masterBoard.eeprom + master::BASELINE_ADDRESS, sizeof(kept));
+    std::printf("  baseline                 %.3f cmH2O from %s, settled at %lu ms on %u samples,"
+                " EEPROM holds %.3f\n",
+                master::cmH20.atmosphere.raw() / 65536.0,
+                master::baseline.cached ? "EEPROM" : "a sample", master::baseline.settledAt,
+                master::baseline.taken, kept.atmosphere / 65536.0);
+    for (uint8_t i = 0; i < master::ALARMS; i++) {
+        const master::alarmState &a = master::alarms.alarm[i];
+        std::printf("  alarm %-6s  %lu raised, sample to tone last=%lu max=%lu us%s\n",
+                    master::alarmLayouts[i].name, a.raised, a.latency, a.latencyMax,
+                    a.active ? ", active" : a.latched ? ", latched" : "");
+    }
+    if (alarmFaults.on)
+        std::printf("  alarm faults             %llu tones, over-pressure heard %.1f ms after"
+                    " its sample, disconnect %.1f ms after\n",
+                    (unsigned long long)alarmFaults.tones, alarmFaults.overToTone,
+                    alarmFaults.disconnectToTone);
+    std::printf("slave\n");
+    slaveLoop.print("loop()", "us");
+    breaths.rest.print("rest", "ms");
+    breaths.inhale.print("inhale", "ms");
+    breaths.inhaleError.print("inhale - target", "ms");
+    breaths.stroke.print("stroke - target", "ms");
+    breaths.exhale.print("exhale", "ms");
+    breaths.cycle.print("cycle", "ms");
+    breaths.tidal.print("into the lung", "mL");
+    std::printf("  first breath             %.1f ms\n", breaths.firstNs / 1e6);
+    slave::calibrationRecord stored;
+    std::memcpy(&stored, slaveBoard.eeprom + slave::CALIBRATION_ADDRESS, sizeof(stored));
+    std::printf("  volume curve             %04x, booted from %s, EEPROM holds %04x;"
+                " master wants %04x, %u uploads\n",
+                slave::calibration.record.check, slave::calibration.stored ? "EEPROM" : "flash",
+                stored.check, master::upload.check, master::upload.uploads);
+    std::printf("  last inhale              %d steps for %d mL\n", slave::breath.steps,
+                slave::breath.pressureControl ? slave::breath.delivered : slave::breath.volume);
+    if (pressure.on)
+        pressure.print();
+    std::printf("  steps                    %llu\n", (unsigned long long)shaft.steps);
+    shaft.late.print("step late", "us");
+    shaft.jitter.print("step interval jitter", "us");
+    std::printf("  heap changes             %u after setup (%llu String objects in all)\n",
+                slave::memory.heapChanges, (unsigned long long)slaveBoard.strings);
+    std::printf("i2c\n");
+    std::printf("  transactions             %llu (%llu bytes, %llu nack)\n",
+                (unsigned long long)bus.transactions,
+                (unsigned long long)bus.bytes,
+                (unsigned long long)bus.nacks);
+    std::printf("  engine                   %lu transfers (%lu failed), %lu retries, %lu nacks\n",
+                master::i2c.transfers, master::i2c.failed, master::i2c.retries,
+                master::i2c.nacks);
+    std::printf("  engine faults            %lu timeouts, %lu bus errors, %lu recoveries,"
+                " %lu full\n",
+                master::i2c.timeouts, master::i2c.busErrors, master::i2c.recoveries,
+                master::i2c.full);
+    std::printf("  engine queue             depth max %u, latency last=%lu max=%lu us\n",
+                master::i2c.depthMax, master::i2c.latency, master::i2c.latencyMax);
+    std::printf("  frames                   %lu (%lu acked, %lu rejected, %lu retries, %lu failed)\n",
+                master::slaveLink.frames, master::slaveLink.acked,
+                master::slaveLink.rejected, master::slaveLink.retries,
+                master::slaveLink.failed);
+    std::printf("  frame latency            last=%lu max=%lu us\n",
+                master::slaveLink.latency, master::slaveLink.latencyMax);
+    std::printf("  status polls             %lu (%lu failed), last %u mL in %u ms, %u ms cycle\n",
+                master::slaveLink.polls, master::slaveLink.pollsFailed,
+                master::delivered.volume, master::delivered.inhaleTime,
+                master::delivered.cycleTime);
+    return pressure.on && pressure.over ? 1 : 0;
+}
@@ -0,0 +1,191 @@
+// ! Volume Curve Fitter ! =====================================================
+
+// writes a volume to steps curve, the inhale stroke for every tidal volume
+// setting from MIN_TV to MAX_TV in INC_TV. with no pairs it's the nominal arm
+// geometry, MIN_DEG to MAX_DEG straight, which the slave keeps in flash. with
+// a file of measured "steps mL" pairs, one a line and # for comments, the
+// volumes are made to rise with steps by pooling neighbours that don't, and
+// each setting is read off the straight lines between the pooled points,
+// carried on past the ends. -upload writes the master's copy, which it
+// uploads to a slave on any other curve. -check prints how far the curve's
+// volumes are from the pairs
+//
+//   ./curvefit > ../slave/curve.h
+//   ./curvefit -upload bench.txt > ../master/curve.h
+//   ./curvefit -check bench.txt
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+const int    MIN_TV        = 200;                   // must match slave.ino
+const int    MAX_TV        = 800;                   // must match slave.ino
+const int    INC_TV        = 20;                    // must match slave.ino
+const double MIN_DEG       = 7.5;                   // nominal angle for MIN_TV
+const double MAX_DEG       = 25.0;                  // nominal angle for MAX_TV
+const double STEPS_PER_DEG = 400.0 * 80.0 / 360.0;  // STEPS * REDUCTION / 360
+const int    LIMIT         = 2667;                  // must match CALIBRATION_LIMIT
+const int    POINTS        = (MAX_TV - MIN_TV) / INC_TV + 1;
+
+struct point {
+    double steps, ml, weight;
+};
+
+bool load(const char *path, std::vector<point> *pairs) {
+    FILE *f = std::fopen(path, "r");
+    if (!f) {
+        std::fprintf(stderr, "curvefit: can't open %s\n", path);
+        return false;
+    }
+    char line[128];
+    while (std::fgets(line, sizeof(line), f)) {
+        point p = {0, 0, 1};
+        if (line[0] != '#' && std::sscanf(line, "%lf %lf", &p.steps, &p.ml) == 2)
+            pairs->push_back(p);
+    }
+    std::fclose(f);
+    if (pairs->size() < 2) {
+        std::fprintf(stderr, "curvefit: %s needs two pairs or more\n", path);
+        return false;
+    }
+    return true;
+}
+
+// pool adjacent violators: neighbours whose volume doesn't rise with steps
+// are merged into their weighted mean until every volume is above the last
+std::vector<point> pool(std::vector<point> pairs) {
+    std::sort(pairs.begin(), pairs.end(),
+              [](const point &a, const point &b) { return a.steps < b.steps; });
+    std::vector<point> pooled;
+    for (point p : pairs) {
+        pooled.push_back(p);
+        while (pooled.size() > 1 && pooled[pooled.size() - 2].ml >= pooled.back().ml) {
+            point b = pooled.back();
+            pooled.pop_back();
+            point &a = pooled.back();
+            double w = a.weight + b.weight;
+            a.steps  = (a.steps * a.weight + b.steps * b.weight) / w;
+            a.ml     = (a.ml * a.weight + b.ml * b.weight) / w;
+            a.weight = w;
+        }
+    }
+    return pooled;
+}
+
+// steps for ml on the pooled points, the end lines carried on past them
+double stepsFor(const std::vector<point> &pooled, double ml) {
+    size_t i = 1;
+    while (i + 1 < pooled.size() && pooled[i].ml < ml)
+        i++;
+    const point &a = pooled[i - 1], &b = pooled[i];
+    return a.steps + (b.steps - a.steps) * (ml - a.ml) / (b.ml - a.ml);
+}
+
+// each point at least a step past the last, so the slave takes it
+std::vector<int> fit(const std::vector<point> &pairs) {
+    std::vector<point> pooled = pool(pairs);
+    std::vector<int>   curve;
+    for (int k = 0; k < POINTS; k++) {
+        int    ml    = MIN_TV + k * INC_TV;
+        double steps = pairs.empty() ? (MIN_DEG + (MAX_DEG - MIN_DEG) * (ml - MIN_TV) /
+                                                      (MAX_TV - MIN_TV)) * STEPS_PER_DEG
+                                     : stepsFor(pooled, ml);
+        int s = int(std::lround(steps));
+        s     = std::max(s, k ? curve.back() + 1 : 1);
+        curve.push_back(s);
+    }
+    return curve;
+}
+
+// Fletcher-16 over the points little endian, as the boards work it out
+unsigned check(const std::vector<int> &curve) {
+    unsigned a = 0, b = 0;
+    for (int s : curve) {
+        for (int byte : {s & 0xFF, s >> 8}) {
+            a = (a + byte) % 255;
+            b = (b + a) % 255;
+        }
+    }
+    return b << 8 | a;
+}
+
+// the volume a stroke of steps gives on the curve, the way the slave reads it
+// the other way round
+double mlFor(const std::vector<int> &curve, double steps) {
+    int k = 1;
+    while (k + 1 < POINTS && curve[k] < steps)
+        k++;
+    return MIN_TV + INC_TV * (k - 1 + (steps - curve[k - 1]) / (curve[k] - curve[k - 1]));
+}
+
+void generate(const std::vector<int> &curve, const char *from, bool uploaded) {
+    std::printf("// ! Volume Curve ! ============================================================\n\n");
+    std::printf("// generated by host/curvefit, do not edit\n");
+    std::printf("// inhale steps for each tidal volume from CURVE_MIN_TV in CURVE_INC_TV\n");
+    std::printf("// %s\n", from);
+    if (uploaded)
+        std::printf("// the master uploads it to a slave that reports any other\n");
+    std::printf("\n");
+    std::printf("#pragma once\n\n");
+    std::printf("#define CURVE_MIN_TV %d\n", MIN_TV);
+    std::printf("#define CURVE_INC_TV %d\n", INC_TV);
+    std::printf("#define CURVE_POINTS %d\n\n", POINTS);
+    std::printf("const uint16_t curveSteps[CURVE_POINTS] PROGMEM = {");
+    for (int k = 0; k < POINTS; k++)
+        std::printf("%s%d", k % 12 ? ", " : (k ? ",\n    " : "\n    "), curve[k]);
+    std::printf("};\n");
+}
+
+int checkFit(const std::vector<int> &curve, const std::vector<point> &pairs) {
+    std::printf("%d points, %d to %d steps, check 0x%04X\n", POINTS, curve.front(),
+                curve.back(), check(curve));
+    if (curve.back() > LIMIT) {
+        std::printf("curve runs past the slave's limit of %d steps\n", LIMIT);
+        return 1;
+    }
+    if (pairs.empty()) {
+        double worst = 0;
+        for (int k = 0; k < POINTS; k++) {
+            double deg = MIN_DEG + (MAX_DEG - MIN_DEG) * k / (POINTS - 1);
+            worst      = std::fmax(worst, std::fabs(curve[k] - deg * STEPS_PER_DEG));
+        }
+        std::printf("nominal geometry, worst rounding %.2f steps\n", worst);
+        return 0;
+    }
+    double worst = 0, square = 0;
+    for (const point &p : pairs) {
+        double off = mlFor(curve, p.steps) - p.ml;
+        worst      = std::fmax(worst, std::fabs(off));
+        square += off * off;
+    }
+    std::printf("%zu pairs, %zu after pooling, curve off them by %.1f mL rms, %.1f mL worst\n",
+                pairs.size(), pool(pairs).size(), std::sqrt(square / pairs.size()), worst);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    bool               checking = argc > 1 && !std::strcmp(argv[1], "-check");
+    bool               uploaded = argc > 1 && !std::strcmp(argv[1], "-upload");
+    int                flags    = checking || uploaded;
+    const char        *path     = argc > 1 + flags ? argv[1 + flags] : nullptr;
+    std::vector<point> pairs;
+    if (path && !load(path, &pairs))
+        return 1;
+
+    std::vector<int> curve = fit(pairs);
+    if (checking)
+        return checkFit(curve, pairs);
+    if (curve.back() > LIMIT) {
+        std::fprintf(stderr, "curvefit: curve runs past %d steps\n", LIMIT);
+        return 1;
+    }
+    char from[128];
+    if (path)
+        std::snprintf(from, sizeof(from), "fitted to %zu measured pairs", pairs.size());
+    else
+        std::snprintf(from, sizeof(from), "made from the nominal arm geometry");
+    generate(curve, from, uploaded);
+    return 0;
+}
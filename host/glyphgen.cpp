@@ -0,0 +1,217 @@
+// ! Digit Glyph Generator ! ===================================================
+
+// writes master/glyphs.h, the characters a dial value can hold in the two
+// 18pt fonts, each glyph's bitmap merged into filled rectangles: runs of ink
+// along a row, and the same run on the rows below folded into one rectangle.
+// -check redraws every glyph from its rectangles against the bitmap, lists
+// any ink outside its advance and counts the bus writes of both ways
+//
+//   ./glyphgen > ../master/glyphs.h
+//   ./glyphgen -check
+//
+// it's built against the host stand-in fonts unless FONTS points at the
+// Fonts directory of Adafruit GFX, which is what the board should get
+//
+//   make glyphs FONTS=~/Arduino/libraries/Adafruit_GFX_Library/Fonts
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef REAL_FONTS
+#include <Adafruit_GFX.h>  // for GFXfont
+#undef PROGMEM
+#define PROGMEM
+#include <FreeSans18pt7b.h>
+#include <FreeSansBold18pt7b.h>
+#else
+#include <Fonts/FreeSans18pt7b.h>
+#include <Fonts/FreeSansBold18pt7b.h>
+#endif
+
+const char  CHARS[] = "0123456789.<>- ";  // must match glyphsCheck() and dial.cpp
+const int   COUNT   = sizeof(CHARS) - 1;
+const int   TFT_WINDOW_NS = 6000, TFT_PIXEL_NS = 375;  // as host/hal.h
+
+struct Rect {
+    int x, y, w, h;
+};
+
+struct Glyph {
+    int               advance;
+    std::vector<Rect> rects;
+};
+
+struct Font {
+    const char    *name;    // of the arrays
+    const char    *define;  // of the check
+    const GFXfont *font;
+};
+
+const Font fonts[] = {
+    {"sans18", "SANS18_CHECK", &FreeSans18pt7b},
+    {"sansBold18", "SANSBOLD18_CHECK", &FreeSansBold18pt7b},
+};
+
+const GFXglyph *glyphOf(const GFXfont *f, char c) {
+    return f->glyph + (uint8_t(c) - f->first);
+}
+
+// UTFTGLUE::print hangs text from the top of a '0'
+int ascent(const GFXfont *f) {
+    return -glyphOf(f, '0')->yOffset;
+}
+
+bool ink(const GFXfont *f, const GFXglyph *g, int x, int y) {
+    int bit = y * g->width + x;
+    return f->bitmap[g->bitmapOffset + bit / 8] & (0x80 >> (bit % 8));
+}
+
+// each row's runs either carry on a rectangle open from the row above, with
+// the same x and width, or start a new one
+Glyph rasterise(const GFXfont *f, char c) {
+    const GFXglyph   *g   = glyphOf(f, c);
+    Glyph             out = {g->xAdvance, {}};
+    std::vector<int>  open;  // rects touching the row above
+    for (int y = 0; y < g->height; y++) {
+        std::vector<int> next;
+        for (int x = 0; x < g->width;) {
+            if (!ink(f, g, x, y)) {
+                x++;
+                continue;
+            }
+            int w = 0;
+            while (x + w < g->width && ink(f, g, x + w, y))
+                w++;
+            Rect r  = {g->xOffset + x, g->yOffset + ascent(f) + y, w, 1};
+            int  at = -1;
+            for (int i : open)
+                if (out.rects[i].x == r.x && out.rects[i].w == w)
+                    at = i;
+            if (at >= 0) {
+                out.rects[at].h++;
+            } else {
+                at = out.rects.size();
+                out.rects.push_back(r);
+            }
+            next.push_back(at);
+            x += w;
+        }
+        open = next;
+    }
+    return out;
+}
+
+// the same sum glyphsCheck() makes from the font in flash, so a table made
+// from other glyphs than the board has is never used
+uint16_t check(const GFXfont *f) {
+    uint16_t sum = 0;
+    for (int n = 0; n < COUNT; n++) {
+        const GFXglyph *g = glyphOf(f, CHARS[n]);
+        uint8_t metrics[] = {g->width, g->height, g->xAdvance,
+                             uint8_t(g->xOffset), uint8_t(g->yOffset)};
+        for (uint8_t b : metrics)
+            sum = sum * 31 + b;
+        for (int i = 0; i < (g->width * g->height + 7) / 8; i++)
+            sum = sum * 31 + f->bitmap[g->bitmapOffset + i];
+    }
+    return sum;
+}
+
+void generate() {
+    std::printf("// ! Digit Glyphs ! ============================================================\n\n");
+    std::printf("// generated by host/glyphgen, do not edit\n");
+    std::printf("// the characters of a dial value as filled rectangles, x from the cursor and\n");
+    std::printf("// y from the top of the text, in the order of GLYPH_CHARS. see printGlyphs()\n\n");
+    std::printf("#pragma once\n\n");
+    std::printf("#define GLYPH_CHARS \"%s\"\n", CHARS);
+    std::printf("#define GLYPH_COUNT %d\n", COUNT);
+    for (const Font &font : fonts)
+        std::printf("#define %s 0x%04X\n", font.define, check(font.font));
+
+    for (const Font &font : fonts) {
+        std::vector<Glyph> glyphs;
+        int                total = 0;
+        for (int n = 0; n < COUNT; n++) {
+            glyphs.push_back(rasterise(font.font, CHARS[n]));
+            total += glyphs.back().rects.size();
+        }
+
+        std::printf("\nconst glyphRect %sRects[%d] PROGMEM = {\n", font.name, total);
+        for (int n = 0; n < COUNT; n++) {
+            std::printf("    // '%c'\n", CHARS[n]);
+            for (const Rect &r : glyphs[n].rects)
+                std::printf("    {%d, %d, %d, %d},\n", r.x, r.y, r.w, r.h);
+        }
+        std::printf("};\n\n");
+
+        std::printf("const glyph %sGlyphs[GLYPH_COUNT] PROGMEM = {\n", font.name);
+        int first = 0;
+        for (int n = 0; n < COUNT; n++) {
+            std::printf("    {%d, %d, %d},  // '%c'\n", first, int(glyphs[n].rects.size()),
+                        glyphs[n].advance, CHARS[n]);
+            first += glyphs[n].rects.size();
+        }
+        std::printf("};\n");
+    }
+}
+
+int check() {
+    int bad = 0;
+    for (const Font &font : fonts) {
+        const GFXfont *f = font.font;
+        long           bitmapNs = 0, rectNs = 0;
+        int            pixels = 0, rects = 0;
+        for (int n = 0; n < COUNT; n++) {
+            const GFXglyph *g     = glyphOf(f, CHARS[n]);
+            Glyph           glyph = rasterise(f, CHARS[n]);
+
+            // every pixel covered once, and only the inked ones
+            std::vector<int> cover(g->width * g->height);
+            for (const Rect &r : glyph.rects) {
+                for (int y = r.y; y < r.y + r.h; y++)
+                    for (int x = r.x; x < r.x + r.w; x++)
+                        cover[(y - g->yOffset - ascent(f)) * g->width + x - g->xOffset]++;
+                rectNs += TFT_WINDOW_NS + r.w * r.h * TFT_PIXEL_NS;
+            }
+            for (int y = 0; y < g->height; y++)
+                for (int x = 0; x < g->width; x++)
+                    if (cover[y * g->width + x] != (ink(f, g, x, y) ? 1 : 0)) {
+                        std::printf("%s '%c': pixel %d,%d covered %d times\n",
+                                    font.name, CHARS[n], x, y, cover[y * g->width + x]);
+                        bad++;
+                    }
+
+            // a glyph is cleared and drawn on its own, so ink past its
+            // advance would chip the next one
+            for (const Rect &r : glyph.rects)
+                if (r.x < 0 || r.x + r.w > glyph.advance) {
+                    std::printf("%s '%c': ink outside its advance of %d\n",
+                                font.name, CHARS[n], glyph.advance);
+                    bad++;
+                    break;
+                }
+
+            int on = 0;
+            for (int y = 0; y < g->height; y++)
+                for (int x = 0; x < g->width; x++)
+                    on += ink(f, g, x, y);
+            bitmapNs += on * (TFT_WINDOW_NS + TFT_PIXEL_NS);  // drawPixel each
+            pixels += on;
+            rects += glyph.rects.size();
+        }
+        std::printf("%-10s  %4d pixels in %3d rects, %5.1f ms per set by pixel, "
+                    "%4.1f ms by rect, check 0x%04X\n",
+                    font.name, pixels, rects, bitmapNs / 1e6, rectNs / 1e6, check(f));
+    }
+    std::printf("%d problems\n", bad);
+    return bad != 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && !std::strcmp(argv[1], "-check"))
+        return check();
+    generate();
+    return 0;
+}
@@ -0,0 +1,407 @@
+// ! Implementation of hal ! ===================================================
+
+#include "hal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace hal {
+
+static thread_local Board *running = nullptr;
+
+// * STATISTICS ================================================================
+
+void Stats::add(double v) {
+    if (count == 0 || v < min) min = v;
+    if (count == 0 || v > max) max = v;
+    count++;
+    sum += v;
+    int bin = v < 1 ? 0 : int(std::log2(v)) + 1;
+    bins[bin < 63 ? bin : 63]++;
+}
+
+double Stats::percentile(double p) const {
+    uint64_t want = uint64_t(std::ceil(count * p / 100.0));
+    uint64_t seen = 0;
+    for (int n = 0; n < 64; n++) {
+        seen += bins[n];
+        if (seen >= want && seen > 0)
+            return n == 0 ? 1 : std::ldexp(1.0, n);
+    }
+    return max;
+}
+
+void Stats::print(const char *name, const char *unit) const {
+    std::printf("  %-24s n=%-8llu min=%-9.1f mean=%-9.1f p99<=%-9.0f max=%.1f %s\n",
+                name, (unsigned long long)count, min, mean(), percentile(99),
+                max, unit);
+}
+
+// * BUS =======================================================================
+
+Bus &bus() {
+    static Bus b;
+    return b;
+}
+
+void Bus::attach(uint8_t address, Device *device) {
+    devices[address] = device;
+}
+
+uint8_t Bus::transmit(uint8_t address, const uint8_t *data, size_t n) {
+    transactions++;
+    bytes += n + 1;
+    auto d = devices.find(address);
+    if (d == devices.end() || !d->second->receive(data, n)) {
+        nacks++;
+        return 2;
+    }
+    return 0;
+}
+
+Device *Bus::find(uint8_t address) {
+    auto d = devices.find(address);
+    return d == devices.end() ? nullptr : d->second;
+}
+
+size_t Bus::receive(uint8_t address, uint8_t *data, size_t n) {
+    transactions++;
+    bytes += 1;
+    auto d = devices.find(address);
+    if (d == devices.end()) {
+        nacks++;
+        return 0;
+    }
+    size_t got = d->second->request(data, n);
+    bytes += got;
+    return got;
+}
+
+// * BOARD =====================================================================
+
+Board::Board(const char *name)
+    : name(name) {
+    std::memset(eeprom, 0xFF, sizeof(eeprom));
+}
+
+int Board::pin(uint8_t p) const {
+    if (p >= NUM_PINS)
+        return 0;
+    if (input[p])
+        return input[p]() ? 1 : 0;
+    if (mode[p] == 1)  // OUTPUT
+        return level[p];
+    return mode[p] == 2 ? 1 : 0;  // INPUT_PULLUP floats high
+}
+
+// a record's bytes go to the decoder before anything is taken for text, a
+// stamp of 13 ms is a '\r'
+void Board::serialOut(uint8_t c) {
+    if ((serial && serial(c)) || c == '\r')
+        return;
+    if (c != '\n') {
+        line += char(c);
+        return;
+    }
+    print(ns, line);
+    line.clear();
+}
+
+void Board::print(uint64_t at, const std::string &text) {
+    if (echo)
+        std::printf("[%10.3f %-6s] %s\n", at / 1e9, name, text.c_str());
+}
+
+// * TIMERS ====================================================================
+
+uint64_t Timer16::tickNs() const {
+    static const uint16_t prescale[8] = {0, 1, 8, 64, 256, 1024, 0, 0};
+    return prescale[control & 7] * 1000000000ull / CPU_HZ;
+}
+
+void Timer16::catchUp(uint64_t now) {
+    uint64_t period = (uint64_t(compare) + 1) * tickNs();
+    if (period && now >= last + period)
+        last += (now - last) / period * period;
+}
+
+uint16_t Timer16::count(uint64_t now) {
+    if (!tickNs())
+        return held;
+    catchUp(now);
+    return (now - last) / tickNs();
+}
+
+uint64_t Twi::clockNs() const {
+    return (16 + 2 * uint64_t(rate) * (1 << (2 * prescale))) * 1000000000ull / CPU_HZ;
+}
+
+void Twi::write(uint64_t now, uint8_t v) {
+    const uint8_t TWEN = 0x04, TWSTO = 0x10, TWSTA = 0x20, TWINT = 0x80;
+    control = v & ~TWINT;
+    if (!(v & TWEN)) {
+        // switching off drops whatever was going on
+        flag    = false;
+        doneNs  = 0;
+        action  = NONE;
+        owned   = false;
+        status  = 0xF8;
+        control = v & ~(TWINT | TWSTO | TWSTA);
+        return;
+    }
+    if (!(v & TWINT))
+        return;
+    flag = false;
+    if (v & TWSTO) {
+        if (owned && !reading)
+            deliver();
+        owned  = false;
+        action = v & TWSTA ? START : STOP;
+        doneNs = now + (v & TWSTA ? 2 : 1) * clockNs();
+    } else if (v & TWSTA) {
+        if (owned && !reading)
+            deliver();
+        action = START;
+        doneNs = now + clockNs();
+    } else if (status == 0x08 || status == 0x10) {
+        action = ADDRESS;
+        doneNs = now + 9 * clockNs();
+    } else if (status == 0x18 || status == 0x28) {
+        action = SEND;
+        doneNs = now + 9 * clockNs();
+    } else if (status == 0x40 || status == 0x50) {
+        action = RECEIVE;
+        doneNs = now + 9 * clockNs();
+    }
+    // a START waits for the bus to be free
+    if (action == START && stuck > 0 && !owned)
+        doneNs = 0;
+}
+
+void Twi::complete() {
+    const uint8_t TWEA = 0x40, TWSTO = 0x10;
+    Bus &b = bus();
+    doneNs = 0;
+    switch (action) {
+    case START:
+        status = owned ? 0x10 : 0x08;
+        owned  = true;
+        length = index = 0;
+        break;
+    case STOP:
+        control &= ~TWSTO;
+        status = 0xF8;
+        action = NONE;
+        return;
+    case ADDRESS:
+        address = data >> 1;
+        reading = data & 1;
+        device  = b.find(address);
+        b.transactions++;
+        b.bytes++;
+        if (!device)
+            b.nacks++;
+        if (device && reading)
+            device->request(buffer, sizeof(buffer));
+        status = reading ? (device ? 0x40 : 0x48) : (device ? 0x18 : 0x20);
+        break;
+    case SEND:
+        if (length < sizeof(buffer))
+            buffer[length++] = data;
+        b.bytes++;
+        status = 0x28;
+        break;
+    case RECEIVE:
+        data = index < sizeof(buffer) ? buffer[index++] : 0xFF;
+        b.bytes++;
+        status = control & TWEA ? 0x50 : 0x58;
+        break;
+    default:
+        return;
+    }
+    control &= ~TWSTO;
+    action = NONE;
+    flag   = true;
+}
+
+// the written bytes go to the device that acked its address
+void Twi::deliver() {
+    if (device && !device->receive(buffer, length))
+        bus().nacks++;
+    device = nullptr;
+    length = 0;
+}
+
+void Twi::clock() {
+    if (stuck > 0)
+        stuck--;
+}
+
+Board *current() {
+    return running;
+}
+
+// bus actions finish on time whatever the code is doing. interrupts fire at
+// the first charge boundary after they're raised, the timer's ahead of the
+// TWI's like the AVR's vector order, and their cost pushes back the code they
+// interrupted
+void charge(uint64_t ns) {
+    Board *b = running;
+    if (!b)
+        return;
+    Timer16 &t = b->timer1;
+    Twi     &w = b->twi;
+    for (;;) {
+        const uint64_t NEVER = UINT64_MAX;
+        bool     irq  = b->isr == 0;
+        uint64_t done = w.doneNs ? std::max(w.doneNs, b->ns) : NEVER;
+        uint64_t tmr  = irq && t.armed() ? std::max(t.next(), b->ns) : NEVER;
+        uint64_t twi  = irq && w.interrupt() ? b->ns : NEVER;
+        uint64_t at   = std::min(done, std::min(tmr, twi));
+        if (at > b->ns + ns)
+            break;
+        ns -= at - b->ns;
+        b->ns = at;
+        if (at == done) {
+            w.complete();
+            continue;
+        }
+        b->isr++;
+        b->ns += ISR_NS;
+        if (at == tmr) {
+            t.catchUp(b->ns);
+            t.vector();
+        } else {
+            w.vector();
+        }
+        b->isr--;
+    }
+    b->ns += ns;
+    if (b->probe)
+        b->probe();
+    if (b->isr == 0 && b->scheduler)
+        b->scheduler->sync(*b);
+}
+
+void interrupt(Board &b, const std::function<void()> &fn) {
+    Board *previous = running;
+    running         = &b;
+    b.isr++;
+    fn();
+    b.isr--;
+    running = previous;
+}
+
+// * SCHEDULER =================================================================
+
+void Scheduler::add(Board &b, void (*setup)(), void (*loop)()) {
+    b.scheduler = this;
+    entries.push_back({&b, setup, loop});
+}
+
+Board *Scheduler::earliest() {
+    Board *best = nullptr;
+    for (auto &e : entries)
+        if (!e.board->finished && (!best || e.board->ns < best->ns))
+            best = e.board;
+    return best;
+}
+
+void Scheduler::handoff(Board &from, Board *to) {
+    std::unique_lock<std::mutex> lock(m);
+    holder = to;
+    cv.notify_all();
+    if (!from.finished)
+        cv.wait(lock, [&] { return holder == &from; });
+}
+
+void Scheduler::sync(Board &b) {
+    if (b.ns >= until) {
+        b.finished = true;
+        handoff(b, earliest());
+        throw Stop();
+    }
+    Board *next = earliest();
+    if (next && next != &b && b.ns > next->ns + QUANTUM_NS)
+        handoff(b, next);
+}
+
+void Scheduler::body(Entry e) {
+    running = e.board;
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return holder == e.board; });
+    }
+    try {
+        e.setup();
+        for (;;) {
+            uint64_t start = e.board->ns;
+            e.loop();
+            if (e.board->loopDone)
+                e.board->loopDone(e.board->ns - start);
+        }
+    } catch (Stop &) {
+    }
+}
+
+void Scheduler::run(uint64_t untilNs) {
+    until = untilNs;
+    std::vector<std::thread> threads;
+    for (auto &e : entries)
+        threads.emplace_back(&Scheduler::body, this, e);
+    {
+        std::unique_lock<std::mutex> lock(m);
+        holder = earliest();
+        cv.notify_all();
+    }
+    for (auto &t : threads)
+        t.join();
+}
+
+// * INPUT DEVICES =============================================================
+
+Knob::Knob(Board &b, uint8_t clk, uint8_t dt, uint8_t button)
+    : board(b) {
+    // rest state is both phases high through the pull-ups
+    //   phase: 0    1    2    3
+    //   clk:   1    1    0    0
+    //   dt:    1    0    0    1
+    board.input[clk]    = [this] { int p = phase(board.ns) & 3; return p == 0 || p == 1; };
+    board.input[dt]     = [this] { int p = phase(board.ns) & 3; return p == 0 || p == 3; };
+    board.input[button] = [this] { return !pressed(board.ns); };
+}
+
+void Knob::turn(uint64_t atMs, int detents, uint64_t overMs) {
+    turns.push_back({atMs * 1000000, (atMs + overMs) * 1000000, detents * 2});
+}
+
+void Knob::press(uint64_t atMs, uint64_t forMs) {
+    presses.push_back({atMs * 1000000, (atMs + forMs) * 1000000});
+}
+
+int Knob::phase(uint64_t ns) const {
+    return turned(ns) & 0x7fffffff;
+}
+
+int Knob::turned(uint64_t ns) const {
+    int p = 0;
+    for (auto &t : turns) {
+        if (ns >= t.end) {
+            p += t.steps;
+        } else if (ns > t.start) {
+            p += int(int64_t(t.steps) * int64_t(ns - t.start) / int64_t(t.end - t.start));
+        }
+    }
+    return p;
+}
+
+bool Knob::pressed(uint64_t ns) const {
+    for (auto &p : presses)
+        if (ns >= p.start && ns < p.end)
+            return true;
+    return false;
+}
+
+}  // namespace hal
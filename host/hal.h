@@ -0,0 +1,257 @@
+// ! Host Hardware Abstraction ! ===============================================
+
+// Lets master.ino and slave.ino run as one Linux process. Every board has its
+// own virtual clock that only moves when the sketch touches the hardware, using
+// the costs below, so loop timing is deterministic and repeatable. Each board
+// runs on its own thread, but only one runs at a time: whoever gets more than
+// QUANTUM_NS ahead of the other hands the baton over.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hal {
+
+// * COST MODEL (virtual nanoseconds) ==========================================
+
+const uint64_t QUANTUM_NS       = 250000;  // max skew between board clocks
+const uint64_t CLOCK_READ_NS    = 1000;    // millis()/micros()
+const uint64_t PIN_NS           = 5000;    // digitalRead/Write via the core
+const uint64_t PORT_NS          = 500;     // direct port access, e.g. PINA
+const uint64_t I2C_BYTE_NS      = 90000;   // 9 bit times at 100 kHz
+const uint64_t I2C_FRAME_NS     = 20000;   // start, stop and bus turnaround
+const uint64_t SERIAL_CALL_NS   = 4000;    // Print overhead per call
+const int      SERIAL_TX_BUFFER = 64;      // HardwareSerial ring size
+const uint64_t TFT_WINDOW_NS    = 6000;    // setAddrWindow on 8 bit bus
+const uint64_t TFT_PIXEL_NS     = 375;     // two WR strobes per RGB565 pixel
+const uint64_t STEP_POLL_NS     = 8000;    // processMovement() with no step
+const uint64_t ISR_NS           = 3000;    // interrupt entry and exit
+const uint64_t EEPROM_READ_NS   = 500;     // a byte
+const uint64_t EEPROM_WRITE_NS  = 3400000; // erase and write of a byte
+const uint64_t CPU_HZ           = 16000000;
+
+const int NUM_PINS    = 70;
+const int EEPROM_SIZE = 4096;
+
+// * STATISTICS ================================================================
+
+// running min/mean/max plus a log2 histogram for rough percentiles
+struct Stats {
+    uint64_t count = 0;
+    double   sum   = 0;
+    double   min   = 0;
+    double   max   = 0;
+    uint64_t bins[64] = {};
+
+    void   add(double v);
+    double mean() const { return count ? sum / count : 0; }
+    double percentile(double p) const;  // upper bound of the bin holding p
+    void   print(const char *name, const char *unit) const;
+};
+
+// * BUS =======================================================================
+
+// anything that answers on the simulated I2C bus
+struct Device {
+    virtual ~Device() {}
+    // master wrote n bytes, return false to NACK
+    virtual bool receive(const uint8_t *data, size_t n) = 0;
+    // master asks for n bytes, return how many were supplied
+    virtual size_t request(uint8_t *data, size_t n) = 0;
+};
+
+struct Bus {
+    std::map<uint8_t, Device *> devices;
+    uint64_t                    transactions = 0;
+    uint64_t                    bytes        = 0;
+    uint64_t                    nacks        = 0;
+
+    void   attach(uint8_t address, Device *device);
+    // returns Wire.endTransmission() status codes, 0 = ok, 2 = address NACK
+    uint8_t transmit(uint8_t address, const uint8_t *data, size_t n);
+    size_t  receive(uint8_t address, uint8_t *data, size_t n);
+    Device *find(uint8_t address);  // nullptr if nobody answers
+};
+
+Bus &bus();
+
+// * TIMERS ====================================================================
+
+// a 16 bit timer in CTC mode, the only way the sketches use one. TCNT1 counts
+// up from the last compare match, which happens every OCR1A + 1 ticks and
+// fires the vector if it's unmasked. a match while the board can't take the
+// interrupt is serviced once, late, like the AVR's OCF1A flag
+struct Timer16 {
+    uint8_t  control = 0;       // TCCR1B, clock select in the low 3 bits
+    uint8_t  mask    = 0;       // TIMSK1
+    uint16_t compare = 0xFFFF;  // OCR1A
+    uint16_t held    = 0;       // TCNT1 while the clock is stopped
+    uint64_t last    = 0;       // ns of the last match, TCNT1 = 0
+    void (*vector)() = nullptr;
+
+    uint64_t tickNs() const;  // 0 while stopped
+    bool     armed() const { return tickNs() && (mask & 0x02) && vector; }
+    uint64_t next() const { return last + (uint64_t(compare) + 1) * tickNs(); }
+    void     catchUp(uint64_t now);  // move last to the latest match
+    uint16_t count(uint64_t now);
+};
+
+// * TWI =======================================================================
+
+// the AVR two wire interface as a bus master, a byte at a time. an action
+// started by writing TWINT to TWCR finishes some SCL clocks later, when TWINT
+// sets and the vector fires if TWIE is set. bytes written reach the device as
+// one transaction at the STOP or repeated START, and a read takes the device's
+// whole reply as it is addressed, the way Wire behaves on the far end. stuck
+// is how many SCL clocks a device holding SDA low needs before it lets go, and
+// no START completes until it has them
+struct Twi {
+    uint8_t  control  = 0;     // TWCR less TWINT
+    bool     flag     = false; // TWINT
+    uint8_t  status   = 0xF8;  // TWSR upper 5 bits
+    uint8_t  prescale = 0;     // TWSR low 2 bits
+    uint8_t  rate     = 0;     // TWBR
+    uint8_t  data     = 0xFF;  // TWDR
+    uint64_t doneNs   = 0;     // when the action on the bus finishes, 0 for none
+    int      stuck    = 0;
+    void (*vector)()  = nullptr;
+
+    uint64_t clockNs() const;  // one SCL period
+    bool     interrupt() const { return flag && (control & 0x01) && vector; }
+    void     write(uint64_t now, uint8_t v);  // to TWCR
+    void     complete();                      // at doneNs
+    void     clock();                         // SCL pulsed by hand
+
+  private:
+    enum Action { NONE, START, STOP, ADDRESS, SEND, RECEIVE };
+
+    void deliver();
+
+    Action  action  = NONE;
+    bool    owned   = false;  // between our START and STOP
+    bool    reading = false;
+    uint8_t address = 0;
+    Device *device  = nullptr;
+    uint8_t buffer[32];
+    size_t  length = 0, index = 0;
+};
+
+// * BOARD =====================================================================
+
+class Scheduler;
+
+struct Board {
+    explicit Board(const char *name);
+
+    const char *name;
+    uint64_t    ns       = 0;      // local virtual time
+    int         isr      = 0;      // interrupt nesting, no handoff while > 0
+    bool        finished = false;  // reached the end of the run
+    Scheduler  *scheduler = nullptr;
+    void       *wire      = nullptr;  // TwoWire owned by this board
+
+    uint8_t              mode[NUM_PINS]   = {};
+    uint8_t              level[NUM_PINS]  = {};
+    uint16_t             toneHz[NUM_PINS] = {};  // from tone(), 0 for none
+    std::function<int()> input[NUM_PINS];  // external drivers, e.g. a knob
+    Timer16              timer1;
+    Twi                  twi;
+    uint8_t              eeprom[EEPROM_SIZE];
+    uint64_t             eepromBusy = 0;  // ns the last write finishes at
+
+    uint64_t strings = 0;  // Arduino String objects made, see Arduino.h
+
+    bool        echo = false;  // mirror Serial output to stdout
+    std::string line;          // partial Serial line
+
+    // hooks for the harness, called on this board's thread
+    std::function<void()>         probe;     // after every clock advance
+    std::function<void(uint64_t)> loopDone;  // with the loop() cost in ns
+    std::function<void(uint8_t)>  output;    // after a pin changes level
+    std::function<bool(uint8_t)>  serial;    // sees Serial bytes first, true to take one
+
+    int  pin(uint8_t p) const;  // electrical level, no cost
+    void serialOut(uint8_t c);
+    void print(uint64_t at, const std::string &text);  // a line of echo
+};
+
+// board whose code is running on this thread, or nullptr before it starts
+Board *current();
+
+// charge virtual time to the running board and maybe hand over the baton
+void charge(uint64_t ns);
+
+// run fn as an interrupt on another board, e.g. the slave's Wire callbacks
+void interrupt(Board &b, const std::function<void()> &fn);
+
+// thrown out of a board's code once it reaches the end of the run
+struct Stop {};
+
+// * SCHEDULER =================================================================
+
+class Scheduler {
+  public:
+    void add(Board &b, void (*setup)(), void (*loop)());
+    void run(uint64_t untilNs);
+    void sync(Board &b);
+    void stop() { until = 0; }  // end the run at the next sync
+
+  private:
+    struct Entry {
+        Board *board;
+        void (*setup)();
+        void (*loop)();
+    };
+
+    Board *earliest();
+    void   handoff(Board &from, Board *to);
+    void   body(Entry e);
+
+    std::vector<Entry>      entries;
+    std::mutex              m;
+    std::condition_variable cv;
+    Board                  *holder = nullptr;
+    uint64_t                until  = 0;
+};
+
+// * INPUT DEVICES =============================================================
+
+// a rotary encoder and push button on the end of a user's hand. one detent is
+// two quadrature steps, matching the /2 in countEncoders()
+class Knob {
+  public:
+    Knob(Board &b, uint8_t clk, uint8_t dt, uint8_t button);
+
+    // detents > 0 turns clockwise, spaced evenly over the duration
+    void turn(uint64_t atMs, int detents, uint64_t overMs);
+    void press(uint64_t atMs, uint64_t forMs);
+
+    // quadrature steps turned by ns, clockwise up
+    int turned(uint64_t ns) const;
+
+  private:
+    struct Turn {
+        uint64_t start, end;
+        int      steps;
+    };
+    struct Press {
+        uint64_t start, end;
+    };
+
+    int  phase(uint64_t ns) const;
+    bool pressed(uint64_t ns) const;
+
+    Board             &board;
+    std::vector<Turn>  turns;
+    std::vector<Press> presses;
+};
+
+}  // namespace hal
@@ -0,0 +1,61 @@
+// ! Host stand-in for Adafruit GFX ! ==========================================
+
+#pragma once
+
+#include <Arduino.h>
+
+typedef struct {
+    uint16_t bitmapOffset;  // into GFXfont->bitmap
+    uint8_t  width;
+    uint8_t  height;
+    uint8_t  xAdvance;
+    int8_t   xOffset;  // from cursor to upper-left corner
+    int8_t   yOffset;  // from baseline to upper-left corner
+} GFXglyph;
+
+typedef struct {
+    uint8_t  *bitmap;
+    GFXglyph *glyph;
+    uint16_t  first;
+    uint16_t  last;
+    uint8_t   yAdvance;
+} GFXfont;
+
+// every shape ends up as spans through drawFastHLine/drawFastVLine/fillRect or
+// single pixels through drawPixel, so a subclass only has to cost those
+class Adafruit_GFX : public Print {
+  public:
+    Adafruit_GFX(int16_t w, int16_t h)
+        : _width(w)
+        , _height(h) {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+    void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+    void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                      int16_t x2, int16_t y2, uint16_t color);
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color);
+
+    void setCursor(int16_t x, int16_t y) { cursor_x = x, cursor_y = y; }
+    void setTextColor(uint16_t c) { textcolor = c; }
+    void setFont(const GFXfont *f) { gfxFont = (GFXfont *)f; }
+
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+  protected:
+    int16_t  _width, _height;
+    int16_t  cursor_x = 0, cursor_y = 0;
+    uint16_t textcolor = 0xFFFF;
+    GFXfont *gfxFont   = nullptr;
+};
@@ -0,0 +1,71 @@
+// ! Host stand-in for Adafruit MPRLS ! ========================================
+
+// talks to whatever answers at its address on hal::bus(), normally the
+// MPRLSModel below, with the same I2C traffic and polling as the real library
+
+#pragma once
+
+#include <Wire.h>
+
+#define MPRLS_DEFAULT_ADDR 0x18
+#define MPRLS_READ_TIMEOUT 20
+#define MPRLS_STATUS_POWERED 0x40
+#define MPRLS_STATUS_BUSY 0x20
+#define MPRLS_STATUS_FAILED 0x04
+#define MPRLS_STATUS_MATHSAT 0x01
+#define PSI_to_HPA 68.947572932
+
+class Adafruit_MPRLS {
+  public:
+    Adafruit_MPRLS(int8_t reset_pin = -1, int8_t EOC_pin = -1,
+                   uint16_t PSI_min = 0, uint16_t PSI_max = 25,
+                   float OUTPUT_min = 10, float OUTPUT_max = 90,
+                   float K = PSI_to_HPA);
+
+    bool     begin(uint8_t i2c_addr = MPRLS_DEFAULT_ADDR, TwoWire *twi = nullptr);
+    uint8_t  readStatus(void);
+    float    readPressure(void);
+    uint8_t  lastStatus = 0;
+
+  private:
+    uint32_t readData(void);
+
+    TwoWire *i2c  = nullptr;
+    uint8_t  addr = MPRLS_DEFAULT_ADDR;
+    int8_t   reset, eoc;
+    uint16_t psiMin, psiMax;
+    uint32_t outputMin, outputMax;
+    float    k;
+};
+
+// * SENSOR MODEL ==============================================================
+
+// the Honeywell MPR sensor itself: 0xAA 0x00 0x00 starts a conversion that
+// stays busy for conversionNs, then status plus 24 bit counts can be read.
+// the counts are the mean pressure over the conversion, asked of hpa when
+// they're first read after it ends
+class MPRLSModel : public hal::Device {
+  public:
+    explicit MPRLSModel(uint8_t address = MPRLS_DEFAULT_ADDR);
+
+    std::function<double(uint64_t from, uint64_t to)> hpa;  // mean absolute pressure
+    uint64_t conversionNs = 5000000;
+    uint8_t  faults       = 0;  // extra status bits, e.g. MPRLS_STATUS_FAILED
+    uint64_t conversions  = 0;
+
+    bool eoc() const;  // end-of-conversion pin level
+
+    bool   receive(const uint8_t *data, size_t n) override;
+    size_t request(uint8_t *data, size_t n) override;
+
+  private:
+    uint64_t now() const;
+
+    void convert();
+
+    uint64_t startNs   = 0;
+    uint64_t busyUntil = 0;
+    uint32_t counts    = 0;
+    bool     saturated = false;
+    bool     pending   = false;  // converted but not yet worked out
+};
@@ -0,0 +1,188 @@
+// ! Host stand-in for the Arduino core ! ======================================
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "../hal.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define F_CPU 16000000UL
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define PI 3.1415926535897932384626433832795
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define DEC 10
+#define HEX 16
+
+using std::abs;
+
+// templates rather than the AVR core's macros so std headers still compile
+template <class T, class L>
+auto min(const T &a, const L &b) -> decltype((b < a) ? b : a) {
+    return (b < a) ? b : a;
+}
+
+template <class T, class L>
+auto max(const T &a, const L &b) -> decltype((b < a) ? b : a) {
+    return (a < b) ? b : a;
+}
+
+template <class T, class L, class H>
+T constrain(const T &x, const L &low, const H &high) {
+    return x < low ? low : x > high ? high : x;
+}
+
+// * TIME ======================================================================
+
+unsigned long millis();
+unsigned long micros();
+void          delay(unsigned long ms);
+void          delayMicroseconds(unsigned int us);
+
+// * PINS ======================================================================
+
+void pinMode(uint8_t pin, uint8_t mode);
+int  digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+
+// a square wave on the pin until noTone(), off a timer on the AVR. the host
+// keeps the frequency on the board for the harness to hear
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+// * INTERRUPTS ================================================================
+
+// masking holds off the other board's callbacks into this one, as cli() would
+void noInterrupts();
+void interrupts();
+
+// * STRING ====================================================================
+
+// text kept in flash, F("...") on the AVR. the host has one address space
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+class String {
+  public:
+    String() {}
+    String(const char *s)
+        : s(s ? s : "") {}
+    String(const std::string &s)
+        : s(s) {}
+    String(char c)
+        : s(1, c) {}
+    String(int v, unsigned char base = DEC);
+    String(unsigned int v, unsigned char base = DEC);
+    String(long v, unsigned char base = DEC);
+    String(unsigned long v, unsigned char base = DEC);
+    String(unsigned char v, unsigned char base = DEC);
+    String(float v, unsigned char decimalPlaces = 2);
+    String(double v, unsigned char decimalPlaces = 2);
+
+    const char  *c_str() const { return s.c_str(); }
+    unsigned int length() const { return s.length(); }
+    long         toInt() const { return std::atol(s.c_str()); }
+    float        toFloat() const { return std::atof(s.c_str()); }
+
+    String &operator+=(const String &rhs) {
+        s += rhs.s;
+        return *this;
+    }
+    bool operator==(const String &rhs) const { return s == rhs.s; }
+    bool operator!=(const String &rhs) const { return s != rhs.s; }
+    char operator[](unsigned int n) const { return n < s.size() ? s[n] : 0; }
+
+    friend String operator+(const String &a, const String &b) { return String(a.s + b.s); }
+    friend String operator+(const char *a, const String &b) { return String(a) + b; }
+    friend String operator+(const String &a, const char *b) { return a + String(b); }
+
+  private:
+    // each one made counts against its board, where the AVR core would have
+    // gone to the heap. the sketches shouldn't make any once set up
+    struct Counted {
+        Counted();
+        Counted(const Counted &);
+        Counted &operator=(const Counted &) { return *this; }
+    } counted;
+
+    std::string s;
+};
+
+// * PRINT =====================================================================
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t         write(const char *str) { return write((const uint8_t *)str, std::strlen(str)); }
+
+    size_t print(const char *s) { return write(s); }
+    size_t print(const String &s) { return write(s.c_str()); }
+    size_t print(char c) { return write(uint8_t(c)); }
+    size_t print(const __FlashStringHelper *s) { return write((const char *)s); }
+    size_t print(int v, int base = DEC) { return print(long(v), base); }
+    size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(long v, int base = DEC);
+    size_t print(unsigned long v, int base = DEC);
+    size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(double v, int digits = 2);
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T &v) {
+        size_t n = print(v);
+        return n + println();
+    }
+    template <typename T>
+    size_t println(const T &v, int format) {
+        size_t n = print(v, format);
+        return n + println();
+    }
+};
+
+// * SERIAL ====================================================================
+
+// transmit ring of SERIAL_TX_BUFFER bytes drained at the baud rate, writes
+// only block once the ring is full, like the AVR HardwareSerial
+class HardwareSerial : public Print {
+  public:
+    explicit HardwareSerial(hal::Board &board)
+        : board(board) {}
+
+    void begin(unsigned long baud);
+    void end() {}
+    void flush();
+    int  available() { return 0; }
+    int  read() { return -1; }
+    int  availableForWrite();
+    explicit operator bool() const { return true; }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+  private:
+    hal::Board &board;
+    uint64_t    byteNs = 86806;  // 10 bits at 115200
+    uint64_t    idleAt = 0;      // when the ring will have drained
+};
@@ -0,0 +1,9 @@
+// ! Host stand-in for the FreeSansBold12pt7b GFX font ! =======================
+
+// glyphs are synthesised in lib/Fonts.cpp with close to the real metrics
+
+#pragma once
+
+#include <Adafruit_GFX.h>
+
+extern const GFXfont FreeSansBold12pt7b;
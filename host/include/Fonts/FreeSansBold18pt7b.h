@@ -0,0 +1,9 @@
+// ! Host stand-in for the FreeSansBold18pt7b GFX font ! =======================
+
+// glyphs are synthesised in lib/Fonts.cpp with close to the real metrics
+
+#pragma once
+
+#include <Adafruit_GFX.h>
+
+extern const GFXfont FreeSansBold18pt7b;
@@ -0,0 +1,39 @@
+// ! Host stand-in for SpeedyStepper ! =========================================
+
+// steps on the same schedule as the library (constant acceleration ramps,
+// polled by processMovement) and drives the step and direction pins the way it
+// does, so a harness can follow the shaft from the pins
+
+#pragma once
+
+#include <Arduino.h>
+
+class SpeedyStepper {
+  public:
+    void connectToPins(uint8_t stepPin, uint8_t directionPin);
+
+    void  setSpeedInStepsPerSecond(float speed);
+    void  setAccelerationInStepsPerSecondPerSecond(float acceleration);
+    void  setCurrentPositionInSteps(long position);
+    long  getCurrentPositionInSteps() const { return position; }
+    float getCurrentVelocityInStepsPerSecond() const;
+
+    void setupMoveInSteps(long absolutePosition);
+    void setupRelativeMoveInSteps(long distance);
+    void setupStop();
+    bool processMovement(void);
+    bool motionComplete() const { return position == target; }
+
+    void moveToPositionInSteps(long absolutePosition);
+    void moveRelativeInSteps(long distance);
+    bool moveToHomeInSteps(long directionTowardHome, float speed,
+                           long maxDistance, int homeLimitSwitchPin);
+
+  private:
+    uint8_t stepPin = 0, directionPin = 0;
+    float   speed = 0, acceleration = 0;
+    float   velocity = 0;  // of the last step, steps per second
+    long    position = 0, target = 0;
+    int     direction = 0;
+    uint64_t nextStepNs = 0;
+};
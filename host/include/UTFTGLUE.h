@@ -0,0 +1,58 @@
+// ! Host stand-in for MCUFRIEND_kbv UTFTGLUE ! ================================
+
+// keeps a real RGB565 framebuffer and charges the 8 bit parallel bus cost of
+// every address window and pixel to the running board
+
+#pragma once
+
+#include <Adafruit_GFX.h>
+#include <vector>
+
+#define LANDSCAPE 1
+#define PORTRAIT 0
+
+class UTFTGLUE : public Adafruit_GFX {
+  public:
+    UTFTGLUE(int model, int rs, int wr, int cs, int rst, int rd = 0);
+
+    void InitLCD(char orientation = LANDSCAPE);
+    void clrScr() { fillScreen(0); }
+    void fillScr(uint16_t color) { fillScreen(color); }
+    void fillScr(uint8_t r, uint8_t g, uint8_t b) { fillScreen(color565(r, g, b)); }
+    void setColor(uint16_t color) { fcolor = color; }
+    void setColor(uint8_t r, uint8_t g, uint8_t b) { fcolor = color565(r, g, b); }
+    void setBackColor(uint16_t color) { bcolor = color; }
+    uint16_t getColor() const { return fcolor; }
+
+    using Adafruit_GFX::drawLine;
+    using Adafruit_GFX::fillCircle;
+    using Adafruit_GFX::fillRect;
+    void drawLine(int x1, int y1, int x2, int y2) { drawLine(x1, y1, x2, y2, fcolor); }
+    void fillCircle(int x, int y, int radius) { fillCircle(x, y, radius, fcolor); }
+    void fillRect(int x1, int y1, int x2, int y2);
+
+    using Adafruit_GFX::print;
+    void print(const char *st, int x, int y, int deg = 0);
+    void print(const String &st, int x, int y, int deg = 0) { print(st.c_str(), x, y, deg); }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+
+    static uint16_t color565(uint8_t r, uint8_t g, uint8_t b) {
+        return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+    }
+
+    // host only
+    uint16_t pixel(int x, int y) const { return fb[y * _width + x]; }
+    uint64_t pixels  = 0;  // pixels pushed over the bus
+    uint64_t windows = 0;  // address windows opened
+
+  private:
+    void push(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+    uint16_t              fcolor = 0xFFFF;
+    uint16_t              bcolor = 0;
+    std::vector<uint16_t> fb;
+};
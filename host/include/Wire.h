@@ -0,0 +1,60 @@
+// ! Host stand-in for the Wire library ! ======================================
+
+#pragma once
+
+#include <Arduino.h>
+
+const int BUFFER_LENGTH = 32;
+
+// one per board. as a master it drives hal::bus(), after begin(address) it
+// also answers on the bus and runs onReceive/onRequest in interrupt context
+class TwoWire : public Print, public hal::Device {
+  public:
+    explicit TwoWire(hal::Board &board);
+
+    void begin();
+    void begin(uint8_t address);
+    void begin(int address) { begin(uint8_t(address)); }
+    void end() {}
+    void setClock(uint32_t hz);
+
+    void    beginTransmission(uint8_t address);
+    void    beginTransmission(int address) { beginTransmission(uint8_t(address)); }
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop = true);
+    uint8_t requestFrom(int address, int quantity, int sendStop = true) {
+        return requestFrom(uint8_t(address), uint8_t(quantity), uint8_t(sendStop));
+    }
+
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t *data, size_t quantity) override;
+    size_t write(int n) { return write(uint8_t(n)); }
+    size_t write(unsigned int n) { return write(uint8_t(n)); }
+    size_t write(long n) { return write(uint8_t(n)); }
+    size_t write(unsigned long n) { return write(uint8_t(n)); }
+    using Print::write;
+    int available();
+    int read();
+    int peek();
+
+    void onReceive(void (*handler)(int));
+    void onRequest(void (*handler)());
+
+    // hal::Device
+    bool   receive(const uint8_t *data, size_t n) override;
+    size_t request(uint8_t *data, size_t n) override;
+
+  private:
+    void wait(size_t bytes);
+
+    hal::Board &board;
+    uint64_t    byteNs = hal::I2C_BYTE_NS;
+    uint8_t     txAddress = 0;
+    uint8_t     tx[BUFFER_LENGTH];
+    size_t      txLength = 0;
+    uint8_t     rx[BUFFER_LENGTH];
+    size_t      rxLength = 0;
+    size_t      rxIndex  = 0;
+    void (*receiveHandler)(int) = nullptr;
+    void (*requestHandler)()    = nullptr;
+};
@@ -0,0 +1,14 @@
+// ! Host stand-in for avr/eeprom.h ! ==========================================
+
+// the board's EEPROM, blank at 0xFF. a byte written keeps the EEPROM busy for
+// EEPROM_WRITE_NS, and a call that needs it waits that out as the AVR does
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+bool    eeprom_is_ready();
+uint8_t eeprom_read_byte(const uint8_t *address);
+void    eeprom_read_block(void *destination, const void *source, size_t n);
+void    eeprom_update_byte(uint8_t *address, uint8_t value);
@@ -0,0 +1,10 @@
+// ! Host stand-in for avr/interrupt.h ! =======================================
+
+// a vector is a plain function on the host, the harness hooks it to a board's
+// timer, e.g. slaveBoard.timer1.vector = slave::TIMER1_COMPA_vect
+
+#pragma once
+
+#include <avr/io.h>
+
+#define ISR(vector, ...) void vector()
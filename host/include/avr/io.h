@@ -0,0 +1,80 @@
+// ! Host stand-in for avr/io.h ! ==============================================
+
+// only Timer1, which the slave's step generator and the master's knob
+// sampling run on, the TWI, which the master's I2C engine runs, and PINA,
+// which the knobs are read from. the registers are proxies onto the running
+// board's hal::Timer16, hal::Twi and pins
+
+#pragma once
+
+#include <cstdint>
+
+#define _BV(bit) (1 << (bit))
+
+// TCCR1B
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define WGM12 3
+#define WGM13 4
+
+// TIMSK1, TIFR1
+#define OCIE1A 1
+#define OCF1A 1
+
+// TWCR
+#define TWIE 0
+#define TWEN 2
+#define TWWC 3
+#define TWSTO 4
+#define TWSTA 5
+#define TWEA 6
+#define TWINT 7
+
+// TWSR
+#define TWPS0 0
+#define TWPS1 1
+
+namespace hal {
+
+enum IoRegister {
+    TCCR1A_REG,
+    TCCR1B_REG,
+    TCNT1_REG,
+    OCR1A_REG,
+    TIMSK1_REG,
+    TIFR1_REG,
+    TWBR_REG,
+    TWSR_REG,
+    TWCR_REG,
+    TWDR_REG,
+    PINA_REG
+};
+
+uint16_t readIo(IoRegister r);
+void     writeIo(IoRegister r, uint16_t v);
+
+template <IoRegister R>
+struct Register {
+    operator uint16_t() const { return readIo(R); }
+    Register &operator=(uint16_t v) {
+        writeIo(R, v);
+        return *this;
+    }
+    Register &operator|=(uint16_t v) { return *this = readIo(R) | v; }
+    Register &operator&=(uint16_t v) { return *this = readIo(R) & v; }
+};
+
+}  // namespace hal
+
+extern hal::Register<hal::TCCR1A_REG> TCCR1A;
+extern hal::Register<hal::TCCR1B_REG> TCCR1B;
+extern hal::Register<hal::TCNT1_REG>  TCNT1;
+extern hal::Register<hal::OCR1A_REG>  OCR1A;
+extern hal::Register<hal::TIMSK1_REG> TIMSK1;
+extern hal::Register<hal::TIFR1_REG>  TIFR1;
+extern hal::Register<hal::TWBR_REG>   TWBR;
+extern hal::Register<hal::TWSR_REG>   TWSR;
+extern hal::Register<hal::TWCR_REG>   TWCR;
+extern hal::Register<hal::TWDR_REG>   TWDR;
+extern hal::Register<hal::PINA_REG>   PINA;
@@ -0,0 +1,21 @@
+// ! Host stand-in for avr/pgmspace.h ! ========================================
+
+// flash and RAM share one address space on the host
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define PGM_P const char *
+
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr) (*(void *const *)(addr))
+
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcpy_P strcpy
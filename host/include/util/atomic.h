@@ -0,0 +1,20 @@
+// ! Host stand-in for util/atomic.h ! =========================================
+
+// ATOMIC_BLOCK masks the board for its body. masking nests on the host, so
+// restoring the state is the same as forcing it on
+
+#pragma once
+
+#include <Arduino.h>
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+
+struct AtomicBlock {
+    bool done = false;
+    AtomicBlock() { noInterrupts(); }
+    ~AtomicBlock() noexcept(false) { interrupts(); }  // may end the run
+    bool once() { return !done && (done = true); }
+};
+
+#define ATOMIC_BLOCK(type) for (AtomicBlock atomic_; atomic_.once();)
@@ -0,0 +1,122 @@
+// ! Host implementation of Adafruit MPRLS ! ===================================
+
+#include <Adafruit_MPRLS.h>
+
+// * LIBRARY ===================================================================
+
+Adafruit_MPRLS::Adafruit_MPRLS(int8_t reset_pin, int8_t EOC_pin,
+                               uint16_t PSI_min, uint16_t PSI_max,
+                               float OUTPUT_min, float OUTPUT_max, float K)
+    : reset(reset_pin)
+    , eoc(EOC_pin)
+    , psiMin(PSI_min)
+    , psiMax(PSI_max)
+    , outputMin(uint32_t(float(0xFFFFFF) * OUTPUT_min / 100.0f + 0.5f))
+    , outputMax(uint32_t(float(0xFFFFFF) * OUTPUT_max / 100.0f + 0.5f))
+    , k(K) {}
+
+bool Adafruit_MPRLS::begin(uint8_t i2c_addr, TwoWire *twi) {
+    addr = i2c_addr;
+    i2c  = twi ? twi : (TwoWire *)hal::current()->wire;
+    if (reset != -1) {
+        pinMode(reset, OUTPUT);
+        digitalWrite(reset, HIGH);
+        digitalWrite(reset, LOW);
+        delay(10);
+        digitalWrite(reset, HIGH);
+    }
+    if (eoc != -1)
+        pinMode(eoc, INPUT);
+    delay(10);  // startup timing
+    return readStatus() == MPRLS_STATUS_POWERED;
+}
+
+uint8_t Adafruit_MPRLS::readStatus(void) {
+    i2c->requestFrom(addr, uint8_t(1));
+    lastStatus = i2c->read();
+    return lastStatus;
+}
+
+uint32_t Adafruit_MPRLS::readData(void) {
+    i2c->beginTransmission(addr);
+    i2c->write(0xAA);
+    i2c->write(0x00);
+    i2c->write(0x00);
+    i2c->endTransmission();
+
+    if (eoc != -1) {
+        while (!digitalRead(eoc))
+            ;
+    } else {
+        while (readStatus() & MPRLS_STATUS_BUSY)
+            delay(10);
+    }
+
+    i2c->requestFrom(addr, uint8_t(4));
+    uint8_t status = i2c->read();
+    if (status & (MPRLS_STATUS_MATHSAT | MPRLS_STATUS_FAILED))
+        return 0xFFFFFFFF;
+    uint32_t ret = uint32_t(i2c->read()) << 16;
+    ret |= uint32_t(i2c->read()) << 8;
+    ret |= uint32_t(i2c->read());
+    return ret;
+}
+
+float Adafruit_MPRLS::readPressure(void) {
+    uint32_t raw = readData();
+    if (raw == 0xFFFFFFFF || outputMin == outputMax)
+        return NAN;
+    float psi = float(int32_t(raw) - int32_t(outputMin)) * float(psiMax - psiMin);
+    psi /= float(outputMax - outputMin);
+    psi += psiMin;
+    return psi * k;
+}
+
+// * SENSOR MODEL ==============================================================
+
+MPRLSModel::MPRLSModel(uint8_t address) {
+    hal::bus().attach(address, this);
+}
+
+uint64_t MPRLSModel::now() const {
+    hal::Board *b = hal::current();
+    return b ? b->ns : 0;
+}
+
+bool MPRLSModel::eoc() const {
+    return now() >= busyUntil;
+}
+
+bool MPRLSModel::receive(const uint8_t *data, size_t n) {
+    if (n >= 1 && data[0] == 0xAA && now() >= busyUntil) {
+        startNs   = now();
+        busyUntil = startNs + conversionNs;
+        pending   = true;
+        conversions++;
+    }
+    return true;
+}
+
+// the window is over by the time it's read, so the plant can be asked what it
+// did across all of it
+void MPRLSModel::convert() {
+    pending   = false;
+    double p  = hpa ? hpa(startNs, busyUntil) : 1013.25;
+    double c  = 0x19999A + (p / PSI_to_HPA) / 25.0 * (0xE66666 - 0x19999A);
+    saturated = c < 0 || c > 0xFFFFFF;
+    counts    = c < 0 ? 0 : c > 0xFFFFFF ? 0xFFFFFF : uint32_t(c);
+}
+
+size_t MPRLSModel::request(uint8_t *data, size_t n) {
+    uint8_t status = MPRLS_STATUS_POWERED | faults;
+    if (now() < busyUntil)
+        status |= MPRLS_STATUS_BUSY;
+    else if (pending)
+        convert();
+    if (saturated)
+        status |= MPRLS_STATUS_MATHSAT;
+    uint8_t frame[4] = {status, uint8_t(counts >> 16), uint8_t(counts >> 8), uint8_t(counts)};
+    for (size_t i = 0; i < n; i++)
+        data[i] = i < 4 ? frame[i] : 0xFF;
+    return n;
+}
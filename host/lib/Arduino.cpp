@@ -0,0 +1,194 @@
+// ! Host implementation of the Arduino core ! =================================
+
+#include <Arduino.h>
+
+// * TIME ======================================================================
+
+unsigned long millis() {
+    hal::charge(hal::CLOCK_READ_NS);
+    hal::Board *b = hal::current();
+    return b ? b->ns / 1000000 : 0;
+}
+
+unsigned long micros() {
+    hal::charge(hal::CLOCK_READ_NS);
+    hal::Board *b = hal::current();
+    return b ? b->ns / 1000 : 0;
+}
+
+void delay(unsigned long ms) {
+    // advance in small slices so the other board keeps pace
+    for (unsigned long n = 0; n < ms; n++)
+        hal::charge(1000000);
+}
+
+void delayMicroseconds(unsigned int us) {
+    hal::charge(uint64_t(us) * 1000);
+}
+
+// * PINS ======================================================================
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    hal::Board *b = hal::current();
+    if (b && pin < hal::NUM_PINS)
+        b->mode[pin] = mode;
+    hal::charge(hal::PIN_NS);
+}
+
+int digitalRead(uint8_t pin) {
+    hal::charge(hal::PIN_NS);
+    hal::Board *b = hal::current();
+    return b ? b->pin(pin) : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    hal::Board *b = hal::current();
+    if (b && pin < hal::NUM_PINS) {
+        uint8_t was  = b->level[pin];
+        b->level[pin] = value ? HIGH : LOW;
+        if (b->output && b->level[pin] != was)
+            b->output(pin);
+    }
+    hal::charge(hal::PIN_NS);
+}
+
+// duration isn't used by the sketches, a tone runs until noTone()
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+    hal::Board *b = hal::current();
+    if (b && pin < hal::NUM_PINS && b->toneHz[pin] != frequency) {
+        b->toneHz[pin] = frequency;
+        if (b->output)
+            b->output(pin);
+    }
+    hal::charge(hal::PIN_NS);
+}
+
+void noTone(uint8_t pin) {
+    tone(pin, 0);
+}
+
+// * INTERRUPTS ================================================================
+
+// a board with isr > 0 never hands over the baton, so nothing can call into it.
+// an interrupt raised while they were off is taken as soon as they're back on
+void noInterrupts() {
+    hal::Board *b = hal::current();
+    if (b)
+        b->isr++;
+}
+
+void interrupts() {
+    hal::Board *b = hal::current();
+    if (b && b->isr > 0 && --b->isr == 0)
+        hal::charge(0);
+}
+
+// * STRING ====================================================================
+
+static std::string formatInteger(unsigned long long v, bool negative, unsigned char base) {
+    if (base < 2)
+        base = 10;
+    std::string out;
+    do {
+        int d = v % base;
+        out.insert(out.begin(), char(d < 10 ? '0' + d : 'A' + d - 10));
+        v /= base;
+    } while (v);
+    if (negative)
+        out.insert(out.begin(), '-');
+    return out;
+}
+
+String::Counted::Counted() {
+    if (hal::Board *b = hal::current())
+        b->strings++;
+}
+
+String::Counted::Counted(const Counted &)
+    : Counted() {}
+
+String::String(int v, unsigned char base)
+    : String(long(v), base) {}
+
+String::String(unsigned int v, unsigned char base)
+    : String((unsigned long)v, base) {}
+
+String::String(unsigned char v, unsigned char base)
+    : String((unsigned long)v, base) {}
+
+String::String(long v, unsigned char base) {
+    if (base == 10 && v < 0)
+        s = formatInteger((unsigned long long)(-(long long)v), true, base);
+    else
+        s = formatInteger((unsigned long)v, false, base);
+}
+
+String::String(unsigned long v, unsigned char base)
+    : s(formatInteger(v, false, base)) {}
+
+String::String(float v, unsigned char decimalPlaces)
+    : String(double(v), decimalPlaces) {}
+
+String::String(double v, unsigned char decimalPlaces) {
+    // matches dtostrf(value, decimalPlaces + 2, decimalPlaces, buf)
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "%*.*f", decimalPlaces + 2, decimalPlaces, v);
+    s = buf;
+}
+
+// * PRINT =====================================================================
+
+size_t Print::print(long v, int base) {
+    if (base == 10 && v < 0)
+        return write(formatInteger((unsigned long long)(-(long long)v), true, base).c_str());
+    return write(formatInteger((unsigned long)v, false, base).c_str());
+}
+
+size_t Print::print(unsigned long v, int base) {
+    return write(formatInteger(v, false, base).c_str());
+}
+
+size_t Print::print(double v, int digits) {
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "%.*f", digits, v);
+    return write(buf);
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (size--)
+        n += write(*buffer++);
+    return n;
+}
+
+// * SERIAL ====================================================================
+
+void HardwareSerial::begin(unsigned long baud) {
+    byteNs = 10000000000ull / baud;
+}
+
+void HardwareSerial::flush() {
+    if (idleAt > board.ns)
+        hal::charge(idleAt - board.ns);
+}
+
+// the ring keeps a slot free, as the AVR's does
+int HardwareSerial::availableForWrite() {
+    uint64_t queued = idleAt > board.ns ? (idleAt - board.ns + byteNs - 1) / byteNs : 0;
+    return hal::SERIAL_TX_BUFFER - 1 - int(queued);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    // wait for a free slot in the transmit ring
+    uint64_t full = byteNs * hal::SERIAL_TX_BUFFER;
+    if (idleAt > board.ns + full)
+        hal::charge(idleAt - board.ns - full);
+    idleAt = (idleAt > board.ns ? idleAt : board.ns) + byteNs;
+    board.serialOut(c);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+    hal::charge(hal::SERIAL_CALL_NS);
+    return Print::write(buffer, size);
+}
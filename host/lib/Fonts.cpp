@@ -0,0 +1,124 @@
+// ! Host synthesised GFX fonts ! ==============================================
+
+// the real FreeSans bitmaps are not needed to cost text drawing, only glyphs of
+// about the right size and ink. digits are seven segment shapes, '.', '<' and
+// '>' are drawn as such and everything else is an outlined box
+
+#include <Fonts/FreeSans12pt7b.h>
+#include <Fonts/FreeSans18pt7b.h>
+#include <Fonts/FreeSansBold12pt7b.h>
+#include <Fonts/FreeSansBold18pt7b.h>
+
+#include <vector>
+
+namespace {
+
+struct Canvas {
+    int               w, h;
+    std::vector<bool> ink;
+
+    Canvas(int w, int h)
+        : w(w)
+        , h(h)
+        , ink(w * h) {}
+
+    void rect(int x, int y, int rw, int rh) {
+        for (int yy = y; yy < y + rh && yy < h; yy++)
+            for (int xx = x; xx < x + rw && xx < w; xx++)
+                if (xx >= 0 && yy >= 0)
+                    ink[yy * w + xx] = true;
+    }
+};
+
+struct Builder {
+    std::vector<uint8_t>  bitmap;
+    std::vector<GFXglyph> glyphs;
+
+    void add(const Canvas &c, int xAdvance, int yOffset) {
+        GFXglyph g;
+        g.bitmapOffset = bitmap.size();
+        g.width        = c.w;
+        g.height       = c.h;
+        g.xAdvance     = xAdvance;
+        g.xOffset      = 1;
+        g.yOffset      = yOffset;
+        glyphs.push_back(g);
+        uint8_t bits = 0;
+        int     n    = 0;
+        for (bool b : c.ink) {
+            bits = (bits << 1) | (b ? 1 : 0);
+            if (++n % 8 == 0)
+                bitmap.push_back(bits), bits = 0;
+        }
+        if (n % 8)
+            bitmap.push_back(bits << (8 - n % 8));
+    }
+};
+
+//  aaa
+// f   b
+//  ggg
+// e   c
+//  ddd
+const uint8_t segments[10] = {
+    0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F};
+
+GFXfont make(int height, int stroke) {
+    static std::vector<Builder> keep;
+    keep.emplace_back();
+    Builder &b = keep.back();
+    int      w = height * 2 / 3, half = height / 2;
+
+    for (int ch = 0x20; ch <= 0x7E; ch++) {
+        if (ch >= '0' && ch <= '9') {
+            Canvas  c(w, height);
+            uint8_t s = segments[ch - '0'];
+            if (s & 0x01) c.rect(0, 0, w, stroke);
+            if (s & 0x02) c.rect(w - stroke, 0, stroke, half);
+            if (s & 0x04) c.rect(w - stroke, half, stroke, height - half);
+            if (s & 0x08) c.rect(0, height - stroke, w, stroke);
+            if (s & 0x10) c.rect(0, half, stroke, height - half);
+            if (s & 0x20) c.rect(0, 0, stroke, half);
+            if (s & 0x40) c.rect(0, half - stroke / 2, w, stroke);
+            b.add(c, w + stroke + 1, -height);
+        } else if (ch == '.') {
+            Canvas c(stroke + 1, stroke + 1);
+            c.rect(0, 0, stroke + 1, stroke + 1);
+            b.add(c, stroke + 4, -(stroke + 1));
+        } else if (ch == '<' || ch == '>') {
+            Canvas c(w, height * 3 / 4);
+            for (int y = 0; y < c.h; y++) {
+                int d = y < c.h / 2 ? y : c.h - 1 - y;
+                int x = d * (w - stroke) * 2 / c.h;
+                c.rect(ch == '<' ? w - stroke - x : x, y, stroke, 1);
+            }
+            b.add(c, w + stroke + 1, -c.h);
+        } else if (ch == ' ') {
+            Canvas c(1, 1);
+            b.add(c, w / 2, 0);
+        } else {
+            int    ch2 = ch >= 'a' && ch <= 'z' ? height * 3 / 4 : height;
+            Canvas c(w, ch2);
+            c.rect(0, 0, w, stroke);
+            c.rect(0, ch2 - stroke, w, stroke);
+            c.rect(0, 0, stroke, ch2);
+            c.rect(w - stroke, 0, stroke, ch2);
+            b.add(c, w + stroke + 1, -ch2);
+        }
+    }
+
+    GFXfont f;
+    f.bitmap   = b.bitmap.data();
+    f.glyph    = b.glyphs.data();
+    f.first    = 0x20;
+    f.last     = 0x7E;
+    f.yAdvance = height * 5 / 3;
+    return f;
+}
+
+}  // namespace
+
+const GFXfont FreeSans12pt7b     = make(17, 2);
+const GFXfont FreeSansBold12pt7b = make(17, 3);
+const GFXfont FreeSans18pt7b     = make(25, 3);
+const GFXfont FreeSansBold18pt7b = make(25, 4);
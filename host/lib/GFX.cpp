@@ -0,0 +1,224 @@
+// ! Host implementation of Adafruit GFX and UTFTGLUE ! ========================
+
+#include <Adafruit_GFX.h>
+#include <UTFTGLUE.h>
+
+#include <algorithm>
+#include <utility>
+
+// * GFX =======================================================================
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    for (int16_t n = 0; n < h; n++)
+        drawPixel(x, y + n, color);
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    for (int16_t n = 0; n < w; n++)
+        drawPixel(x + n, y, color);
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t n = 0; n < w; n++)
+        drawFastVLine(x + n, y, h, color);
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    if (x0 == x1) {
+        if (y0 > y1) std::swap(y0, y1);
+        drawFastVLine(x0, y0, y1 - y0 + 1, color);
+        return;
+    }
+    if (y0 == y1) {
+        if (x0 > x1) std::swap(x0, x1);
+        drawFastHLine(x0, y0, x1 - x0 + 1, color);
+        return;
+    }
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) std::swap(x0, y0), std::swap(x1, y1);
+    if (x0 > x1) std::swap(x0, x1), std::swap(y0, y1);
+    int16_t dx = x1 - x0, dy = abs(y1 - y0);
+    int16_t err = dx / 2, ystep = y0 < y1 ? 1 : -1;
+    for (; x0 <= x1; x0++) {
+        if (steep)
+            drawPixel(y0, x0, color);
+        else
+            drawPixel(x0, y0, color);
+        err -= dy;
+        if (err < 0) y0 += ystep, err += dx;
+    }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+}
+
+void Adafruit_GFX::drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    int16_t f = 1 - r, ddx = 1, ddy = -2 * r, x = 0, y = r;
+    drawPixel(x0, y0 + r, color), drawPixel(x0, y0 - r, color);
+    drawPixel(x0 + r, y0, color), drawPixel(x0 - r, y0, color);
+    while (x < y) {
+        if (f >= 0) y--, ddy += 2, f += ddy;
+        x++, ddx += 2, f += ddx;
+        drawPixel(x0 + x, y0 + y, color), drawPixel(x0 - x, y0 + y, color);
+        drawPixel(x0 + x, y0 - y, color), drawPixel(x0 - x, y0 - y, color);
+        drawPixel(x0 + y, y0 + x, color), drawPixel(x0 - y, y0 + x, color);
+        drawPixel(x0 + y, y0 - x, color), drawPixel(x0 - y, y0 - x, color);
+    }
+}
+
+// vertical spans, the same midpoint walk as GFX fillCircleHelper()
+void Adafruit_GFX::fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    drawFastVLine(x0, y0 - r, 2 * r + 1, color);
+    int16_t f = 1 - r, ddx = 1, ddy = -2 * r, x = 0, y = r, px = x, py = y;
+    while (x < y) {
+        if (f >= 0) y--, ddy += 2, f += ddy;
+        x++, ddx += 2, f += ddx;
+        if (x < y + 1) {
+            drawFastVLine(x0 + x, y0 - y, 2 * y + 1, color);
+            drawFastVLine(x0 - x, y0 - y, 2 * y + 1, color);
+        }
+        if (y != py) {
+            drawFastVLine(x0 + py, y0 - px, 2 * px + 1, color);
+            drawFastVLine(x0 - py, y0 - px, 2 * px + 1, color);
+            py = y;
+        }
+        px = x;
+    }
+}
+
+// horizontal spans, the same edge walk as GFX fillTriangle()
+void Adafruit_GFX::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                                int16_t x2, int16_t y2, uint16_t color) {
+    if (y0 > y1) std::swap(y0, y1), std::swap(x0, x1);
+    if (y1 > y2) std::swap(y2, y1), std::swap(x2, x1);
+    if (y0 > y1) std::swap(y0, y1), std::swap(x0, x1);
+
+    if (y0 == y2) {
+        int16_t a = x0, b = x0;
+        if (x1 < a) a = x1; else if (x1 > b) b = x1;
+        if (x2 < a) a = x2; else if (x2 > b) b = x2;
+        drawFastHLine(a, y0, b - a + 1, color);
+        return;
+    }
+
+    int16_t dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0,
+            dx12 = x2 - x1, dy12 = y2 - y1;
+    int32_t sa = 0, sb = 0;
+    int16_t a, b, y, last = y1 == y2 ? y1 : y1 - 1;
+
+    for (y = y0; y <= last; y++) {
+        a = x0 + sa / dy01;
+        b = x0 + sb / dy02;
+        sa += dx01;
+        sb += dx02;
+        if (a > b) std::swap(a, b);
+        drawFastHLine(a, y, b - a + 1, color);
+    }
+
+    sa = (int32_t)dx12 * (y - y1);
+    sb = (int32_t)dx02 * (y - y0);
+    for (; y <= y2; y++) {
+        a = x1 + sa / dy12;
+        b = x0 + sb / dy02;
+        sa += dx12;
+        sb += dx02;
+        if (a > b) std::swap(a, b);
+        drawFastHLine(a, y, b - a + 1, color);
+    }
+}
+
+// custom fonts are always transparent, one drawPixel per set bit
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color) {
+    GFXglyph *glyph  = gfxFont->glyph + (c - gfxFont->first);
+    uint8_t  *bitmap = gfxFont->bitmap;
+    uint16_t  bo     = glyph->bitmapOffset;
+    uint8_t   bits = 0, bit = 0;
+    for (int16_t yy = 0; yy < glyph->height; yy++) {
+        for (int16_t xx = 0; xx < glyph->width; xx++) {
+            if (!(bit++ & 7))
+                bits = bitmap[bo++];
+            if (bits & 0x80)
+                drawPixel(x + glyph->xOffset + xx, y + glyph->yOffset + yy, color);
+            bits <<= 1;
+        }
+    }
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+    if (!gfxFont)
+        return 1;
+    if (c == '\n') {
+        cursor_x = 0;
+        cursor_y += gfxFont->yAdvance;
+    } else if (c >= gfxFont->first && c <= gfxFont->last) {
+        drawChar(cursor_x, cursor_y, c, textcolor);
+        cursor_x += gfxFont->glyph[c - gfxFont->first].xAdvance;
+    }
+    return 1;
+}
+
+// * UTFTGLUE ==================================================================
+
+UTFTGLUE::UTFTGLUE(int model, int rs, int wr, int cs, int rst, int rd)
+    : Adafruit_GFX(480, 320)
+    , fb(480 * 320, 0) {
+    (void)model, (void)rs, (void)wr, (void)cs, (void)rst, (void)rd;
+}
+
+void UTFTGLUE::InitLCD(char orientation) {
+    (void)orientation;
+    hal::charge(120000000);  // reset and sleep-out delays of the ILI9486
+    fillScreen(0);
+}
+
+void UTFTGLUE::fillRect(int x1, int y1, int x2, int y2) {
+    if (x1 > x2) std::swap(x1, x2);
+    if (y1 > y2) std::swap(y1, y2);
+    fillRect(x1, y1, x2 - x1 + 1, y2 - y1 + 1, fcolor);
+}
+
+// the baseline sits one digit height below y so text hangs from its origin
+void UTFTGLUE::print(const char *st, int x, int y, int deg) {
+    (void)deg;
+    int ascent = 0;
+    if (gfxFont)
+        ascent = -gfxFont->glyph['0' - gfxFont->first].yOffset;
+    setCursor(x, y + ascent);
+    setTextColor(fcolor);
+    write(st);
+}
+
+void UTFTGLUE::push(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (x < 0) w += x, x = 0;
+    if (y < 0) h += y, y = 0;
+    if (x + w > _width) w = _width - x;
+    if (y + h > _height) h = _height - y;
+    if (w <= 0 || h <= 0)
+        return;
+    for (int16_t r = y; r < y + h; r++)
+        std::fill(&fb[r * _width + x], &fb[r * _width + x + w], color);
+    uint64_t n = uint64_t(w) * h;
+    windows++;
+    pixels += n;
+    hal::charge(hal::TFT_WINDOW_NS + n * hal::TFT_PIXEL_NS);
+}
+
+void UTFTGLUE::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    push(x, y, 1, 1, color);
+}
+
+void UTFTGLUE::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    push(x, y, 1, h, color);
+}
+
+void UTFTGLUE::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    push(x, y, w, 1, color);
+}
+
+void UTFTGLUE::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    push(x, y, w, h, color);
+}
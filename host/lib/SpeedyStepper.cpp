@@ -0,0 +1,119 @@
+// ! Host implementation of SpeedyStepper ! ====================================
+
+#include <SpeedyStepper.h>
+
+#include <algorithm>
+
+void SpeedyStepper::connectToPins(uint8_t step, uint8_t dir) {
+    stepPin      = step;
+    directionPin = dir;
+    pinMode(stepPin, OUTPUT);
+    pinMode(directionPin, OUTPUT);
+}
+
+void SpeedyStepper::setSpeedInStepsPerSecond(float s) {
+    speed = s;
+}
+
+void SpeedyStepper::setAccelerationInStepsPerSecondPerSecond(float a) {
+    acceleration = a;
+}
+
+void SpeedyStepper::setCurrentPositionInSteps(long p) {
+    position = target = p;
+}
+
+float SpeedyStepper::getCurrentVelocityInStepsPerSecond() const {
+    return motionComplete() ? 0 : velocity * direction;
+}
+
+void SpeedyStepper::setupMoveInSteps(long absolutePosition) {
+    target    = absolutePosition;
+    direction = target > position ? 1 : -1;
+    velocity  = 0;
+    digitalWrite(directionPin, direction > 0 ? LOW : HIGH);
+    hal::Board *b = hal::current();
+    nextStepNs = b ? b->ns : 0;  // first step is due immediately
+}
+
+void SpeedyStepper::setupRelativeMoveInSteps(long distance) {
+    setupMoveInSteps(position + distance);
+}
+
+void SpeedyStepper::setupStop() {
+    long stop = long(velocity * velocity / (2 * acceleration));
+    if (!motionComplete() && labs(target - position) > stop)
+        target = position + direction * stop;
+}
+
+bool SpeedyStepper::processMovement(void) {
+    if (motionComplete())
+        return true;
+    hal::Board *b   = hal::current();
+    uint64_t    now = b ? b->ns : 0;
+    if (now < nextStepNs) {
+        hal::charge(hal::STEP_POLL_NS);
+        return false;
+    }
+
+    position += direction;
+    digitalWrite(stepPin, HIGH);
+    digitalWrite(stepPin, LOW);
+
+    // v^2 = u^2 + 2as per step, braking once the stopping distance is reached.
+    // like the library's slowest step period, braking never goes below the
+    // speed of the first step, or the last few steps of a move can crawl
+    long  remaining = labs(target - position);
+    float brake     = velocity * velocity / (2 * acceleration);
+    float slowest   = sqrtf(2 * acceleration);
+    if (remaining <= brake)
+        velocity = sqrtf(std::max(0.0f, velocity * velocity - 2 * acceleration));
+    else
+        velocity = sqrtf(velocity * velocity + 2 * acceleration);
+    if (velocity < slowest)
+        velocity = slowest;
+    if (velocity > speed)
+        velocity = speed;
+    nextStepNs = now + uint64_t(1e9 / velocity);
+    return motionComplete();
+}
+
+void SpeedyStepper::moveToPositionInSteps(long absolutePosition) {
+    setupMoveInSteps(absolutePosition);
+    while (!processMovement())
+        ;
+}
+
+void SpeedyStepper::moveRelativeInSteps(long distance) {
+    moveToPositionInSteps(position + distance);
+}
+
+// run toward the switch until it closes, then creep back off it
+bool SpeedyStepper::moveToHomeInSteps(long directionTowardHome, float s,
+                                      long maxDistance, int homeLimitSwitchPin) {
+    float saved = speed;
+    speed       = s;
+    setCurrentPositionInSteps(0);
+    setupMoveInSteps(maxDistance * directionTowardHome);
+    bool found = false;
+    while (!processMovement()) {
+        if (digitalRead(homeLimitSwitchPin) == LOW) {
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        speed = saved;
+        return false;
+    }
+
+    speed = s / 8;
+    setCurrentPositionInSteps(0);
+    setupMoveInSteps(-directionTowardHome * maxDistance);
+    while (!processMovement())
+        if (digitalRead(homeLimitSwitchPin) == HIGH)
+            break;
+    setCurrentPositionInSteps(0);
+    speed = saved;
+    return true;
+}
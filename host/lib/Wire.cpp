@@ -0,0 +1,105 @@
+// ! Host implementation of Wire ! =============================================
+
+#include <Wire.h>
+
+TwoWire::TwoWire(hal::Board &board)
+    : board(board) {
+    board.wire = this;
+}
+
+void TwoWire::begin() {
+    txLength = rxLength = rxIndex = 0;
+}
+
+void TwoWire::begin(uint8_t address) {
+    begin();
+    hal::bus().attach(address, this);
+}
+
+void TwoWire::setClock(uint32_t hz) {
+    byteNs = 9000000000ull / hz;
+}
+
+void TwoWire::wait(size_t bytes) {
+    hal::charge(hal::I2C_FRAME_NS + bytes * byteNs);
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    txAddress = address;
+    txLength  = 0;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    (void)sendStop;
+    wait(txLength + 1);
+    uint8_t status = hal::bus().transmit(txAddress, tx, txLength);
+    txLength       = 0;
+    return status;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop) {
+    (void)sendStop;
+    if (quantity > BUFFER_LENGTH)
+        quantity = BUFFER_LENGTH;
+    rxLength = hal::bus().receive(address, rx, quantity);
+    rxIndex  = 0;
+    // the master clocks out every byte it asked for, even if nobody answered
+    wait(quantity + 1);
+    return rxLength;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (txLength >= BUFFER_LENGTH)
+        return 0;
+    tx[txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity) {
+    size_t n = 0;
+    while (quantity-- && write(*data++))
+        n++;
+    return n;
+}
+
+int TwoWire::available() {
+    return rxLength - rxIndex;
+}
+
+int TwoWire::read() {
+    return rxIndex < rxLength ? rx[rxIndex++] : -1;
+}
+
+int TwoWire::peek() {
+    return rxIndex < rxLength ? rx[rxIndex] : -1;
+}
+
+void TwoWire::onReceive(void (*handler)(int)) {
+    receiveHandler = handler;
+}
+
+void TwoWire::onRequest(void (*handler)()) {
+    requestHandler = handler;
+}
+
+bool TwoWire::receive(const uint8_t *data, size_t n) {
+    if (n > BUFFER_LENGTH)
+        n = BUFFER_LENGTH;
+    std::memcpy(rx, data, n);
+    rxLength = n;
+    rxIndex  = 0;
+    if (receiveHandler)
+        hal::interrupt(board, [&] { receiveHandler(int(n)); });
+    return true;
+}
+
+size_t TwoWire::request(uint8_t *data, size_t n) {
+    txLength = 0;
+    if (requestHandler)
+        hal::interrupt(board, [&] { requestHandler(); });
+    // a slave that runs out of data leaves the bus high
+    for (size_t i = 0; i < n; i++)
+        data[i] = i < txLength ? tx[i] : 0xFF;
+    txLength = 0;
+    return n;
+}
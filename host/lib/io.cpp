@@ -0,0 +1,124 @@
+// ! Host implementation of the AVR registers ! ================================
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+
+hal::Register<hal::TCCR1A_REG> TCCR1A;
+hal::Register<hal::TCCR1B_REG> TCCR1B;
+hal::Register<hal::TCNT1_REG>  TCNT1;
+hal::Register<hal::OCR1A_REG>  OCR1A;
+hal::Register<hal::TIMSK1_REG> TIMSK1;
+hal::Register<hal::TIFR1_REG>  TIFR1;
+hal::Register<hal::TWBR_REG>   TWBR;
+hal::Register<hal::TWSR_REG>   TWSR;
+hal::Register<hal::TWCR_REG>   TWCR;
+hal::Register<hal::TWDR_REG>   TWDR;
+hal::Register<hal::PINA_REG>   PINA;
+
+namespace hal {
+
+const uint8_t PORTA_PIN = 22;  // PA0, on up to PA7 at 29
+
+uint16_t readIo(IoRegister r) {
+    charge(PORT_NS);
+    Board *b = current();
+    if (!b)
+        return 0;
+    Timer16 &t = b->timer1;
+    Twi     &w = b->twi;
+    switch (r) {
+    case TCCR1B_REG: return t.control;
+    case TCNT1_REG: return t.count(b->ns);
+    case OCR1A_REG: return t.compare;
+    case TIMSK1_REG: return t.mask;
+    case TWBR_REG: return w.rate;
+    case TWSR_REG: return w.status | w.prescale;
+    case TWCR_REG: return w.control | (w.flag ? _BV(TWINT) : 0);
+    case TWDR_REG: return w.data;
+    case PINA_REG: {
+        uint8_t v = 0;
+        for (uint8_t i = 0; i < 8; i++)
+            v |= b->pin(PORTA_PIN + i) << i;
+        return v;
+    }
+    default: return 0;
+    }
+}
+
+void writeIo(IoRegister r, uint16_t v) {
+    charge(PORT_NS);
+    Board *b = current();
+    if (!b)
+        return;
+    Timer16 &t = b->timer1;
+    Twi     &w = b->twi;
+    switch (r) {
+    case TCCR1B_REG: {
+        // stopping the clock holds the count, starting it runs on from there
+        uint16_t count = t.count(b->ns);
+        t.control      = v;
+        t.held         = count;
+        t.last         = b->ns - count * t.tickNs();
+        break;
+    }
+    case TCNT1_REG:
+        t.held = v;
+        t.last = b->ns - v * t.tickNs();
+        break;
+    case OCR1A_REG:
+        t.catchUp(b->ns);
+        t.compare = v;
+        break;
+    case TIMSK1_REG: t.mask = v; break;
+    case TIFR1_REG:
+        // clearing OCF1A drops a match that is pending while masked
+        t.catchUp(b->ns);
+        break;
+    case TWBR_REG: w.rate = v; break;
+    case TWSR_REG: w.prescale = v & 3; break;
+    case TWCR_REG: w.write(b->ns, v); break;
+    case TWDR_REG: w.data = v; break;
+    default: break;
+    }
+}
+
+}  // namespace hal
+
+// * EEPROM ====================================================================
+
+// waits out a write still going, as the AVR's EEPE bit would be polled
+static void eepromWait(hal::Board *b) {
+    if (b->eepromBusy > b->ns)
+        hal::charge(b->eepromBusy - b->ns);
+}
+
+bool eeprom_is_ready() {
+    hal::charge(hal::PORT_NS);
+    hal::Board *b = hal::current();
+    return !b || b->eepromBusy <= b->ns;
+}
+
+uint8_t eeprom_read_byte(const uint8_t *address) {
+    hal::Board *b = hal::current();
+    size_t      a = size_t(address);
+    if (!b || a >= hal::EEPROM_SIZE)
+        return 0xFF;
+    eepromWait(b);
+    hal::charge(hal::EEPROM_READ_NS);
+    return b->eeprom[a];
+}
+
+void eeprom_read_block(void *destination, const void *source, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        ((uint8_t *)destination)[i] = eeprom_read_byte((const uint8_t *)source + i);
+}
+
+// an unchanged byte is only read, which is the point of update over write
+void eeprom_update_byte(uint8_t *address, uint8_t value) {
+    hal::Board *b = hal::current();
+    size_t      a = size_t(address);
+    if (!b || a >= hal::EEPROM_SIZE || eeprom_read_byte(address) == value)
+        return;
+    b->eeprom[a]  = value;
+    b->eepromBusy = b->ns + hal::EEPROM_WRITE_NS;
+}
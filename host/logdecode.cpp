@@ -0,0 +1,38 @@
+// ! Log Decoder ! =============================================================
+
+// reads a board's Serial output, from a capture or straight off the port,
+// and prints it with the binary log records turned back into text. each
+// record is stamped with the board's millis() when it was logged
+//
+//   stty -F /dev/ttyACM0 115200 raw && ./logdecode /dev/ttyACM0
+//   ./logdecode capture.bin
+
+#include "logdecode.h"
+
+#include <cstdio>
+
+int main(int argc, char **argv) {
+    FILE *in = argc > 1 ? std::fopen(argv[1], "rb") : stdin;
+    if (!in) {
+        std::perror(argv[1]);
+        return 1;
+    }
+
+    LogDecoder  decoder;
+    std::string line;
+    int         c;
+    while ((c = std::fgetc(in)) != EOF) {
+        bool done;
+        if (decoder.feed(c, &done)) {
+            if (done)
+                std::printf("[%10.3f] %s\n", decoder.ms / 1e3, decoder.text.c_str());
+        } else if (c == '\n') {
+            std::printf("             %s\n", line.c_str());
+            line.clear();
+        } else if (c != '\r') {
+            line += char(c);
+        }
+        std::fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+// ! Log Record Decoder ! ======================================================
+
+// turns the binary records of master/logger.h back into text, for
+// host/logdecode and the co-simulation's -v echo. both boards' event tables
+// are read straight from their events.h, so a new event needs nothing here
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+struct LogEventName {
+    int         id;
+    const char *name;
+    const char *format;
+};
+
+#define LOG_DECODE(name, id, format) {id, #name, format},
+
+#include "../master/events.h"
+static const LogEventName masterEvents[] = {LOG_EVENTS(LOG_DECODE)};
+#include "../slave/events.h"
+static const LogEventName slaveEvents[] = {LOG_EVENTS(LOG_DECODE)};
+
+#undef LOG_DECODE
+
+class LogDecoder {
+  public:
+    uint64_t    ms = 0;  // time of the last record, from the board's millis()
+    std::string text;    // the last record, formatted
+
+    // takes one byte of the stream. false if it's text outside a record.
+    // done is set on the last byte of a record, with ms and text filled in
+    bool feed(uint8_t c, bool *done) {
+        *done = false;
+        if (!event) {
+            if (c < 0x80)
+                return false;
+            event = find(c & 0x7F);
+            if (!event) {
+                text  = "log: unknown event " + std::to_string(c & 0x7F);
+                *done = true;
+                return true;
+            }
+            count   = 0;
+            wanted  = args(event->format);
+            value   = 0;
+            shift   = 0;
+            stamped = false;
+            return true;
+        }
+
+        value |= uint32_t(c & 0x7F) << shift;
+        shift += 7;
+        if (c & 0x80)
+            return true;
+        if (!stamped) {
+            ms += value;
+            stamped = true;
+        } else {
+            values[count++] = value;
+        }
+        value = 0;
+        shift = 0;
+        if (count == wanted) {
+            text  = format(event->format);
+            event = nullptr;
+            *done = true;
+        }
+        return true;
+    }
+
+  private:
+    const LogEventName *event = nullptr;
+    uint32_t            values[8];
+    uint32_t            value = 0;
+    int                 shift = 0, count = 0, wanted = 0;
+    bool                stamped = false;
+
+    static const LogEventName *find(int id) {
+        for (const auto &e : masterEvents)
+            if (e.id == id)
+                return &e;
+        for (const auto &e : slaveEvents)
+            if (e.id == id)
+                return &e;
+        return nullptr;
+    }
+
+    static int args(const char *f) {
+        int n = 0;
+        for (; *f; f++)
+            n += *f == '%';
+        return n;
+    }
+
+    std::string format(const char *f) const {
+        std::string out;
+        int         n = 0;
+        char        buf[16];
+        for (; *f; f++) {
+            if (*f != '%' || !f[1]) {
+                out += *f;
+                continue;
+            }
+            // args are zigzag encoded
+            uint32_t z = values[n++];
+            int32_t  v = int32_t(z >> 1) ^ -int32_t(z & 1);
+            switch (*++f) {
+            case 'd': std::snprintf(buf, sizeof(buf), "%d", v); break;
+            case 'x': std::snprintf(buf, sizeof(buf), "%x", uint32_t(v)); break;
+            default: std::snprintf(buf, sizeof(buf), "%u", uint32_t(v)); break;
+            }
+            out += buf;
+        }
+        return out;
+    }
+};
@@ -0,0 +1,111 @@
+// ! Needle Geometry Generator ! ===============================================
+
+// writes master/needle.h, the 6 point needle offsets for every angle that
+// calcAngle() can produce, computed the way buildNeedle() used to at runtime.
+// -check lists entries that truncate differently in double precision, the
+// only ones where avr-libc could disagree with the host, and times both
+//
+//   ./needlegen > ../master/needle.h
+//   ./needlegen -check
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+const int R1 = 70, R2 = 60;              // must match master.ino
+const int MIN_ANGLE = -45, MAX_ANGLE = 225;
+const int ANGLES = MAX_ANGLE - MIN_ANGLE + 1;
+
+// the original buildNeedle() maths, in single precision like avr-libc
+template <typename T>
+void trigAs(int angle, int *out) {
+    T degToRad    = T(0.0174532925);
+    T radianMid   = angle * degToRad;
+    T radianSide0 = (angle - (6 / 2)) * degToRad;
+    T radianSide1 = (angle + (6 / 2)) * degToRad;
+    T side[3]     = {radianSide0, radianMid, radianSide1};
+    for (int n = 0; n < 3; n++) {
+        out[n * 2]         = int((R1 + 1) * std::cos(side[n]));
+        out[n * 2 + 1]     = -int((R1 + 1) * std::sin(side[n]));
+        out[n * 2 + 6]     = int((R2 + 1) * std::cos(side[n]));
+        out[n * 2 + 6 + 1] = -int((R2 + 1) * std::sin(side[n]));
+    }
+}
+
+void trig(int angle, int *out) {
+    trigAs<float>(angle, out);
+}
+
+signed char table[ANGLES][12];
+
+void lookup(int angle, int *out) {
+    const signed char *row = table[angle - MIN_ANGLE];
+    for (int n = 0; n < 12; n++)
+        out[n] = row[n];
+}
+
+void generate() {
+    std::printf("// ! Needle Geometry ! =========================================================\n\n");
+    std::printf("// generated by host/needlegen, do not edit\n");
+    std::printf("// x,y offsets from the dial origin of needle points 1 to 6 for each whole\n");
+    std::printf("// angle from NEEDLE_MIN_ANGLE to NEEDLE_MAX_ANGLE, see buildNeedle()\n\n");
+    std::printf("#pragma once\n\n");
+    std::printf("#define NEEDLE_R1 %d\n", R1);
+    std::printf("#define NEEDLE_R2 %d\n", R2);
+    std::printf("#define NEEDLE_MIN_ANGLE %d\n", MIN_ANGLE);
+    std::printf("#define NEEDLE_MAX_ANGLE %d\n\n", MAX_ANGLE);
+    std::printf("const int8_t needleOffsets[%d][12] PROGMEM = {\n", ANGLES);
+    for (int a = 0; a < ANGLES; a++) {
+        std::printf("    {");
+        for (int n = 0; n < 12; n++)
+            std::printf("%s%d", n ? ", " : "", table[a][n]);
+        std::printf("},  // %d\n", a + MIN_ANGLE);
+    }
+    std::printf("};\n");
+}
+
+int check() {
+    int bad = 0, out[12], ref[12];
+    for (int a = MIN_ANGLE; a <= MAX_ANGLE; a++) {
+        trigAs<double>(a, ref);
+        lookup(a, out);
+        for (int n = 0; n < 12; n++)
+            if (out[n] != ref[n]) {
+                std::printf("angle %d point %d: %d in float, %d in double\n",
+                            a, n / 2 + 1, out[n], ref[n]);
+                bad++;
+            }
+    }
+
+    // host timings only show the shape of the win, see the commit for AVR
+    volatile int sink = 0;
+    auto         time = [&](void (*fn)(int, int *)) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 200; i++)
+            for (int a = MIN_ANGLE; a <= MAX_ANGLE; a++) {
+                fn(a, out);
+                sink += out[5];
+            }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / (200.0 * ANGLES);
+    };
+    double t = time(trig), l = time(lookup);
+    std::printf("%d angles, %d borderline coordinates\n", ANGLES, bad);
+    std::printf("trig   %.1f ns per needle\n", t);
+    std::printf("table  %.1f ns per needle\n", l);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int ref[12];
+    for (int a = MIN_ANGLE; a <= MAX_ANGLE; a++) {
+        trig(a, ref);
+        for (int n = 0; n < 12; n++)
+            table[a - MIN_ANGLE][n] = (signed char)ref[n];
+    }
+    if (argc > 1 && !std::strcmp(argv[1], "-check"))
+        return check();
+    generate();
+    return 0;
+}
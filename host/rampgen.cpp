@@ -0,0 +1,67 @@
+// ! Step Ramp Generator ! =====================================================
+
+// writes slave/ramp.h, the Timer1 ticks between steps of a move that starts
+// from rest at MAX_ACCELERATION. step k of a ramp is due at sqrt(2k / a), so
+// entry k is the gap from step k to step k + 1. the table runs until the gap
+// is shorter than a step at MAX_SPEED, so any cruise speed is on it. -check
+// compares the table's running total with the exact ramp
+//
+//   ./rampgen > ../slave/ramp.h
+//   ./rampgen -check
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+const double ACCELERATION = 24000;     // must match MAX_ACCELERATION in slave.ino
+const double MAX_SPS      = 16 * 400;  // must match MAX_SPEED * STEPS in slave.ino
+const double TICK_HZ      = 2000000;   // Timer1 at 16 MHz / 8
+
+int steps() {
+    int k = 0;
+    while (TICK_HZ * (std::sqrt(2.0 * (k + 1) / ACCELERATION) -
+                      std::sqrt(2.0 * k / ACCELERATION)) >= TICK_HZ / MAX_SPS)
+        k++;
+    return k + 1;
+}
+
+unsigned ticks(int k) {
+    return unsigned(std::lround(TICK_HZ * (std::sqrt(2.0 * (k + 1) / ACCELERATION) -
+                                           std::sqrt(2.0 * k / ACCELERATION))));
+}
+
+void generate() {
+    int n = steps();
+    std::printf("// ! Step Ramp ! ===============================================================\n\n");
+    std::printf("// generated by host/rampgen, do not edit\n");
+    std::printf("// Timer1 ticks from step k to step k + 1 of a move from rest at\n");
+    std::printf("// RAMP_ACCELERATION, down to the gap of a step at MAX_SPEED\n\n");
+    std::printf("#pragma once\n\n");
+    std::printf("#define RAMP_ACCELERATION %.0f\n", ACCELERATION);
+    std::printf("#define RAMP_TICK_HZ %.0fUL\n", TICK_HZ);
+    std::printf("#define RAMP_STEPS %d\n\n", n);
+    std::printf("const uint16_t rampTicks[RAMP_STEPS] PROGMEM = {");
+    for (int k = 0; k < n; k++)
+        std::printf("%s%u", k % 12 ? ", " : (k ? ",\n    " : "\n    "), ticks(k));
+    std::printf("};\n");
+}
+
+int check() {
+    int    n     = steps();
+    double total = 0, worst = 0;
+    for (int k = 0; k < n; k++) {
+        total += ticks(k) / TICK_HZ;
+        double exact = std::sqrt(2.0 * (k + 1) / ACCELERATION);
+        worst        = std::fmax(worst, std::fabs(total - exact));
+    }
+    std::printf("%d steps, %u to %u ticks\n", n, ticks(0), ticks(n - 1));
+    std::printf("ramp takes %.3f ms, worst drift from exact %.1f us\n", total * 1e3, worst * 1e6);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && !std::strcmp(argv[1], "-check"))
+        return check();
+    generate();
+    return 0;
+}
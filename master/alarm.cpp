@@ -0,0 +1,169 @@
+// ! Implementation of alarm ! =================================================
+
+#include "alarm.h"
+#include "dial.h"
+#include "scheduler.h"
+
+const alarmLayout alarmLayouts[ALARMS] PROGMEM = {
+    // raise, clear, priority, latching, name
+    {2, 5, ALARM_PRIORITY_HIGH, 1, "OVER"},
+    {1, 1, ALARM_PRIORITY_HIGH, 1, "LOW"},
+    {1, 1, ALARM_PRIORITY_HIGH, 1, "SENSOR"},
+    {3, 5, ALARM_PRIORITY_MEDIUM, 0, "HIGH"},
+    {1, 1, ALARM_PRIORITY_MEDIUM, 0, "SLAVE"},
+};
+
+const uint8_t alarmHighPattern[] PROGMEM = {
+    15, 10, 15, 10, 15, 35, 15, 10, 15, 100,
+    15, 10, 15, 10, 15, 35, 15, 10, 15, 250, 0,
+};
+const uint8_t alarmMediumPattern[] PROGMEM = {20, 20, 20, 20, 20, 250, 0};
+
+void alarmBegin() {
+    alarmEngine  *a   = &alarms;
+    unsigned long now = micros();
+    a->cursor   = mprls.head;
+    a->aboveLow = now;
+    a->sampled  = now;
+    a->sounding = -1;
+    a->shown    = -1;
+    if (sensorStatus & (PRESSURE_SATURATED | PRESSURE_FAILED)) {
+        a->alarm[ALARM_SENSOR].since = now;
+        alarmRaise(ALARM_SENSOR);
+    }
+}
+
+// the pressure alarms are checked a sample at a time, with the sample's own
+// stamp, so a backlog is judged as it happened
+void alarmUpdate() {
+    alarmEngine *a = &alarms;
+    sample       s;
+    while (pressureRead(&a->cursor, &s)) {
+        alarmCheck(ALARM_OVER, pressureOver(s.cmH20), s.us);
+        alarmCheck(ALARM_HIGH, pressureHigh(s.cmH20), s.us);
+        // relative to the last breath's PEEP, as a stopped arm leaves the
+        // airway at the PEEP valve, whatever it's set to
+        if (s.cmH20 > cmH20.peep + ALARM_LOW_RISE)
+            a->aboveLow = s.us;
+        a->sampled = s.us;
+    }
+
+    unsigned long now = micros();
+    alarmCheck(ALARM_LOW, now - a->aboveLow > ALARM_LOW_TIME * 1000, now);
+    alarmCheck(ALARM_SENSOR, now - a->sampled > ALARM_SENSOR_TIME * 1000, now);
+    alarmCheck(ALARM_SLAVE, t.current - slaveLink.heard > ALARM_SLAVE_TIME, now);
+    alarmSound();
+}
+
+void alarmCheck(uint8_t id, bool condition, unsigned long at) {
+    alarmState        *a = &alarms.alarm[id];
+    const alarmLayout *l = &alarmLayouts[id];
+    if (condition == a->active) {
+        a->count = 0;
+        return;
+    }
+    if (a->count++ == 0)
+        a->since = at;
+    if (a->count < flashRead(condition ? &l->raise : &l->clear))
+        return;
+
+    a->count  = 0;
+    a->active = condition;
+    if (condition)
+        alarmRaise(id);
+    else
+        LOG_INFO(ALARM_CLEARED, id);
+}
+
+// an alarm raised under a more urgent one is heard straight away all the
+// same, as the tone is already going
+void alarmRaise(uint8_t id) {
+    alarmState *a = &alarms.alarm[id];
+    a->raised++;
+    if (flashRead(&alarmLayouts[id].latching))
+        a->latched = true;
+    alarmSound();
+    a->latency = micros() - a->since;
+    if (a->latency > a->latencyMax)
+        a->latencyMax = a->latency;
+    LOG_WARN(ALARM_RAISED, id, a->latency);
+}
+
+void alarmAcknowledge() {
+    uint8_t ended = 0;
+    for (uint8_t id = 0; id < ALARMS; id++) {
+        alarmState *a = &alarms.alarm[id];
+        if (a->latched && !a->active) {
+            a->latched = false;
+            ended++;
+        }
+    }
+    LOG_INFO(ALARMS_ACKED, ended);
+}
+
+// the table is in order of urgency
+int8_t alarmTop() {
+    for (uint8_t id = 0; id < ALARMS; id++)
+        if (alarms.alarm[id].active || alarms.alarm[id].latched)
+            return id;
+    return -1;
+}
+
+// even steps of a pattern sound and odd ones are quiet, and tone() runs off
+// a timer, so the speaker keeps going however long the next call is
+void alarmSound() {
+    alarmEngine  *a   = &alarms;
+    int8_t        top = alarmTop();
+    unsigned long now = millis();
+
+    if (top != a->sounding) {
+        a->sounding = top;
+        if (top < 0) {
+            noTone(speaker);
+            return;
+        }
+        bool high  = flashRead(&alarmLayouts[top].priority) == ALARM_PRIORITY_HIGH;
+        a->pattern = high ? alarmHighPattern : alarmMediumPattern;
+        a->step    = 0;
+        a->stepAt  = now + pgm_read_byte(a->pattern) * 10;
+        tone(speaker, high ? ALARM_TONE_HIGH : ALARM_TONE_MEDIUM);
+        return;
+    }
+    if (top < 0 || long(now - a->stepAt) < 0)
+        return;
+
+    uint8_t length = pgm_read_byte(a->pattern + ++a->step);
+    if (length == 0) {
+        a->step = 0;
+        length  = pgm_read_byte(a->pattern);
+    }
+    a->stepAt += length * 10;
+    if (a->step % 2)
+        noTone(speaker);
+    else
+        tone(speaker, a->pattern == alarmHighPattern ? ALARM_TONE_HIGH : ALARM_TONE_MEDIUM);
+}
+
+// the old name goes as one rectangle rather than printed over, and printing
+// the new one is a few milliseconds, so the alarms get a look in between
+void alarmShow() {
+    alarmEngine *a      = &alarms;
+    int8_t       top    = alarmTop();
+    bool         active = top >= 0 && a->alarm[top].active;
+    char         name[sizeof(alarmLayouts[0].name)];
+    if (top == a->shown && active == a->shownActive)
+        return;
+
+    if (a->shown >= 0) {
+        display.fillRect(ALARM_X, ALARM_Y, ALARM_WIDTH, ALARM_HEIGHT, c.back);
+        schedulerYield();
+    }
+    if (top >= 0) {
+        strcpy_P(name, alarmLayouts[top].name);
+        display.setFont(smallFontBold);
+        display.setColor(active ? c.error : c.latched);
+        display.print(name, ALARM_X, ALARM_Y);
+    }
+    a->shown       = top;
+    a->shownActive = active;
+}
@@ -0,0 +1,116 @@
+// ! Alarms ! ==================================================================
+
+#pragma once
+#include "comm.h"
+#include "logger.h"
+#include "pressure.h"
+#include "util.h"
+
+// every new pressure sample goes through the pressure alarms as soon as it's
+// in the ring, and the alarms that are about time going by are checked on
+// every run. a condition has to hold for its table's raise count in a row to
+// raise its alarm and be gone for its clear count to end it. a latching alarm
+// stays up once its condition is gone until alarmAcknowledge(), the rest end
+// by themselves. the most urgent alarm up picks the tone, and the pattern is
+// stepped from the task so nothing waits on the speaker
+//
+// the tone starts in the same run that raises the alarm. from a sample being
+// taken that's the conversion, up to a millisecond till the task comes round,
+// however late the task runs behind the longest stretch another task goes
+// without a yield, and the rest of the raise count at the sensor rate. the
+// time from the first sample of the run that raised an alarm to its tone is
+// kept, for time based alarms it's from when the condition was first seen
+const uint8_t       ALARM_OVER   = 0;  // airway over MAX_PEAK
+const uint8_t       ALARM_LOW    = 1;  // no breath, a disconnect or leak
+const uint8_t       ALARM_SENSOR = 2;  // no good pressure sample, or a bad status
+const uint8_t       ALARM_HIGH   = 3;  // airway over HIGH_PEAK
+const uint8_t       ALARM_SLAVE  = 4;  // nothing heard from the slave
+const uint8_t       ALARMS       = 5;
+const q16           ALARM_LOW_RISE     = q16(2.0);  // A breath rises this over PEEP (cmH20)
+const unsigned long ALARM_LOW_TIME     = 15000;     // Longest without one (ms), 5 bpm is 12 s
+const unsigned long ALARM_SENSOR_TIME  = 1000;      // Longest without a sample (ms)
+const unsigned long ALARM_SLAVE_TIME   = 25000;     // Longest without a reply (ms)
+const uint8_t       ALARM_PRIORITY_HIGH   = 1;
+const uint8_t       ALARM_PRIORITY_MEDIUM = 2;
+const unsigned int  ALARM_TONE_HIGH       = 880;  // Hz
+const unsigned int  ALARM_TONE_MEDIUM     = 660;  // Hz
+const int           ALARM_X               = 385;  // display px, right of the longest heading
+const int           ALARM_Y               = 1;    // display px, above the chart
+const int           ALARM_WIDTH           = 95;   // display px, the longest name
+const int           ALARM_HEIGHT          = 18;   // display px
+
+// what each alarm is, fixed for the life of the sketch, in flash
+struct alarmLayout {
+    uint8_t
+        raise,     // checks in a row the condition holds for to raise
+        clear,     // checks in a row it's gone for to end
+        priority,  // ALARM_PRIORITY_HIGH or ALARM_PRIORITY_MEDIUM
+        latching;  // stays up once its condition is gone till acknowledged
+    char
+        name[7];  // as shown
+};
+
+struct alarmState {
+    uint8_t
+        count;  // checks in a row the condition has held, or been gone
+    bool
+        active,   // the condition is there, debounced
+        latched;  // raised, and not yet acknowledged
+    unsigned long
+        since,       // first sample or check of the condition (us)
+        raised,      // times raised
+        latency,     // first sample or check to tone, last time (us)
+        latencyMax;  // and the longest
+};
+
+// the tone patterns are on and off times in 10 ms, ending at 0 and repeating.
+// high is ten pulses in bursts of 3 and 2, medium three, as IEC 60601-1-8
+struct alarmEngine {
+    uint16_t
+        cursor;  // next sample to take from the pressure ring
+    unsigned long
+        aboveLow,  // last sample ALARM_LOW_RISE over the measured PEEP (us)
+        sampled,   // last sample taken (us)
+        stepAt;    // when the pattern moves to its next step (ms)
+    int8_t
+        sounding,  // alarm the pattern is for, -1 for none
+        shown;     // alarm on the screen, -1 for none
+    bool
+        shownActive;  // whether it was shown as active or only latched
+    uint8_t
+        step;  // in the pattern
+    const uint8_t
+        *pattern;
+    alarmState
+        alarm[ALARMS];
+};
+
+alarmEngine alarms;
+
+// starts every alarm clear from now, with a sensor that reported itself
+// saturated or failed in setup() already raised
+void alarmBegin();
+
+// take every new sample through the pressure alarms, check the rest and step
+// the tone. call at least as often as the sensor rate
+void alarmUpdate();
+
+// one check of one alarm's condition, at the time it was first seen in us
+void alarmCheck(uint8_t id, bool condition, unsigned long at);
+
+// puts an alarm up and sounds it if it's now the most urgent
+void alarmRaise(uint8_t id);
+
+// ends every latched alarm whose condition has gone
+void alarmAcknowledge();
+
+// the most urgent alarm up, -1 for none
+int8_t alarmTop();
+
+// starts, changes or stops the tone for the most urgent alarm, and moves the
+// pattern on when its step is up
+void alarmSound();
+
+// shows the most urgent alarm by name in the top right, active in the error
+// colour and latched in the latched colour. only draws when that changes
+void alarmShow();
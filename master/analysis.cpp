@@ -0,0 +1,88 @@
+// ! Breath Analysis Implementation ! ==========================================
+
+#include "analysis.h"
+
+q16 median3(q16 a, q16 b, q16 c) {
+    if (a > b) {
+        q16 t = a;
+        a     = b;
+        b     = t;
+    }
+    if (b > c)
+        b = c;
+    return a > b ? a : b;
+}
+
+void analysisBegin() {
+    analyser *a = &analysis;
+    a->cursor   = mprls.head;
+    a->raw[0] = a->raw[1] = a->raw[2] = getAirway();
+    a->filtered = a->previous = a->base = a->raw[2];
+    a->phase                            = 0;
+}
+
+void analysisUpdate() {
+    sample s;
+    while (pressureRead(&analysis.cursor, &s))
+        analysisSample(s.cmH20);
+}
+
+void analysisSample(q16 p) {
+    analyser *a = &analysis;
+
+    // the median drops single sample spikes, the low pass takes off the noise
+    a->raw[0]   = a->raw[1];
+    a->raw[1]   = a->raw[2];
+    a->raw[2]   = p;
+    a->previous = a->filtered;
+    a->filtered += (median3(a->raw[0], a->raw[1], a->raw[2]) - a->filtered) / 2;
+    q16 f       = a->filtered;
+    q16 slope   = f - a->previous;
+
+    if (a->phase == 0) {
+        // follow the pressure down quickly but up only slowly, so a slow
+        // inhale can't drag the end expiratory level up with it
+        if (f < a->base)
+            a->base += (f - a->base) / 4;
+        else
+            a->base += (f - a->base) / 64;
+        if (f > a->base + ANALYSIS_TRIGGER) {
+            a->phase   = 1;
+            a->peep    = a->base;
+            a->peak    = f;
+            a->plateau = f;
+            a->flat    = 0;
+        }
+        return;
+    }
+
+    // a slow inhale can rise by less than ANALYSIS_FLAT a sample, so only
+    // samples that stop making a new peak count towards the plateau
+    if (f > a->peak) {
+        a->peak = f;
+        a->flat = 0;
+    } else if (slope < ANALYSIS_FLAT && slope > -ANALYSIS_FLAT) {
+        if (a->flat < ANALYSIS_FLAT_SAMPLES)
+            a->flat++;
+    } else {
+        a->flat = 0;
+    }
+
+    if (a->phase == 1 && a->flat == ANALYSIS_FLAT_SAMPLES) {
+        a->phase   = 2;
+        a->plateau = f;
+    }
+    if (a->phase == 2 && a->flat)
+        a->plateau += (f - a->plateau) / 4;
+
+    if (f < a->base + (a->peak - a->base) / 2) {
+        // a breath that never held still has no plateau, show its peak
+        cmH20.peak    = a->peak;
+        cmH20.plateau = a->phase == 2 ? a->plateau : a->peak;
+        cmH20.peep    = a->peep;
+        a->base       = f;  // tracks the fall from here, so it can't retrigger
+        a->phase      = 0;
+        a->done       = true;
+        a->breaths++;
+    }
+}
@@ -0,0 +1,50 @@
+// ! Breath Analysis ! =========================================================
+
+#pragma once
+#include "fixed.h"
+#include "pressure.h"
+
+// a breath is found from the airway pressure alone: a rise of TRIGGER over the
+// end expiratory level starts the inhale, FLAT_SAMPLES samples that move less
+// than FLAT each turn it into the plateau, and falling back past halfway
+// between the peak and the end expiratory level ends the breath
+const q16     ANALYSIS_TRIGGER      = q16(2.0);  // Inhale detect (cmH20)
+const q16     ANALYSIS_FLAT         = q16(0.1);  // Plateau slope (cmH20/sample)
+const uint8_t ANALYSIS_FLAT_SAMPLES = 5;         // Plateau detect (samples)
+
+typedef struct {
+    uint8_t
+        phase,  // 0 = exhaling, 1 = inhaling, 2 = plateau
+        flat;   // consecutive samples inside ANALYSIS_FLAT
+    uint16_t
+        cursor;  // next sample to take from the pressure ring
+    q16
+        raw[3],    // last three samples for the median
+        filtered,  // median, then a first order low pass
+        previous,  // filtered value one sample ago
+        base,      // end expiratory level, tracked while exhaling
+        peak,      // highest filtered value this breath
+        plateau,   // level once the pressure stops moving this breath
+        peep;      // end expiratory level the breath started from
+    bool
+        done;  // a breath finished and cmH20 holds its results
+    unsigned long
+        breaths;  // breaths analysed
+} analyser;
+
+analyser analysis;
+
+// start from the current airway pressure as the end expiratory level
+void analysisBegin();
+
+// take every new sample from the pressure ring through the analyser, looping
+// over only those that came in since the last call. each one is a fixed
+// handful of compares, adds and power of two divides, so the cost per sample
+// is bounded whatever the phase
+void analysisUpdate();
+
+// one sample through the filter and the phase tracker
+void analysisSample(q16 cmH20);
+
+// middle of three values
+q16 median3(q16 a, q16 b, q16 c);
@@ -0,0 +1,80 @@
+// ! Implementation of animation ! =============================================
+
+#include "animation.h"
+
+sweep *sweepFor(dial *d) {
+    animator *a = &animation;
+    for (uint8_t i = 0; i < a->count; i++)
+        if (a->sweeps[i].d == d)
+            return &a->sweeps[i];
+    if (a->count == ANIMATION_DIALS)
+        return 0;
+    sweep *s = &a->sweeps[a->count++];
+    s->d     = d;
+    return s;
+}
+
+// a dial past its table's size is drawn straight away, as before
+void animateTo(dial *d, q16 reading) {
+    sweep *s = sweepFor(d);
+    if (!s) {
+        d->current = reading;
+        updateCurrentByReading(d);
+        drawCurrentElements(d);
+        return;
+    }
+    s->from   = d->current;
+    s->to     = reading;
+    s->start  = millis();
+    s->moving = true;
+}
+
+q16 animationTo(dial *d) {
+    animator *a = &animation;
+    for (uint8_t i = 0; i < a->count; i++)
+        if (a->sweeps[i].d == d)
+            return a->sweeps[i].to;
+    return d->current;
+}
+
+// the fraction of the way along is taken first, so the step times it fits
+// Q15.16 whatever the span
+q16 sweepValue(const sweep *s, unsigned long now) {
+    unsigned long elapsed = now - s->start;
+    if (elapsed >= ANIMATION_TIME)
+        return s->to;
+    q16 along = q16(int(elapsed)) / int(ANIMATION_TIME);
+    return s->from + (s->to - s->from) * along;
+}
+
+void animationFrame() {
+    animator     *a     = &animation;
+    unsigned long start = micros();
+    bool          drew  = false;
+
+    for (uint8_t n = 0; n < a->count; n++) {
+        uint8_t i = a->next + n;
+        if (i >= a->count)
+            i -= a->count;
+        sweep *s = &a->sweeps[i];
+        if (!s->moving)
+            continue;
+        if (drew && micros() - start >= ANIMATION_BUDGET) {
+            a->next = i;
+            a->deferred++;
+            break;
+        }
+
+        dial *d    = s->d;
+        d->current = sweepValue(s, millis());
+        s->moving  = d->current != s->to;
+        if (!s->moving && flashRead(&d->layout->derived))
+            updateCurrentByValue(d);
+        else
+            updateCurrentByReading(d);
+        drawCurrentElements(d);
+        drew = true;
+    }
+    if (drew)
+        a->frames++;
+}
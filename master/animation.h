@@ -0,0 +1,59 @@
+// ! Current Needle Animation ! ================================================
+
+#pragma once
+#include "dial.h"
+#include "fixed.h"
+#include "scheduler.h"
+#include "util.h"
+
+// a new reading doesn't jump a dial's current needle and value, it's handed
+// to animateTo() and the needle sweeps there from wherever it's shown now
+// over ANIMATION_TIME. animationFrame() runs every ANIMATION_FRAME and draws
+// each moving dial where it should be at that moment, so a frame that runs
+// late, or a release the scheduler drops, lands in the right place and the
+// frames in between are never drawn. a frame draws one dial whatever, and
+// starts no more once it has spent ANIMATION_BUDGET, the rest go first next
+// frame, so a frame is the 4 ms budget plus one dial at most. no frame has
+// reached the budget in cosim, the worst took 2.1 ms under cosim -a's alarms
+const uint8_t       ANIMATION_DIALS  = 6;      // Most dials moving at once
+const unsigned long ANIMATION_TIME   = 500;    // A sweep from reading to reading (ms)
+const unsigned long ANIMATION_FRAME  = 40000;  // Frame period (us), 25 a second
+const unsigned long ANIMATION_BUDGET = 4000;   // Drawing a frame may start dials in (us)
+
+struct sweep {
+    dial *d;
+    q16
+        from,  // shown as the sweep started
+        to;    // the reading
+    unsigned long
+        start;  // ms
+    bool
+        moving;
+};
+
+struct animator {
+    sweep
+        sweeps[ANIMATION_DIALS];
+    uint8_t
+        count,  // sweeps in use, one per dial ever animated
+        next;   // first to draw in the next frame
+    unsigned long
+        frames,    // frames that drew something
+        deferred;  // frames the budget ran out in
+};
+
+animator animation;
+
+// start the dial's current needle and value toward a reading from where they
+// are shown now. a derived dial shows its range error once it gets there
+void animateTo(dial *d, q16 reading);
+
+// the reading a dial's current is going to, or its current if it has none
+q16 animationTo(dial *d);
+
+// draws every moving dial at its place for now, round robin within the
+// budget. the animate task
+void animationFrame();
+
+// the value a sweep shows at now, ms
+q16 sweepValue(const sweep *s, unsigned long now);
@@ -0,0 +1,73 @@
+// ! Implementation of baseline ! ==============================================
+
+#include "baseline.h"
+
+void baselineBegin() {
+    baselineState *b = &baseline;
+    eeprom_read_block(&b->record, (const void *)BASELINE_ADDRESS, sizeof(b->record));
+    b->cached = b->record.check == ~b->record.atmosphere;
+
+    if (b->cached) {
+        cmH20.atmosphere = q16::fromRaw(b->record.atmosphere);
+    } else {
+        // atmosphere is still 0 here, so the sample is absolute
+        uint16_t cursor = mprls.head;
+        sample   s;
+        pressureBegin();
+        while (!pressureRead(&cursor, &s)) {
+            i2cUpdate();
+            pressureUpdate();
+        }
+        i2cFlush();
+        cmH20.atmosphere = s.cmH20;
+        b->taken         = 1;
+
+        // readers start from the newest sample, which is the atmosphere
+        mprls.ring[uint8_t(mprls.head - 1) % PRESSURE_SAMPLES].cmH20 = q16();
+    }
+    b->mean   = cmH20.atmosphere;
+    b->cursor = mprls.head;
+}
+
+// every sample since the last run was made with the atmosphere as it is now
+void baselineUpdate() {
+    baselineState *b = &baseline;
+    sample         s;
+    if (b->settled) {
+        baselineSave();
+        return;
+    }
+
+    q16 atmosphere = cmH20.atmosphere;
+    while (pressureRead(&b->cursor, &s)) {
+        q16 absolute = s.cmH20 + atmosphere;
+        q16 off      = absolute - b->mean;
+        if (b->taken >= BASELINE_TRUSTED && (off > BASELINE_BAND || -off > BASELINE_BAND))
+            continue;
+        b->taken++;
+        b->mean += off / b->taken;
+    }
+    cmH20.atmosphere = b->mean;
+
+    if (b->taken < BASELINE_SAMPLES && analysis.phase == 0)
+        return;
+    b->settled   = true;
+    b->settledAt = millis();
+    b->saved     = sizeof(b->record);
+
+    q16 change = b->mean - q16::fromRaw(b->record.atmosphere);
+    if (!b->cached || change > BASELINE_SAVE || -change > BASELINE_SAVE) {
+        b->record.atmosphere = b->mean.raw();
+        b->record.check      = ~b->record.atmosphere;
+        b->saved             = 0;
+    }
+}
+
+void baselineSave() {
+    baselineState *b = &baseline;
+    while (b->saved < sizeof(b->record) && eeprom_is_ready()) {
+        eeprom_update_byte((uint8_t *)BASELINE_ADDRESS + b->saved,
+                           ((const uint8_t *)&b->record)[b->saved]);
+        b->saved++;
+    }
+}
@@ -0,0 +1,63 @@
+// ! Atmosphere Baseline ! =====================================================
+
+#pragma once
+#include <avr/eeprom.h>
+#include "analysis.h"
+#include "fixed.h"
+#include "logger.h"
+#include "pressure.h"
+
+// airway pressure is the sensor's absolute reading less the atmosphere. the
+// last boot's atmosphere is kept in EEPROM and used from the first sample on,
+// or the first sample itself if nothing good is kept. it's then refined as a
+// running mean of the samples that sit still, the first BASELINE_TRUSTED
+// taken whatever they read so a stale cache is pulled in straight away, and
+// after that only those inside BASELINE_BAND of the mean so far. it settles
+// at BASELINE_SAMPLES, or at the first breath as the airway isn't at
+// atmosphere after that. a settled value more than BASELINE_SAVE off the
+// cached one is written back a byte at a time whenever the EEPROM is free, so
+// nothing waits on a write
+const uint8_t BASELINE_SAMPLES = 100;        // Most samples in the mean
+const uint8_t BASELINE_TRUSTED = 4;          // Taken whatever they read
+const q16     BASELINE_BAND    = q16(0.5);   // Off the mean to still count (cmH20)
+const q16     BASELINE_SAVE    = q16(0.1);   // Change worth a write (cmH20)
+const int     BASELINE_ADDRESS = 0;          // EEPROM offset of the record
+
+// the check is the value inverted, so blank or torn EEPROM doesn't pass
+struct baselineRecord {
+    int32_t
+        atmosphere,  // raw q16 (cmH20)
+        check;
+};
+
+struct baselineState {
+    bool
+        cached,   // the boot started from a good record
+        settled;  // refining is over
+    uint8_t
+        taken,  // samples in the mean
+        saved;  // bytes of record written back, sizeof(record) when done
+    uint16_t
+        cursor;  // next sample to take from the pressure ring
+    q16
+        mean;  // of the samples taken, absolute (cmH20)
+    unsigned long
+        settledAt;  // ms
+    baselineRecord
+        record;  // as read, then as being written
+};
+
+baselineState baseline;
+
+// reads the EEPROM record into cmH20.atmosphere. without a good one it waits
+// out a single conversion and takes that instead, call with sampling stopped
+// before pressureBegin()
+void baselineBegin();
+
+// take every new sample into the mean, keep cmH20.atmosphere on it and write
+// the result back once settled. call after analysisUpdate() so the first
+// breath is seen as it starts
+void baselineUpdate();
+
+// one step of writing the record back, at most one byte that changes
+void baselineSave();
@@ -0,0 +1,75 @@
+// ! Implementation of chart ! =================================================
+
+#include "chart.h"
+
+int16_t chartRow(q16 cmH20) {
+    int16_t row = (cmH20 / CHART_SCALE).round();
+    if (row < 0)
+        return 0;
+    if (row >= CHART_HEIGHT)
+        return CHART_HEIGHT - 1;
+    return row;
+}
+
+// rows count up from the bottom, the display counts down from the top
+int chartY(int16_t row) {
+    return CHART_Y + CHART_HEIGHT - 1 - row;
+}
+
+void chartBegin(q16 peep, q16 peak) {
+    strip *s  = &chart;
+    s->cursor = mprls.head;
+    s->taken  = 0;
+    s->column = 0;
+    s->low    = CHART_HEIGHT;
+    s->high   = -1;
+    s->last   = chartRow(getAirway());
+    chartReference(peep, peak);
+
+    display.fillRect(CHART_X, CHART_Y, CHART_WIDTH, CHART_HEIGHT, c.chart);
+    display.drawFastHLine(CHART_X, chartY(s->peepRow), CHART_WIDTH, c.target);
+    display.drawFastHLine(CHART_X, chartY(s->peakRow), CHART_WIDTH, c.target);
+}
+
+void chartReference(q16 peep, q16 peak) {
+    chart.peepRow = chartRow(peep);
+    chart.peakRow = chartRow(peak);
+}
+
+void chartUpdate() {
+    strip *s = &chart;
+    sample one;
+    while (pressureRead(&s->cursor, &one)) {
+        int16_t row = chartRow(one.cmH20);
+        if (row < s->low)
+            s->low = row;
+        if (row > s->high)
+            s->high = row;
+        if (++s->taken < CHART_SAMPLES)
+            continue;
+        chartColumn();
+        s->last  = row;
+        s->taken = 0;
+        s->low   = CHART_HEIGHT;
+        s->high  = -1;
+    }
+}
+
+// the span runs from the last column's end, so a steep edge stays joined up
+void chartColumn() {
+    strip  *s     = &chart;
+    int     x     = CHART_X + s->column;
+    int16_t ahead = s->column + CHART_GAP;
+    int16_t low   = s->low < s->last ? s->low : s->last;
+    int16_t high  = s->high > s->last ? s->high : s->last;
+    if (ahead >= CHART_WIDTH)
+        ahead -= CHART_WIDTH;
+
+    display.drawFastVLine(CHART_X + ahead, CHART_Y, CHART_HEIGHT, c.chart);
+    display.drawPixel(x, chartY(s->peepRow), c.target);
+    display.drawPixel(x, chartY(s->peakRow), c.target);
+    display.drawFastVLine(x, chartY(high), high - low + 1, c.current);
+
+    if (++s->column == CHART_WIDTH)
+        s->column = 0;
+}
@@ -0,0 +1,55 @@
+// ! Pressure Strip Chart ! ====================================================
+
+#pragma once
+#include "dial.h"
+#include "fixed.h"
+#include "pressure.h"
+
+// airway pressure against time along the top of the screen, between the mode
+// heading and the dials. a cursor sweeps left to right and wraps, and every
+// CHART_SAMPLES samples it draws one column where it is: the two reference
+// rows, then one vertical span from where the trace left the last column to
+// the low and high of the samples in this one. the column CHART_GAP ahead of
+// the cursor is cleared at the same time, so the oldest trace is wiped just
+// before it's written over and the chart is never repainted. a column is the
+// same four bus windows whatever the pressure does
+const int     CHART_X       = 5;    // display px
+const int     CHART_Y       = 19;   // display px, clear of the heading's descenders
+const int     CHART_WIDTH   = 470;  // columns
+const int     CHART_HEIGHT  = 20;   // rows
+const int     CHART_GAP     = 4;    // blank columns ahead of the cursor
+const uint8_t CHART_SAMPLES = 2;    // Samples per column, 9.4 s across at 100 Hz
+const int     CHART_SCALE   = 2;    // cmH20 per row, 0 to 40 top to bottom
+
+struct strip {
+    uint16_t
+        cursor;  // next sample to take from the pressure ring
+    uint8_t
+        taken;  // samples in the column so far
+    int16_t
+        column,   // where the next column goes, from CHART_X
+        low,      // lowest row in the column so far
+        high,     // highest
+        last,     // row the trace left the last column at
+        peepRow,  // reference rows
+        peakRow;
+};
+
+strip chart;
+
+// the row of a pressure, 0 at the bottom, clamped to the chart
+int16_t chartRow(q16 cmH20);
+
+// clears the chart and starts the cursor at the left from the newest sample
+void chartBegin(q16 peep, q16 peak);
+
+// moves the reference rows, the chart picks them up from the next column on
+void chartReference(q16 peep, q16 peak);
+
+// take every new sample from the pressure ring, and draw each column they
+// finish. a chart that has fallen behind is caught up to by the ring's own
+// skipping, so a call draws no more than PRESSURE_SAMPLES / CHART_SAMPLES
+void chartUpdate();
+
+// one column at the cursor, and the one CHART_GAP ahead cleared
+void chartColumn();
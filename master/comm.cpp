@@ -2,85 +2,279 @@
 
 #include "comm.h"
 
-bool breathReady() {
-    if ((t.current - t.previous) >= 1000) {
-        t.previous    = t.current;
-        sweepRequired = true;  // resets within updateSweeps() after an update
-                               // required for better update handling
-        return true;
+// every changed setting goes in one frame. a frame that isn't acked is sent
+// again with the same sequence number on the next pass, and after
+// FRAME_RETRIES attempts the link backs off before it starts over
+void openHailingFrequency() {
+    commandUpdate();
+    if (slaveLink.busy || long(t.current - slaveLink.holdoff) < 0)
+        return;
+
+    frame *f = &outgoing;
+    frameBegin(f);
+    if (volumeChanged()) { frameAdd(f, field.volume, send.volume); }
+    if (inhaleChanged()) { frameAdd(f, field.inhale, send.inhale); }
+    if (bpmChanged()) { frameAdd(f, field.bpm, send.bpm); }
+    if (modeChanged()) { frameAdd(f, field.mode, send.mode); }
+    if (peakChanged()) { frameAdd(f, field.peak, send.peak); }
+    upload.framed = CURVE_POINTS;
+    if (f->fields == 0 && uploadWanted()) { uploadAdd(f); }
+    if (f->fields == 0)
+        return;
+
+    if (slaveLink.attempts++ == 0) {
+        slaveLink.seq++;
+        slaveLink.frames++;
+        slaveLink.started = micros();
     } else {
-        return false;
+        slaveLink.retries++;
     }
-}
+    frameEnd(f, slaveLink.seq);
+    framed = send;
 
-void openHailingFrequency() {
-    commandUpdate();
-    if (volumeChanged()) { messenger(send.volume); }
-    if (inhaleChanged()) { messenger(send.inhale); }
-    if (bpmChanged()) { messenger(send.bpm); }
+    if (!messenger(f))
+        frameDone(0);
 }
 
 void commandUpdate() {
+    send.mode = select.mode;  // the selector applies straight away
     if (digitalRead(enc1buttonPin) == LOW) {
         setVolumeCommand();  // sets value for command to send current volume
         setInhaleCommand();  // sets value for command to send current inhale
         setBpmCommand();
+        setPeakCommand();
     }
 }
 
-void messenger(uint8_t command) {
-    Wire.beginTransmission(SLAVE_ADDR);
-    Wire.write(command);
-    Wire.endTransmission();
+bool messenger(frame *f) {
+    slaveLink.busy = i2cWrite(SLAVE_ADDR, f->data, f->length, frameSent);
+    return slaveLink.busy;
+}
 
-    uint8_t response;
-    Wire.requestFrom(SLAVE_ADDR, ANSWER_SIZE);
-    while (Wire.available()) {
-        response = Wire.read();
+void frameSent(const i2cTransfer *x) {
+    if (x->status != I2C_OK || !i2cRead(SLAVE_ADDR, REPLY_SIZE, frameReplied))
+        frameDone(0);
+}
+
+void frameReplied(const i2cTransfer *x) {
+    frameDone(x->status == I2C_OK ? readReply(x->data, slaveLink.seq) : 0);
+}
+
+void frameDone(uint8_t status) {
+    slaveLink.busy = false;
+    if (status == responseList[0]) {
+        sent               = framed;
+        slaveLink.attempts = 0;
+        if (upload.framed < CURVE_POINTS)
+            uploadAcked();
+        slaveLink.acked++;
+        slaveLink.latency = micros() - slaveLink.started;
+        if (slaveLink.latency > slaveLink.latencyMax)
+            slaveLink.latencyMax = slaveLink.latency;
+        LOG_INFO(FRAME_ACKED, slaveLink.seq, outgoing.fields, slaveLink.latency);
+        return;
     }
 
-    Serial.println("command: " + String(command));
-    Serial.println("response: " + String(response));
+    if (status != 0)
+        slaveLink.rejected++;
+    if (slaveLink.attempts >= FRAME_RETRIES) {
+        slaveLink.attempts = 0;
+        slaveLink.holdoff  = t.current + FRAME_BACKOFF;
+        slaveLink.failed++;
+        LOG_WARN(FRAME_FAILED, slaveLink.seq);
+    }
 }
 
-bool volumeChanged() {
-    sendVolumeCurrent = send.volume;
-    if (sendVolumeCurrent != sendVolumePrevious) {
-        sendVolumePrevious = sendVolumeCurrent;
-        return true;
-    } else {
+// a breath seen while a frame is in flight is polled for once it's done
+void pollSlave() {
+    if (analysis.done || t.current - slaveLink.polled >= POLL_TIMEOUT)
+        slaveLink.pollDue = true;
+    if (!slaveLink.pollDue || slaveLink.busy)
+        return;
+    slaveLink.polled  = t.current;
+    slaveLink.pollDue = false;
+    slaveLink.polls++;
+    slaveLink.busy = i2cRead(SLAVE_ADDR, REPLY_SIZE, pollReplied);
+    if (!slaveLink.busy)
+        slaveLink.pollsFailed++;
+}
+
+void pollReplied(const i2cTransfer *x) {
+    slaveLink.busy = false;
+    if (x->status != I2C_OK || readReply(x->data, -1) == 0)
+        slaveLink.pollsFailed++;
+}
+
+uint16_t replyWord(const uint8_t *reply) {
+    return reply[0] | reply[1] << 8;
+}
+
+uint8_t readReply(const uint8_t *reply, int seq) {
+    if (reply[0] != FRAME_START || (seq >= 0 && reply[1] != seq) ||
+        reply[REPLY_SIZE - 1] != crc8(reply, REPLY_SIZE - 1))
+        return 0;
+
+    slaveLink.heard        = t.current;
+    const uint8_t *block   = reply + 3;
+    delivered.state        = block[0];
+    delivered.volume       = replyWord(block + 1);
+    delivered.inhalePeriod = replyWord(block + 3);
+    delivered.cyclePeriod  = replyWord(block + 5);
+    delivered.inhaleTime   = replyWord(block + 7);
+    delivered.exhaleTime   = replyWord(block + 9);
+    delivered.cycleTime    = replyWord(block + 11);
+    delivered.cycles       = replyWord(block + 13);
+    delivered.curve        = replyWord(block + 15);
+    return reply[2];
+}
+
+// * CURVE UPLOAD ==============================================================
+
+void uploadBegin() {
+    upload.check  = curveCheck(upload.steps);
+    upload.framed = CURVE_POINTS;
+}
+
+// nothing is known of the slave's curve till it's been heard from, and after
+// a commit the reply to it still has the old one
+bool uploadWanted() {
+    if (slaveLink.heard == 0 || delivered.curve == upload.check)
         return false;
+    if (upload.committed) {
+        if (delivered.cycles == upload.cycles)
+            return false;
+        upload.committed = false;
     }
+    return upload.uploads < CURVE_UPLOADS;
 }
 
-bool inhaleChanged() {
-    sendInhaleCurrent = send.inhale;
-    if (sendInhaleCurrent != sendInhalePrevious) {
-        sendInhalePrevious = sendInhaleCurrent;
-        return true;
-    } else {
-        return false;
+// points past the end of the curve go as 0
+void uploadAdd(frame *f) {
+    if (upload.next == 0 && slaveLink.attempts == 0)
+        LOG_INFO(CURVE_UPLOAD, upload.check, delivered.curve);
+    frameAdd(f, field.curve, upload.next);
+    for (uint8_t i = upload.next; i < upload.next + CURVE_CHUNK; i++) {
+        uint16_t steps       = i < CURVE_POINTS ? flashRead(upload.steps + i) : 0;
+        f->data[f->length++] = steps & 0xFF;
+        f->data[f->length++] = steps >> 8;
     }
+    if (upload.next + CURVE_CHUNK >= CURVE_POINTS)
+        frameAdd(f, field.curveCommit, upload.check);
+    upload.framed = upload.next;
 }
 
-bool bpmChanged() {
-    sendBpmCurrent = send.bpm;
-    if (sendBpmCurrent != sendBpmPrevious) {
-        sendInhalePrevious = sendInhaleCurrent;
-        return true;
-    } else {
-        return false;
+void uploadAcked() {
+    upload.next = upload.framed + CURVE_CHUNK;
+    if (upload.next < CURVE_POINTS)
+        return;
+    upload.next      = 0;
+    upload.committed = true;
+    upload.cycles    = delivered.cycles;
+    upload.uploads++;
+    LOG_INFO(CURVE_COMMITTED, upload.check, upload.uploads);
+}
+
+// Fletcher-16 over the points little endian, the sums kept under 255 by
+// subtracting so there's no divide
+uint16_t curveCheck(const uint16_t *steps) {
+    uint16_t a = 0, b = 0;
+    for (uint8_t i = 0; i < CURVE_POINTS; i++) {
+        uint16_t point    = flashRead(steps + i);
+        uint8_t  bytes[2] = {uint8_t(point), uint8_t(point >> 8)};
+        for (uint8_t n = 0; n < 2; n++) {
+            a += bytes[n];
+            if (a >= 255)
+                a -= 255;
+            b += a;
+            if (b >= 255)
+                b -= 255;
+        }
     }
+    return b << 8 | a;
+}
+
+// * FRAMES ====================================================================
+
+// start, seq and field count come first, seq and count are filled in by
+// frameEnd()
+void frameBegin(frame *f) {
+    f->data[0] = FRAME_START;
+    f->length  = 3;
+    f->fields  = 0;
+}
+
+void frameAdd(frame *f, uint8_t type) {
+    f->data[f->length++] = type;
+    f->fields++;
+}
+
+void frameAdd(frame *f, uint8_t type, uint8_t value) {
+    frameAdd(f, type);
+    f->data[f->length++] = value;
 }
 
+void frameAdd(frame *f, uint8_t type, uint16_t value) {
+    frameAdd(f, type);
+    f->data[f->length++] = value & 0xFF;
+    f->data[f->length++] = value >> 8;
+}
+
+void frameEnd(frame *f, uint8_t seq) {
+    f->data[1]         = seq;
+    f->data[2]         = f->fields;
+    f->data[f->length] = crc8(f->data, f->length);
+    f->length++;
+}
+
+// CRC-8, polynomial 0x07, bit at a time. frames are a dozen bytes so a table
+// isn't worth the flash
+uint8_t crc8(const uint8_t *data, uint8_t length) {
+    uint8_t crc = 0;
+    while (length--) {
+        crc ^= *data++;
+        for (uint8_t i = 0; i < 8; i++)
+            crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
+
+// * SETTINGS ==================================================================
+
+bool volumeChanged() {
+    return send.volume != sent.volume;
+}
+
+bool inhaleChanged() {
+    return send.inhale != sent.inhale;
+}
+
+bool bpmChanged() {
+    return send.bpm != sent.bpm;
+}
+
+bool modeChanged() {
+    return send.mode != sent.mode;
+}
+
+bool peakChanged() {
+    return send.peak != sent.peak;
+}
+
+// settings are rounded rather than truncated, as 0.4 L in float came out at
+// 399.99 mL and sent the setting one increment low
 void setVolumeCommand() {
-    send.volume = (50.0 * volume.target) + 10.0;
+    send.volume = (volume.target * 1000).round();
 }
 
 void setInhaleCommand() {
-    send.inhale = (20.0 * inhale.target) + 40.0;
+    send.inhale = (inhale.target * 1000).round();
 }
 
 void setBpmCommand() {
-    send.bpm = 72 + bpm.target;
-}
\ No newline at end of file
+    send.bpm = bpm.target.round();
+}
+
+// the 0.5 cmH20 increments are exact in 1/256ths
+void setPeakCommand() {
+    send.peak = peak.target.raw() >> 8;
+}
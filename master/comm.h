@@ -1,18 +1,34 @@
 // ! Master <--> Slave communicaiton ! =========================================
 
 #pragma once
-#include <Wire.h>
-
-const uint8_t SLAVE_ADDR  = 9;                // Address of slave motor
-const uint8_t ANSWER_SIZE = sizeof(uint8_t);  // Bytes of transmission
-
-uint8_t
-    sendVolumePrevious,
-    sendVolumeCurrent,
-    sendInhalePrevious,
-    sendInhaleCurrent,
-    sendBpmPrevious,
-    sendBpmCurrent;
+#include "curve.h"
+#include "i2c.h"
+#include "logger.h"
+#include "util.h"
+
+// settings go to the slave as one frame per change, answered by a reply that
+// acks the frame and carries the slave's status block
+//
+//   frame  [START][seq][fields][type value]...[crc]
+//   reply  [START][seq][status][telemetry][crc]
+//
+// values are little endian and the CRC-8 (poly 0x07) covers every byte before
+// it. the slave checks the whole frame before it takes any of it, so a frame
+// is either applied or rejected as a unit. values are absolute, which makes a
+// retried frame safe to apply twice. a read on its own returns the reply to the
+// last frame with the block as it is now, which is how the master polls.
+// frames, replies and polls all go through the I2C queue one at a time, and
+// finish in their callbacks
+
+const uint8_t SLAVE_ADDR     = 9;                       // Address of slave motor
+const uint8_t FRAME_START    = 0xA5;                    // First byte of every frame and reply
+const uint8_t FRAME_SIZE     = 32;                      // Largest frame, the Wire buffer
+const uint8_t TELEMETRY_SIZE = 17;                      // Bytes of the status block
+const uint8_t REPLY_SIZE     = 3 + TELEMETRY_SIZE + 1;  // Bytes of a reply
+const uint8_t FRAME_RETRIES  = 3;                       // Attempts before a frame is given up
+const int     FRAME_BACKOFF  = 1000;                    // Wait after giving up (ms)
+const int     POLL_TIMEOUT   = 10000;                   // Longest gap between polls (ms)
+const uint8_t MODE_PRESSURE  = 3;                       // Selector mode for pressure control
 
 uint8_t responseList[] = {
     1,   // valid
@@ -21,7 +37,9 @@ uint8_t responseList[] = {
     19   // finished
 };
 
-typedef struct commands {
+// field types. the old single byte commands keep their codes and carry no
+// value, settings carry a value of fixed size
+struct fields {
     uint8_t
         ready,
         cancel,
@@ -32,8 +50,12 @@ typedef struct commands {
         sigh,
         volume,
         inhale,
-        bpm;
-    commands()
+        bpm,
+        mode,
+        curve,
+        curveCommit,
+        peak;
+    fields()
         : ready{3}         // ready for breath
         , cancel{4}        // cancel breath part way
         , enable{5}        // enable motor
@@ -41,23 +63,155 @@ typedef struct commands {
         , volumeMode{7}    // volume controlled mode
         , pressureMode{8}  // pressure controlled mode
         , sigh{9}          // sigh performed every hour
-        , volume{35}       // range of 20 - 50, +1 = 1 INC (default 0.5 L)
-        , inhale{80}       // range of 50 - 80, +1 = 1 INC (default 2.0 s)
-        , bpm{84}          // range of 80 - 115, +1 equals 1 bpm (default 12)
+        , volume{20}       // uint16, tidal volume in mL
+        , inhale{21}       // uint16, inhale time in ms
+        , bpm{22}          // uint8, breaths per minute
+        , mode{23}         // uint8, selector mode 1 - 4
+        , curve{24}        // uint8 first point, 4 x uint16 steps
+        , curveCommit{25}  // uint16, check of the curve sent
+        , peak{26}         // uint16, peak target in 1/256 cmH20
     {}
 };
 
-struct commands send;
+struct fields field;
 
-// placeholder until i2c communication with slave is implimented
-bool breathReady();
+// settings as the slave wants them, whole mL and ms, and the peak in 1/256
+// cmH20
+struct settings {
+    uint16_t
+        volume,
+        inhale,
+        peak;
+    uint8_t
+        bpm,
+        mode;
+};
+
+// send starts at the dial defaults and sent at nothing, so the first pass
+// hands the slave every setting. framed is send as it was put in the frame
+// in flight
+struct settings send = {500, 2000, 30 * 256, 12, 0};
+struct settings sent;
+struct settings framed;
+
+// the slave's status block, what it last delivered rather than what was set
+struct telemetry {
+    uint8_t
+        state;  // 0 = resting, 1 = inhaling, 2 = exhaling
+    uint16_t
+        volume,        // applied volume (mL)
+        inhalePeriod,  // applied inhale period (ms)
+        cyclePeriod,   // applied cycle period (ms)
+        inhaleTime,    // measured last inhale (ms)
+        exhaleTime,    // measured last exhale (ms)
+        cycleTime,     // measured last cycle (ms)
+        cycles,        // inhales started
+        curve;         // check of the volume curve in use
+};
+
+struct telemetry delivered;
+
+struct frame {
+    uint8_t
+        length,  // bytes so far, crc included once ended
+        fields,  // fields added
+        data[FRAME_SIZE];
+};
+
+// counts for the link and the time from a frame's first attempt to its ack
+struct link {
+    uint8_t
+        seq,
+        attempts;
+    unsigned long
+        started,
+        holdoff,
+        polled,
+        heard,  // last good reply (ms)
+        polls,
+        pollsFailed,
+        frames,
+        acked,
+        rejected,
+        retries,
+        failed,
+        latency,
+        latencyMax;
+    bool
+        busy,     // a frame or poll is in the I2C queue
+        pollDue;  // a poll is waiting for the link
+};
+
+struct link slaveLink;
+struct frame outgoing;
+
+// the volume curve the slave should be on, master/curve.h unless a bench fit
+// is put in its place before setup(). a slave that reports another is sent
+// it a chunk a frame whenever no setting is waiting, the last frame commits
+// it, and the breath after that should report it. a slave can turn a curve
+// down, so it's offered CURVE_UPLOADS times at most
+const uint8_t CURVE_CHUNK   = 4;  // Points in a frame's field, as the slave's
+const uint8_t CURVE_UPLOADS = 3;  // Commits before the slave is left as it is
+
+struct curveUpload {
+    const uint16_t
+        *steps;  // in flash
+    uint16_t
+        check,
+        cycles;  // slave inhales when the last upload was committed
+    uint8_t
+        next,     // first point of the next chunk
+        framed,   // first point in the frame in flight, CURVE_POINTS for none
+        uploads;  // committed
+    bool
+        committed;  // waiting on the slave's next breath
+};
+
+struct curveUpload upload = {curveSteps};
 
 void openHailingFrequency();
 
 // prepare corrent command to be sent
 void commandUpdate();
 
-void messenger(uint8_t command);
+// queues the frame, then its reply once the frame has gone. frameDone() gets
+// the reply's status, or 0 if either transfer failed or the reply wasn't
+// intact. false if the queue was full
+bool messenger(frame *f);
+void frameSent(const i2cTransfer *x);
+void frameReplied(const i2cTransfer *x);
+void frameDone(uint8_t status);
+
+// reads the status block once per breath seen by the pressure analysis, or
+// after POLL_TIMEOUT without one
+void pollSlave();
+void pollReplied(const i2cTransfer *x);
+
+// works out the check of the curve to upload
+void uploadBegin();
+
+// true while the slave reports a curve other than the one to upload
+bool uploadWanted();
+
+// adds the next chunk to f, and the commit after the last one
+void uploadAdd(frame *f);
+
+// the chunk in the acked frame is in, moves on to the next
+void uploadAcked();
+
+// Fletcher-16 of a curve in flash, the same as the slave's
+uint16_t curveCheck(const uint16_t *steps);
+
+// reads a reply into delivered, checking its seq if seq >= 0
+uint8_t readReply(const uint8_t *reply, int seq);
+
+void frameBegin(frame *f);
+void frameAdd(frame *f, uint8_t type);
+void frameAdd(frame *f, uint8_t type, uint8_t value);
+void frameAdd(frame *f, uint8_t type, uint16_t value);
+void frameEnd(frame *f, uint8_t seq);
+
+uint8_t crc8(const uint8_t *data, uint8_t length);
 
 bool volumeChanged();
 
@@ -65,8 +219,14 @@ bool inhaleChanged();
 
 bool bpmChanged();
 
+bool modeChanged();
+
+bool peakChanged();
+
 void setVolumeCommand();
 
 void setInhaleCommand();
 
 void setBpmCommand();
+
+void setPeakCommand();
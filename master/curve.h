@@ -0,0 +1,17 @@
+// ! Volume Curve ! ============================================================
+
+// generated by host/curvefit, do not edit
+// inhale steps for each tidal volume from CURVE_MIN_TV in CURVE_INC_TV
+// made from the nominal arm geometry
+// the master uploads it to a slave that reports any other
+
+#pragma once
+
+#define CURVE_MIN_TV 200
+#define CURVE_INC_TV 20
+#define CURVE_POINTS 31
+
+const uint16_t curveSteps[CURVE_POINTS] PROGMEM = {
+    667, 719, 770, 822, 874, 926, 978, 1030, 1081, 1133, 1185, 1237,
+    1289, 1341, 1393, 1444, 1496, 1548, 1600, 1652, 1704, 1756, 1807, 1859,
+    1911, 1963, 2015, 2067, 2119, 2170, 2222};
@@ -1,40 +1,39 @@
 // ! Implementation of dial ! ==================================================
 
 #include "dial.h"
+#include "glyphs.h"
+#include "needle.h"
+#include "scheduler.h"
 #include "util.h"
 
+static_assert(r1 == NEEDLE_R1 && r2 == NEEDLE_R2, "r1/r2 changed, regenerate needle.h");
+
+#define LAYOUT(d, field) flashRead(&(d)->layout->field)
+
+int needleAngle(int angle) {
+    if (angle < NEEDLE_MIN_ANGLE)
+        return NEEDLE_MIN_ANGLE;
+    if (angle > NEEDLE_MAX_ANGLE)
+        return NEEDLE_MAX_ANGLE;
+    return angle;
+}
+
 void buildNeedle(dial *d, int angle, int *array) {
-    float degToRad    = 0.0174532925;
-    float radianMid   = angle * degToRad;
-    float radianSide0 = (angle - (6 / 2)) * degToRad;
-    float radianSide1 = (angle + (6 / 2)) * degToRad;
-    int   needle[12];
-
-    // radius * cosine of an angle gives the x from the origin.
-    // radius * sine of an angle gives the y from the origin.
-    // add for m_x and subtract for m_y
-    int x1 = d->x + int((r1 + 1) * cos(radianSide0));
-    int y1 = d->y - int((r1 + 1) * sin(radianSide0));
-    int x4 = d->x + int((r2 + 1) * cos(radianSide0));
-    int y4 = d->y - int((r2 + 1) * sin(radianSide0));
-    int x2 = d->x + int((r1 + 1) * cos(radianMid));
-    int y2 = d->y - int((r1 + 1) * sin(radianMid));
-    int x5 = d->x + int((r2 + 1) * cos(radianMid));
-    int y5 = d->y - int((r2 + 1) * sin(radianMid));
-    int x3 = d->x + int((r1 + 1) * cos(radianSide1));
-    int y3 = d->y - int((r1 + 1) * sin(radianSide1));
-    int x6 = d->x + int((r2 + 1) * cos(radianSide1));
-    int y6 = d->y - int((r2 + 1) * sin(radianSide1));
-
-    // global array, functions that use this capture needle[] after use.
-    // it's a pretty dirty way to do it, but whatever.
-    needle[0] = x1, needle[1] = y1;
-    needle[2] = x2, needle[3] = y2;
-    needle[4] = x3, needle[5] = y3;
-    needle[6] = x4, needle[7] = y4;
-    needle[8] = x5, needle[9] = y5;
-    needle[10] = x6, needle[11] = y6;
-    needleCopy(needle, array);
+    if (angle == NEEDLE_NONE) {
+        for (int n = 0; n < 12; n++)
+            array[n] = 0;
+        return;
+    }
+    angle = needleAngle(angle);
+    int x = LAYOUT(d, x), y = LAYOUT(d, y);
+
+    // offsets were worked out with radius * cosine for x and radius * sine for
+    // y, subtracted as the screen's y grows downward
+    const int8_t *offsets = needleOffsets[angle - NEEDLE_MIN_ANGLE];
+    for (int n = 0; n < 12; n += 2) {
+        array[n]     = x + int8_t(pgm_read_byte(offsets + n));
+        array[n + 1] = y + int8_t(pgm_read_byte(offsets + n + 1));
+    }
 }
 
 void drawNeedle(int *array, int color) {
@@ -50,296 +49,542 @@ void drawNeedle(int *array, int color) {
     display.fillTriangle(x5, y5, x6, y6, x2, y2, color);
 }
 
-bool needleCompare(int *a, int *b) {
-    for (int n = 0; n < 12; n++) {
-        if (a[n] != b[n])
-            return false;
+// round to nearest for a positive denominator
+int divRound(int num, int den) {
+    if (num >= 0)
+        return (2 * num + den) / (2 * den);
+    return -((-2 * num + den) / (2 * den));
+}
+
+void spanEdge(spans *s, int xa, int ya, int xb, int yb) {
+    if (ya > yb) {
+        int x = xa, y = ya;
+        xa = xb, ya = yb;
+        xb = x, yb = y;
+    }
+    for (int y = ya; y <= yb; y++) {
+        int row = y - s->y;
+        if (row < 0 || row >= s->rows)
+            continue;
+        int x = xa;
+        if (yb != ya)
+            x = xa + divRound((y - ya) * (xb - xa), yb - ya);
+        if (x < s->left[row]) s->left[row] = x;
+        if (x > s->right[row]) s->right[row] = x;
+        if (yb == ya) {
+            if (xb < s->left[row]) s->left[row] = xb;
+            if (xb > s->right[row]) s->right[row] = xb;
+        }
     }
+}
+
+void needleSpans(int *array, spans *s) {
+    // an all zero needle has never been drawn
+    if (array[0] == 0 && array[1] == 0) {
+        s->rows = 0;
+        return;
+    }
+    int top = array[1], bottom = array[1];
+    for (int n = 3; n < 12; n += 2) {
+        if (array[n] < top) top = array[n];
+        if (array[n] > bottom) bottom = array[n];
+    }
+    s->y    = top;
+    s->rows = bottom - top + 1;
+    if (s->rows > NEEDLE_ROWS)
+        s->rows = NEEDLE_ROWS;
+    for (int row = 0; row < s->rows; row++) {
+        s->left[row]  = 32767;
+        s->right[row] = -32768;
+    }
+    // outline in order 1-2-3-6-5-4
+    const int order[] = {0, 2, 4, 10, 8, 6};
+    for (int n = 0; n < 6; n++) {
+        int a = order[n], b = order[(n + 1) % 6];
+        spanEdge(s, array[a], array[a + 1], array[b], array[b + 1]);
+    }
+}
+
+// the span of s on screen row y, returns false if the row is empty
+bool spanAt(spans *s, int y, int *left, int *right) {
+    int row = y - s->y;
+    if (s->rows == 0 || row < 0 || row >= s->rows)
+        return false;
+    *left  = s->left[row];
+    *right = s->right[row];
+    return *left <= *right;
+}
+
+void fillSpan(int y, int left, int right, int color) {
+    if (left <= right)
+        display.drawFastHLine(left, y, right - left + 1, color);
+}
+
+// vacated pixels show the face, or the other needle where it lies beneath
+void restoreSpan(int y, int left, int right, bool under, int ul, int ur, int otherColor) {
+    if (left > right)
+        return;
+    if (!under || ur < left || ul > right) {
+        fillSpan(y, left, right, c.face);
+        return;
+    }
+    fillSpan(y, left, min(right, ul - 1), c.face);
+    fillSpan(y, max(left, ul), min(right, ur), otherColor);
+    fillSpan(y, max(left, ur + 1), right, c.face);
+}
+
+void drawNeedleDelta(int *previous, int *next, int *other, int color, int otherColor) {
+    spans o, n, u;
+    needleSpans(previous, &o);
+    needleSpans(next, &n);
+    needleSpans(other, &u);
+
+    int top = n.y, bottom = n.y + n.rows - 1;
+    if (o.rows) {
+        top    = n.rows ? min(top, o.y) : o.y;
+        bottom = n.rows ? max(bottom, o.y + o.rows - 1) : o.y + o.rows - 1;
+    }
+
+    for (int y = top; y <= bottom; y++) {
+        int  ol, orr, nl, nr, ul = 0, ur = -1;  // no under span unless spanAt finds one
+        bool inOld   = spanAt(&o, y, &ol, &orr);
+        bool inNew   = spanAt(&n, y, &nl, &nr);
+        bool inUnder = spanAt(&u, y, &ul, &ur);
+
+        if (inOld && !inNew) {
+            restoreSpan(y, ol, orr, inUnder, ul, ur, otherColor);
+        } else if (inNew && !inOld) {
+            fillSpan(y, nl, nr, color);
+        } else if (inOld && inNew) {
+            // old minus new, either side of the new span
+            restoreSpan(y, ol, min(orr, nl - 1), inUnder, ul, ur, otherColor);
+            restoreSpan(y, max(ol, nr + 1), orr, inUnder, ul, ur, otherColor);
+            // new minus old
+            fillSpan(y, nl, min(nr, ol - 1), color);
+            fillSpan(y, max(nl, orr + 1), nr, color);
+            // the overlap only changes where the other needle was on top
+            if (inUnder)
+                fillSpan(y, max(max(nl, ol), ul), min(min(nr, orr), ur), color);
+        }
+        if ((y & 7) == 7)
+            schedulerYield();
+    }
+}
+
+// moves a needle drawn at *drawn to angle, leaving the dial's other needle
+// whole where they overlap
+void moveNeedle(dial *d, int16_t *drawn, int angle, int other, int color, int otherColor) {
+    angle = needleAngle(angle);
+    if (angle == *drawn)
+        return;
+    int previous[12], next[12], under[12];
+    buildNeedle(d, *drawn, previous);
+    buildNeedle(d, angle, next);
+    buildNeedle(d, other, under);
+#if NEEDLE_DELTA
+    drawNeedleDelta(previous, next, under, color, otherColor);
+#else
+    if (*drawn != NEEDLE_NONE) {
+        // re-draw the other needle if passed over, or the face to delete it
+        drawNeedle(previous, *drawn == other ? otherColor : c.face);
+    }
+    drawNeedle(next, color);
+#endif
+    *drawn = angle;
+}
+
+// * GLYPHS ====================================================================
+
+const glyphFont glyphFonts[] PROGMEM = {
+    {largeFont, sans18Glyphs, sans18Rects, SANS18_CHECK},
+    {largeFontBold, sansBold18Glyphs, sansBold18Rects, SANSBOLD18_CHECK},
+};
+
+const uint8_t GLYPH_FONTS = sizeof(glyphFonts) / sizeof(glyphFonts[0]);
+
+uint16_t glyphsCheck(const GFXfont *font) {
+    const uint8_t  *bitmap = (const uint8_t *)pgm_read_ptr(&font->bitmap);
+    const GFXglyph *glyphs = (const GFXglyph *)pgm_read_ptr(&font->glyph);
+    uint16_t        first  = pgm_read_word(&font->first);
+    uint16_t        sum    = 0;
+    for (const char *c = GLYPH_CHARS; *c; c++) {
+        const GFXglyph *g      = glyphs + (uint8_t(*c) - first);
+        uint16_t        offset = pgm_read_word(&g->bitmapOffset);
+        uint8_t         width  = pgm_read_byte(&g->width);
+        uint8_t         height = pgm_read_byte(&g->height);
+        sum = sum * 31 + width;
+        sum = sum * 31 + height;
+        sum = sum * 31 + pgm_read_byte(&g->xAdvance);
+        sum = sum * 31 + pgm_read_byte(&g->xOffset);
+        sum = sum * 31 + pgm_read_byte(&g->yOffset);
+        for (uint16_t i = 0; i < (width * height + 7) / 8; i++)
+            sum = sum * 31 + pgm_read_byte(bitmap + offset + i);
+    }
+    return sum;
+}
+
+void glyphsBegin() {
+    glyphsMatched = 0;
+    for (uint8_t i = 0; i < GLYPH_FONTS; i++) {
+        const GFXfont *font = flashRead(&glyphFonts[i].font);
+        if (glyphsCheck(font) == flashRead(&glyphFonts[i].check))
+            glyphsMatched |= 1 << i;
+        else
+            LOG_WARN(GLYPHS_MISMATCH, i);
+    }
+}
+
+const glyphFont *glyphsFor(const GFXfont *font) {
+    for (uint8_t i = 0; i < GLYPH_FONTS; i++)
+        if (flashRead(&glyphFonts[i].font) == font)
+            return glyphsMatched & 1 << i ? &glyphFonts[i] : 0;
+    return 0;
+}
+
+// index into GLYPH_CHARS, GLYPH_COUNT for a character that isn't there
+uint8_t glyphIndex(char c) {
+    const char *at = c ? strchr(GLYPH_CHARS, c) : 0;
+    return at ? at - GLYPH_CHARS : GLYPH_COUNT;
+}
+
+bool glyphsCover(const char *text) {
+    for (; *text; text++)
+        if (glyphIndex(*text) == GLYPH_COUNT)
+            return false;
     return true;
 }
 
-void needleCopy(int *a, int *b) {
-    for (int n = 0; n < 12; n++)
-        b[n] = a[n];
+const GFXglyph *fontGlyph(const GFXfont *font, char c) {
+    const GFXglyph *glyphs = (const GFXglyph *)pgm_read_ptr(&font->glyph);
+    return glyphs + (uint8_t(c) - pgm_read_word(&font->first));
 }
 
-void drawTargetValue(dial d) {
-    display.setColor(c.target);
-    display.setFont(largeFontBold);
-    display.print(String(d.targetCurrent, d.precision), d.targetX, d.targetY);
+// the font's own advance, which a table that matches has too
+uint8_t glyphAdvance(const GFXfont *font, char c) {
+    return pgm_read_byte(&fontGlyph(font, c)->xAdvance);
 }
 
-void clearTargetValue(dial d) {
-    display.setColor(c.back);
-    display.setFont(largeFontBold);
-    display.print(String(d.targetPrevious, d.precision), d.targetX, d.targetY);
+// a glyph straight from the font's bitmap, a run of ink along a row at a
+// time, hung from the top of a '0' as UTFTGLUE::print() hangs text
+void drawGlyphRuns(const GFXfont *font, char c, int x, int y, int color) {
+    const uint8_t  *bitmap = (const uint8_t *)pgm_read_ptr(&font->bitmap);
+    const GFXglyph *g      = fontGlyph(font, c);
+    const uint8_t  *bits   = bitmap + pgm_read_word(&g->bitmapOffset);
+    uint16_t        bit    = 0;
+    uint8_t         width  = pgm_read_byte(&g->width);
+    uint8_t         height = pgm_read_byte(&g->height);
+    int8_t          top    = pgm_read_byte(&fontGlyph(font, '0')->yOffset);
+    x += int8_t(pgm_read_byte(&g->xOffset));
+    y += int8_t(pgm_read_byte(&g->yOffset)) - top;
+    for (uint8_t row = 0; row < height; row++) {
+        int8_t start = -1;
+        for (uint8_t col = 0; col <= width; col++) {
+            bool ink = col < width && pgm_read_byte(bits + bit / 8) & 0x80 >> (bit & 7);
+            if (col < width)
+                bit++;
+            if (ink && start < 0)
+                start = col;
+            if (!ink && start >= 0) {
+                display.drawFastHLine(x + start, y + row, col - start, color);
+                start = -1;
+            }
+        }
+    }
 }
 
-void drawCurrentValue(dial d) {
-    display.setColor(c.current);
-    display.setFont(largeFont);
-    display.print(String(d.currentCurrent, d.precision), d.currentX, d.currentY);
+void drawGlyph(const glyphFont *g, const GFXfont *font, char c, int x, int y, int color) {
+    if (!g) {
+        drawGlyphRuns(font, c, x, y, color);
+        return;
+    }
+    const glyph     *glyphs = flashRead(&g->glyphs);
+    const glyphRect *rects  = flashRead(&g->rects);
+    glyph            one    = flashRead(&glyphs[glyphIndex(c)]);
+    for (uint8_t i = 0; i < one.rects; i++) {
+        glyphRect r = flashRead(&rects[one.first + i]);
+        display.fillRect(x + r.x, y + r.y, r.w, r.h, color);
+    }
 }
 
-void clearCurrentValue(dial d) {
-    display.setColor(c.back);
-    display.setFont(largeFont);
-    display.print(String(d.currentPrevious, d.precision), d.currentX, d.currentY);
+// every changed glyph is cleared before any is drawn, as a width change moves
+// the ones after it onto where others were. a font its table doesn't match is
+// drawn from its own bitmap
+void printChange(const char *from, const char *to, int x, int y, const GFXfont *font,
+                 int color) {
+    const glyphFont *g = glyphsFor(font);
+    if (!glyphsCover(from) || !glyphsCover(to)) {
+        display.setFont(font);
+        display.setColor(c.back);
+        display.print(from, x, y);
+        display.setColor(color);
+        display.print(to, x, y);
+        return;
+    }
+
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        int         fromX = x, toX = x;
+        const char *f = from, *t = to;
+        while (*f || *t) {
+            if (*f != *t || fromX != toX) {
+                if (pass == 0 && *f)
+                    drawGlyph(g, font, *f, fromX, y, c.back);
+                if (pass == 1 && *t)
+                    drawGlyph(g, font, *t, toX, y, color);
+            }
+            if (*f)
+                fromX += glyphAdvance(font, *f++);
+            if (*t)
+                toX += glyphAdvance(font, *t++);
+        }
+    }
 }
 
-void drawTargetNeedle(dial d) {
-    drawNeedle(d.targetNeedle, c.target);
+// * VALUES ====================================================================
+
+char *valueText(dial *d, q16 value, char *text) {
+    return value.format(text, LAYOUT(d, precision));
 }
 
-void clearTargetNeedle(dial d) {
-    drawNeedle(d.targetNeedlePrevious, c.back);
+void printValue(dial *d, const char *from, const char *to, int dy, const GFXfont *font,
+                int color) {
+    printChange(from, to, LAYOUT(d, x) + LAYOUT(d, valueX), LAYOUT(d, y) + dy, font, color);
 }
 
-void drawCurrentNeedle(dial d) {
-    drawNeedle(d.currentNeedle, c.current);
+void drawTargetValue(dial *d) {
+    char text[12];
+    printValue(d, "", valueText(d, d->targetShown, text), targetDY, largeFontBold, c.target);
 }
 
-void clearCurrentNeedle(dial d) {
-    drawNeedle(d.currentNeedlePrevious, c.back);
+void clearTargetValue(dial *d) {
+    char text[12];
+    printValue(d, valueText(d, d->targetShown, text), "", targetDY, largeFontBold, c.target);
 }
 
-void drawErrorUpper(dial d) {
-    display.setColor(c.error);
-    display.setFont(largeFontBold);
-    display.print(d.errorUpper, d.errorX, d.errorY);
+void changeTargetValue(dial *d) {
+    char from[12], to[12];
+    printValue(d, valueText(d, d->targetShown, from), valueText(d, d->target, to), targetDY,
+               largeFontBold, c.target);
+    d->targetShown = d->target;
 }
 
-void clearErrorUpper(dial d) {
-    display.setColor(c.back);
-    display.setFont(largeFontBold);
-    display.print(d.errorUpper, d.errorX, d.errorY);
+void drawCurrentValue(dial *d) {
+    char text[12];
+    printValue(d, "", valueText(d, d->currentShown, text), currentDY, largeFont, c.current);
 }
 
-void drawErrorLower(dial d) {
-    display.setColor(c.error);
-    display.setFont(largeFontBold);
-    display.print(d.errorLower, d.errorX, d.errorY);
+void clearCurrentValue(dial *d) {
+    char text[12];
+    printValue(d, valueText(d, d->currentShown, text), "", currentDY, largeFont, c.current);
 }
 
-void clearErrorLower(dial d) {
-    display.setColor(c.back);
-    display.setFont(largeFontBold);
-    display.print(d.errorLower, d.errorX, d.errorY);
+void changeCurrentValue(dial *d) {
+    char from[12], to[12];
+    printValue(d, valueText(d, d->currentShown, from), valueText(d, d->current, to), currentDY,
+               largeFont, c.current);
+    d->currentShown = d->current;
 }
 
-int calcAngle(dial d, float value) {
-    float v = (value - d.min) / (d.max - d.min) * (minDeg - maxDeg) + maxDeg;
+// the over and under range text is the limit with > or < in front
+char *errorText(dial *d, bool upper, char *text) {
+    text[0] = upper ? '>' : '<';
+    (upper ? LAYOUT(d, max) : LAYOUT(d, min)).format(text + 1, 0);
+    return text;
+}
+
+void drawErrorUpper(dial *d) {
+    char text[12];
+    printValue(d, "", errorText(d, true, text), errorDY, largeFontBold, c.error);
+}
+
+void clearErrorUpper(dial *d) {
+    char text[12];
+    printValue(d, errorText(d, true, text), "", errorDY, largeFontBold, c.error);
+}
+
+void drawErrorLower(dial *d) {
+    char text[12];
+    printValue(d, "", errorText(d, false, text), errorDY, largeFontBold, c.error);
+}
+
+void clearErrorLower(dial *d) {
+    char text[12];
+    printValue(d, errorText(d, false, text), "", errorDY, largeFontBold, c.error);
+}
+
+int calcAngle(dial *d, q16 value) {
+    // degrees of travel from min as a ratio of the raw values, so the only
+    // division is a 32 bit integer one
+    q16  min    = LAYOUT(d, min);
+    long travel = long((value - min).raw()) * (maxDeg - minDeg);
+    long span   = (LAYOUT(d, max) - min).raw();
+    int  v      = maxDeg - (travel + span / 2) / span;
     // Returns 225 for min and -45 for max input values
     int resultAngle = v - offsetDeg;
     return resultAngle;
 }
 
+void dialBegin(dial *d, const dialLayout *layout) {
+    d->layout          = layout;
+    d->target          = LAYOUT(d, initial);
+    d->current         = d->target;
+    d->targetShown     = d->target;
+    d->currentShown    = d->current;
+    d->targetNeedle    = NEEDLE_NONE;
+    d->currentNeedle   = NEEDLE_NONE;
+    d->targetPosition  = ((d->target - LAYOUT(d, min)) / LAYOUT(d, inc)).round();
+    d->currentPosition = d->targetPosition;
+    d->error           = -1;  // values are drawn whole the first time
+}
+
+// the position's share of the scale from its ends rather than a sum of
+// increments, as 0.05 in q16 is a shade over and 30 of them put 2.0 s out of
+// range. the largest product, minute volume's 6 L span in q16 times its 1050
+// positions, is about 4.1e8, inside 32 bits
+q16 positionValue(dial *d, int16_t position) {
+    q16     min       = LAYOUT(d, min);
+    q16     span      = LAYOUT(d, max) - min;
+    int16_t positions = (span / LAYOUT(d, inc)).round();
+    return min + q16::fromRaw((int32_t(span.raw()) * position + positions / 2) / positions);
+}
+
 void updateTargetByPosition(dial *d) {
-    d->target      = d->min + (d->targetPosition * d->inc);
-    d->targetAngle = calcAngle(*d, d->target);
-    //Serial.println(d->label);
-    //Serial.println(d->target);
-    //Serial.println(d->targetAngle);
+    d->target      = positionValue(d, d->targetPosition);
+    d->targetAngle = calcAngle(d, d->target);
 }
 
 void updateTargetByDirection(dial *d) {
     if (d->direction > 0)
-        d->target = d->target + d->inc;
+        d->target = d->target + LAYOUT(d, inc);
     if (d->direction < 0)
-        d->target = d->target - d->inc;
-    d->targetAngle = calcAngle(*d, d->target);
-    //Serial.println(d->label);
-    //Serial.println(d->target);
-    //Serial.println(d->targetAngle);
+        d->target = d->target - LAYOUT(d, inc);
+    d->targetAngle = calcAngle(d, d->target);
 }
 
 void updateTargetByAngle(dial *d) {
-    d->target      = mapf(d->targetAngle, minDeg, maxDeg, d->min, d->max);
-    d->targetAngle = calcAngle(*d, d->target);
-    //Serial.println(d->label);
-    //Serial.println(d->target);
-    //Serial.println(d->targetAngle);
+    d->target = mapq(q16(d->targetAngle), q16(minDeg), q16(maxDeg), LAYOUT(d, min),
+                     LAYOUT(d, max));
+    d->targetAngle = calcAngle(d, d->target);
 }
 
 void updateTargetByValue(dial *d) {
-    if (d->target > d->max) {
-        drawErrorUpper(*d);
-    } else if (d->target < d->min) {
-        drawErrorLower(*d);
+    if (d->target > LAYOUT(d, max)) {
+        drawErrorUpper(d);
+    } else if (d->target < LAYOUT(d, min)) {
+        drawErrorLower(d);
     } else {
-        d->targetAngle = calcAngle(*d, d->target);
+        d->targetAngle = calcAngle(d, d->target);
     }
-    //Serial.println(d->label);
-    //Serial.println(d->target);
-    //Serial.println(d->targetAngle);
 }
 
 void updateCurrentByPosition(dial *d) {
-    d->current      = d->min + (d->currentPosition * d->inc);
-    d->currentAngle = calcAngle(*d, d->current);
-    //Serial.println(d->label);
-    //Serial.println(d->target);
-    //Serial.println(d->targetAngle);
+    d->current      = positionValue(d, d->currentPosition);
+    d->currentAngle = calcAngle(d, d->current);
 }
 
 void updateCurrentByDirection(dial *d) {
     if (d->direction > 0)
-        d->current = d->current + d->inc;
+        d->current = d->current + LAYOUT(d, inc);
     if (d->direction < 0)
-        d->current = d->current - d->inc;
-    d->currentAngle = calcAngle(*d, d->current);
-    //Serial.println(d->label);
-    //Serial.println(d->target);
-    //Serial.println(d->targetAngle);
+        d->current = d->current - LAYOUT(d, inc);
+    d->currentAngle = calcAngle(d, d->current);
 }
 
 void updateCurrentByAngle(dial *d) {
-    d->current      = mapf(d->currentAngle, minDeg, maxDeg, d->min, d->max);
-    d->currentAngle = calcAngle(*d, d->current);
-    //Serial.println(d->label);
-    //Serial.println(d->target);
-    //Serial.println(d->targetAngle);
+    d->current = mapq(q16(d->currentAngle), q16(minDeg), q16(maxDeg), LAYOUT(d, min),
+                      LAYOUT(d, max));
+    d->currentAngle = calcAngle(d, d->current);
+}
+
+void updateCurrentByReading(dial *d) {
+    d->currentAngle = calcAngle(d, constrain(d->current, LAYOUT(d, min), LAYOUT(d, max)));
 }
 
 void updateCurrentByValue(dial *d) {
-    if (d->current > d->max) {
-        drawErrorUpper(*d);
-    } else if (d->current < d->min) {
-        drawErrorLower(*d);
+    if (d->current > LAYOUT(d, max)) {
+        drawErrorUpper(d);
+    } else if (d->current < LAYOUT(d, min)) {
+        drawErrorLower(d);
     } else {
-        d->currentAngle = calcAngle(*d, d->current);
+        d->currentAngle = calcAngle(d, d->current);
     }
-    //Serial.println(d->label);
-    //Serial.println(d->target);
-    //Serial.println(d->targetAngle);
 }
 
-void drawDialBase(dial d) {
+// the notch is a right angle triangle from the origin down to r1 either side
+void drawDialBase(dial *d) {
+    char label[sizeof(d->layout->label)];
+    int  x = LAYOUT(d, x), y = LAYOUT(d, y);
+    strcpy_P(label, d->layout->label);
     display.setColor(c.face);
-    display.fillCircle(d.x, d.y, r1);
+    display.fillCircle(x, y, r1);
+    schedulerYield();  // each circle is several milliseconds of pixels
     display.setColor(c.back);
-    display.fillCircle(d.x, d.y, r2);
-    display.fillTriangle(
-        d.cutoutStartX,
-        d.cutoutLowerY,
-        d.cutoutMidX,
-        d.cutoutUpperY,
-        d.cutoutEndX,
-        d.cutoutLowerY,
-        c.back);
+    display.fillCircle(x, y, r2);
+    schedulerYield();
+    display.fillTriangle(x - r1, y + r1, x, y, x + r1, y + r1, c.back);
     display.setColor(c.label);
     display.setFont(smallFontBold);
-    display.print(d.label, d.labelX, d.labelY);
+    display.print(label, x + LAYOUT(d, labelX), y + labelDY);
 }
 
-void clearDialBase(dial d) {
+void clearDialBase(dial *d) {
+    char label[sizeof(d->layout->label)];
+    int  x = LAYOUT(d, x), y = LAYOUT(d, y);
+    strcpy_P(label, d->layout->label);
     display.setColor(c.back);
-    display.fillCircle(d.x, d.y, r1);
-    display.fillTriangle(
-        d.cutoutStartX,
-        d.cutoutUpperY,
-        d.cutoutEndX,
-        d.cutoutLowerY,
-        d.cutoutEndX,
-        d.cutoutLowerY,
-        c.back);
+    display.fillCircle(x, y, r1);
+    display.fillTriangle(x - r1, y, x + r1, y + r1, x + r1, y + r1, c.back);
     display.setColor(c.back);
     display.setFont(smallFontBold);
-    display.print(d.label, d.labelX, d.labelY);
+    display.print(label, x + LAYOUT(d, labelX), y + labelDY);
 }
 
 void drawTargetElements(dial *d) {
-    buildNeedle(d, d->targetAngle, d->targetNeedle);
-
-    // handle target needle drawing and clearing
-    needleCopy(d->targetNeedle, d->targetNeedleCurrent);
-    if (!needleCompare(d->targetNeedleCurrent, d->targetNeedlePrevious)) {
-        if (needleCompare(d->targetNeedlePrevious, d->currentNeedleCurrent)) {
-            // re-draw current needle if passed over
-            drawNeedle(d->targetNeedlePrevious, c.current);
-        } else {
-            // re-draw previous needle to delete it
-            drawNeedle(d->targetNeedlePrevious, c.face);
-        }
-        // draw new needle
-        drawNeedle(d->targetNeedleCurrent, c.target);
-    }
-    needleCopy(d->targetNeedleCurrent, d->targetNeedlePrevious);
+    moveNeedle(d, &d->targetNeedle, d->targetAngle, d->currentNeedle, c.target, c.current);
+    schedulerYield();  // a needle and a value is a long time without a sample
 
     // detect if the target value is over, under, or within range
     // error(0) = within, error(1) = over, error(2) = under
-    if (d->target > d->max) {
-        d->error = 1;
-    } else if (d->target < d->min) {
-        d->error = 2;
-    } else {
-        d->error = 0;
+    int8_t error = 0;
+    if (d->target > LAYOUT(d, max)) {
+        error = 1;
+    } else if (d->target < LAYOUT(d, min)) {
+        error = 2;
     }
 
     // only draw values if there's no error
-    if (d->error == 0) {
-        // redraw values coming out of over range error
-        if (d->errorPrevious == 1) {
-            clearErrorUpper(*d);
-            drawTargetValue(*d);
-            drawCurrentValue(*d);
-        }
-        // redraw values coming out of under range error
-        if (d->errorPrevious == 2) {
-            clearErrorLower(*d);
-            drawTargetValue(*d);
-            drawCurrentValue(*d);
-        }
-        d->targetCurrent = d->target;
-        if (d->targetCurrent != d->targetPrevious) {
-            clearTargetValue(*d);
-            d->targetCurrent = d->target;
-            drawTargetValue(*d);
+    if (error == 0) {
+        // redraw values coming out of an over or under range error
+        if (d->error == 1)
+            clearErrorUpper(d);
+        if (d->error == 2)
+            clearErrorLower(d);
+        if (d->error != 0) {
+            drawTargetValue(d);
+            drawCurrentValue(d);
         }
-        d->targetPrevious = d->targetCurrent;
+        if (d->target != d->targetShown)
+            changeTargetValue(d);
     }
 
     // manage error drawing so it doesn't re-draw itself over and over
-    d->errorCurrent = d->error;
-    if (d->errorCurrent != d->errorPrevious) {
-        if (d->errorCurrent == 1) {
-            clearTargetValue(*d);
-            clearCurrentValue(*d);
-            drawErrorUpper(*d);
-        }
-        if (d->errorCurrent == 2) {
-            clearTargetValue(*d);
-            clearCurrentValue(*d);
-            drawErrorLower(*d);
-        }
+    if (error != d->error && error != 0) {
+        clearTargetValue(d);
+        clearCurrentValue(d);
+        if (error == 1)
+            drawErrorUpper(d);
+        else
+            drawErrorLower(d);
     }
-    d->errorPrevious = d->errorCurrent;
+    d->error = error;
+    schedulerYield();
 }
 
 void drawCurrentElements(dial *d) {
-    buildNeedle(d, d->currentAngle, d->currentNeedle);
-
-    // handle current needle drawing and clearing
-    needleCopy(d->currentNeedle, d->currentNeedleCurrent);
-    if (!needleCompare(d->currentNeedleCurrent, d->currentNeedlePrevious)) {
-        if (needleCompare(d->currentNeedlePrevious, d->targetNeedleCurrent)) {
-            // re-draw target needle if passed over
-            drawNeedle(d->currentNeedlePrevious, c.target);
-        } else {
-            // re-draw previous needle to delete it
-            drawNeedle(d->currentNeedlePrevious, c.face);
-        }
-        // draw new needle
-        drawNeedle(d->currentNeedleCurrent, c.current);
-    }
-    needleCopy(d->currentNeedleCurrent, d->currentNeedlePrevious);
+    moveNeedle(d, &d->currentNeedle, d->currentAngle, d->targetNeedle, c.current, c.target);
+    schedulerYield();
 
     // handle value drawing and clearing
-    d->currentCurrent = d->current;
-    if (d->currentCurrent != d->currentPrevious) {
-        clearCurrentValue(*d);
-        d->currentCurrent = d->current;
-        drawCurrentValue(*d);
-    }
-    d->currentPrevious = d->currentCurrent;
+    if (d->current != d->currentShown)
+        changeCurrentValue(d);
+    schedulerYield();
 }
@@ -7,6 +7,7 @@
 #include <Fonts/FreeSansBold12pt7b.h>
 #include <Fonts/FreeSansBold18pt7b.h>
 #include <UTFTGLUE.h>
+#include "fixed.h"
 
 // 16bit unsigned int version of the famous Solarized Color Scheme:
 // https://ethanschoonover.com/solarized/
@@ -33,66 +34,69 @@ const uint16_t Green   = 33984;  //  133, 153,   0  =  #859900  =  green
 #define largeFont &FreeSans18pt7b
 #define largeFontBold &FreeSansBold18pt7b
 
+// redraw a moving needle by only the pixels that changed between its old and
+// new position, 0 goes back to clearing and redrawing all 4 triangles of both
+#define NEEDLE_DELTA 1
+
 const GFXfont
     *m_smallFont     = smallFont,
     *m_smallFontBold = smallFontBold,
     *m_largeFont     = largeFont,
     *m_largeFontBold = largeFontBold;
 
-typedef struct dial {
-    int
-        targetNeedle[12],
-        targetNeedleCurrent[12],
-        targetNeedlePrevious[12],
-        currentNeedle[12],
-        currentNeedleCurrent[12],
-        currentNeedlePrevious[12];
-    float
+// where a dial sits and what it shows, fixed for the life of the sketch so
+// the table of them lives in flash. text is placed relative to the origin
+struct dialLayout {
+    int16_t
+        x,
+        y;
+    q16
         min,
         max,
         inc,
+        initial;  // target and current at power up
+    int8_t
+        labelX,  // label, centered in the notch
+        valueX;  // target, current and error text
+    uint8_t
+        precision,
+        derived;  // set from other dials, so it may leave its range
+    char
+        label[6];
+};
+
+const int
+    // text rows, relative to a dial's origin
+    labelDY   = 30,
+    targetDY  = -45,
+    currentDY = -15,
+    errorDY   = -30;
+
+// a needle angle for a needle that has never been drawn
+const int16_t NEEDLE_NONE = -32768;
+
+// what a dial shows and what was last drawn of it, everything else comes
+// from its layout. functions take it by pointer, so nothing gets copied
+struct dial {
+    const dialLayout *layout;  // in flash
+    q16
         target,
-        targetPrevious,
-        targetCurrent,
         current,
-        currentPrevious,
-        currentCurrent;
-    int
-        x,
-        y,
-        position,
+        targetShown,  // values as last drawn
+        currentShown;
+    int16_t
         targetAngle,
         currentAngle,
+        targetNeedle,  // needle angles as last drawn
+        currentNeedle,
         targetPosition,
-        currentPosition,
-        error,
-        errorCurrent,
-        errorPrevious,
-        precision,
-        maxPosition,
-        labelX,
-        labelY,
-        targetX,
-        targetY,
-        currentX,
-        currentY,
-        errorX,
-        errorY,
-        cutoutMidX,
-        cutoutStartX,
-        cutoutEndX,
-        cutoutUpperY,
-        cutoutLowerY,
+        currentPosition;
+    int8_t
         direction,
-        targetDirection,
-        currentDirection;
-    String
-        label,
-        errorUpper,
-        errorLower;
+        error;  // as last drawn, 0 = within range, 1 = over, 2 = under, -1 = nothing
 };
 
-typedef struct color {
+struct color {
     uint16_t
         back    = Base03,
         label   = Blue,
@@ -100,17 +104,62 @@ typedef struct color {
         target  = Magenta,
         current = Cyan,
         error   = Red,
-        mode    = Orange;
+        mode    = Orange,
+        chart   = Base02,
+        latched = Yellow;
 };
 
 struct color c;
 
+// a needle rasterised into one horizontal span per row, left > right when a
+// row is empty. rows is 0 for a needle that has never been built
+const int NEEDLE_ROWS = 16;
+
+struct spans {
+    int
+        y,
+        rows,
+        left[NEEDLE_ROWS],
+        right[NEEDLE_ROWS];
+};
+
+// a filled rectangle of a glyph, from the cursor and the top of the text
+struct glyphRect {
+    int8_t
+        x,
+        y;
+    uint8_t
+        w,
+        h;
+};
+
+struct glyph {
+    uint16_t first;  // rect
+    uint8_t
+        rects,
+        advance;
+};
+
+// the value characters of a font as rectangles, made by host/glyphgen. the
+// check is taken from the font's own glyphs, and a table that doesn't match
+// the font linked in is left alone, its glyphs drawn from the font's bitmap a
+// run of ink at a time instead
+struct glyphFont {
+    const GFXfont   *font;
+    const glyph     *glyphs;
+    const glyphRect *rects;
+    uint16_t         check;
+};
+
+uint8_t glyphsMatched;  // a bit for each glyph table that can be used
+
 // build the coordinates from points on the circumference of circles r1 and r2
 // calculates 6 coordinates in order to draw a polygon of 4 triangles
 // needle shape is that of a segment of the dial face an angle from its origin
 // the needles width is 6, as that draws most clearly for the size of dial used
-// buildNeedle returns void, as the destination array is passed in along with
-// the dial struct to avoid unnecessary globals
+// the offsets for every angle come from the flash table in needle.h, so this
+// is a lookup and an add rather than 12 soft float cos/sin calls
+// NEEDLE_NONE builds the all zero needle that needleSpans() skips
 void buildNeedle(dial *d, int angle, int *array);
 
 // draw needle from array of coordinates in such a fashion
@@ -122,54 +171,67 @@ void buildNeedle(dial *d, int angle, int *array);
 // 4----5----6
 void drawNeedle(int *array, int color);
 
-// check if two needle coordinate arrays are the same
-bool needleCompare(int *a, int *b);
+// scan convert the needle polygon 1-2-3-6-5-4 into per row spans
+void needleSpans(int *array, spans *s);
+
+// moves a needle by writing only the rows and columns that differ between
+// previous and next. vacated pixels get the face color, or the other needle's
+// color where it lies underneath. the moving needle is always left on top
+void drawNeedleDelta(int *previous, int *next, int *other, int color, int otherColor);
+
+// a sum over the metrics and bitmaps of a font's GLYPH_CHARS, as in flash
+uint16_t glyphsCheck(const GFXfont *font);
 
-// copy all the elements from needle a into needle b
-void needleCopy(int *a, int *b);
+// checks every glyph table against its font, before any value is drawn
+void glyphsBegin();
+
+// rewrites the text from into to at x, y. only the characters that changed or
+// moved are cleared and drawn, each as a few rectangles rather than a pixel
+// at a time, or a run at a time from the font's bitmap when its table doesn't
+// match, so a value that ticks over its last digit costs one glyph. text
+// with characters outside the tables is printed whole as it always was
+void printChange(const char *from, const char *to, int x, int y, const GFXfont *font,
+                 int color);
 
 // target value is printed in bold and in magenta as the top value in the dial
-void drawTargetValue(dial d);
+void drawTargetValue(dial *d);
 
 // clearing takes place by re-drawing previous value with the background color
-void clearTargetValue(dial d);
+void clearTargetValue(dial *d);
+
+// changes the target value from what was last drawn to target
+void changeTargetValue(dial *d);
 
 // current value is printed in cyan below the target value
-void drawCurrentValue(dial d);
+void drawCurrentValue(dial *d);
 
 // clearing takes place by re-drawing previous with the background color
-void clearCurrentValue(dial d);
-
-// target needle is drawn at the coresponding angle on the face of the dial
-// in the target color magenta
-void drawTargetNeedle(dial d);
-
-// clearing takes place by re-drawing previous needle position with the face
-// color of the dial
-void clearTargetNeedle(dial d);
+void clearCurrentValue(dial *d);
 
-// current needle is drawn at the coresponding angle onf the face of the dial
-// in the current color Cyan
-void drawCurrentNeedle(dial d);
-
-// clearing takes place by re-drawing previous needle position with the face
-// color of the dial
-void clearCurrentNeedle(dial d);
+// changes the current value from what was last drawn to current
+void changeCurrentValue(dial *d);
 
 // this error gets drawn in the center of the dial face for over range errors
-void drawErrorUpper(dial d);
+void drawErrorUpper(dial *d);
 
 // clearing takes place by re-drawing the error message with background color
-void clearErrorUpper(dial d);
+void clearErrorUpper(dial *d);
 
 // this error gets drawn in the center of the dial face for under range errors
-void drawErrorLower(dial d);
+void drawErrorLower(dial *d);
 
 // clearing takes place by re-drawing the error message with background color
-void clearErrorLower(dial d);
+void clearErrorLower(dial *d);
 
 // adjust needle angle for a min of 270 degrees up to a max of -45 degrees
-int calcAngle(dial d, float value);
+// rounded to the nearest whole degree
+int calcAngle(dial *d, q16 value);
+
+// the value at a knob position, max at the top one
+q16 positionValue(dial *d, int16_t position);
+
+// sets a dial up from its layout, at its initial value with nothing drawn
+void dialBegin(dial *d, const dialLayout *layout);
 
 // use this to update the target and angle when from a position within the
 // possible range of positions on a dial
@@ -203,20 +265,25 @@ void updateCurrentByAngle(dial *d);
 // current value
 void updateCurrentByValue(dial *d);
 
+// use this to update the angle for a measured current value, which can lie
+// outside the dial. the needle stops at the end of the scale and the value is
+// still printed as read
+void updateCurrentByReading(dial *d);
+
 // draws the face of the dial and its label by drawing two circles of radius
 // r1, and r2. r1 being the outside circumference, and r2 a smaller diameter
 // within r1 and the same color as the background. the bottom notch is removed
 // from the dial face by a centered right angle triangle and the dials label
 // drawn centered within the notch
-void drawDialBase(dial d);
+void drawDialBase(dial *d);
 
 // never called, but can wipe the dial from the screen by drawing over it
-void clearDialBase(dial d);
+void clearDialBase(dial *d);
 
 // draws both target value and target needle elements and handles clearing of
-// previous drawings by way of previous and current state attributes
+// previous drawings by way of what was last drawn
 void drawTargetElements(dial *d);
 
 // draws both current value and current needle elements and handles clearing of
-// previous drawings by way of previous and current state attributes
+// previous drawings by way of what was last drawn
 void drawCurrentElements(dial *d);
@@ -0,0 +1,30 @@
+// ! Master Log Events ! =======================================================
+
+// every event the master logs, as X(name, id, format). ids 1 - 63 are the
+// master's and 64 - 127 the slave's, so one decoder reads either board, and 0
+// is the logger's own. formats are for the decoder and never reach flash: %d
+// is signed, %u unsigned, %x hex. ids go with recorded logs, so don't reuse
+// one. no include guard, the decoder reads both boards' tables
+#undef LOG_EVENTS
+#define LOG_EVENTS(X)                                                  \
+    X(DROPPED, 0, "log: %u records dropped")                           \
+    X(ENCODER_COUNTER, 1, "encoder %d counter %d")                     \
+    X(ENCODER_PRESSED, 2, "encoder %d pressed")                        \
+    X(VOLUME_POSITION, 3, "volume position: %d")                       \
+    X(BPM_POSITION, 4, "bpm position: %d")                             \
+    X(INHALE_POSITION, 5, "inhale position: %d")                       \
+    X(FRAME_ACKED, 6, "frame %u: %u fields acked in %u us")            \
+    X(FRAME_FAILED, 7, "frame %u: failed")                             \
+    X(PRESSURE_RATE, 8, "pressure: %u Hz, %u dropped")                 \
+    X(TASK_TIMING, 9, "task %u: %u runs, late %u us, cost %u us")      \
+    X(TASK_MISSED, 10, "task %u: %u overruns, %u skipped")             \
+    X(GLYPHS_MISMATCH, 11, "glyphs %u: made from other fonts")         \
+    X(HEAP_CHANGED, 12, "heap changed after setup: %d bytes")          \
+    X(MEMORY, 13, "sram: %u free, %u stack unused, %u heap changes")   \
+    X(ALARM_RAISED, 14, "alarm %u raised, %u us from sample to tone")  \
+    X(ALARM_CLEARED, 15, "alarm %u cleared")                           \
+    X(ALARMS_ACKED, 16, "alarms acked, %u latched ended")              \
+    X(BOOT, 17, "boot: sensor %u ui %u baseline %u breath %u ms")      \
+    X(CURVE_UPLOAD, 18, "curve %x: uploading, slave on %x")            \
+    X(CURVE_COMMITTED, 19, "curve %x: committed, upload %u")           \
+    X(PEAK_POSITION, 20, "peak position: %d")
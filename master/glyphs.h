@@ -0,0 +1,252 @@
+// ! Digit Glyphs ! ============================================================
+
+// generated by host/glyphgen, do not edit
+// the characters of a dial value as filled rectangles, x from the cursor and
+// y from the top of the text, in the order of GLYPH_CHARS. see printGlyphs()
+
+#pragma once
+
+#define GLYPH_CHARS "0123456789.<>- "
+#define GLYPH_COUNT 15
+#define SANS18_CHECK 0x9B49
+#define SANSBOLD18_CHECK 0x4022
+
+const glyphRect sans18Rects[84] PROGMEM = {
+    // '0'
+    {1, 0, 16, 3},
+    {1, 3, 3, 19},
+    {14, 3, 3, 19},
+    {1, 22, 16, 3},
+    // '1'
+    {14, 0, 3, 25},
+    // '2'
+    {1, 0, 16, 3},
+    {14, 3, 3, 8},
+    {1, 11, 16, 3},
+    {1, 14, 3, 8},
+    {1, 22, 16, 3},
+    // '3'
+    {1, 0, 16, 3},
+    {14, 3, 3, 8},
+    {1, 11, 16, 3},
+    {14, 14, 3, 8},
+    {1, 22, 16, 3},
+    // '4'
+    {1, 0, 3, 11},
+    {14, 0, 3, 11},
+    {1, 11, 16, 3},
+    {14, 14, 3, 11},
+    // '5'
+    {1, 0, 16, 3},
+    {1, 3, 3, 8},
+    {1, 11, 16, 3},
+    {14, 14, 3, 8},
+    {1, 22, 16, 3},
+    // '6'
+    {1, 0, 16, 3},
+    {1, 3, 3, 8},
+    {1, 11, 16, 3},
+    {1, 14, 3, 8},
+    {14, 14, 3, 8},
+    {1, 22, 16, 3},
+    // '7'
+    {1, 0, 16, 3},
+    {14, 3, 3, 22},
+    // '8'
+    {1, 0, 16, 3},
+    {1, 3, 3, 8},
+    {14, 3, 3, 8},
+    {1, 11, 16, 3},
+    {1, 14, 3, 8},
+    {14, 14, 3, 8},
+    {1, 22, 16, 3},
+    // '9'
+    {1, 0, 16, 3},
+    {1, 3, 3, 8},
+    {14, 3, 3, 8},
+    {1, 11, 16, 3},
+    {14, 14, 3, 8},
+    {1, 22, 16, 3},
+    // '.'
+    {1, 21, 4, 4},
+    // '<'
+    {14, 7, 3, 1},
+    {13, 8, 3, 1},
+    {12, 9, 3, 1},
+    {10, 10, 3, 1},
+    {9, 11, 3, 1},
+    {7, 12, 3, 1},
+    {6, 13, 3, 1},
+    {4, 14, 3, 1},
+    {3, 15, 3, 2},
+    {4, 17, 3, 1},
+    {6, 18, 3, 1},
+    {7, 19, 3, 1},
+    {9, 20, 3, 1},
+    {10, 21, 3, 1},
+    {12, 22, 3, 1},
+    {13, 23, 3, 1},
+    {14, 24, 3, 1},
+    // '>'
+    {1, 7, 3, 1},
+    {2, 8, 3, 1},
+    {3, 9, 3, 1},
+    {5, 10, 3, 1},
+    {6, 11, 3, 1},
+    {8, 12, 3, 1},
+    {9, 13, 3, 1},
+    {11, 14, 3, 1},
+    {12, 15, 3, 2},
+    {11, 17, 3, 1},
+    {9, 18, 3, 1},
+    {8, 19, 3, 1},
+    {6, 20, 3, 1},
+    {5, 21, 3, 1},
+    {3, 22, 3, 1},
+    {2, 23, 3, 1},
+    {1, 24, 3, 1},
+    // '-'
+    {1, 0, 16, 3},
+    {1, 3, 3, 19},
+    {14, 3, 3, 19},
+    {1, 22, 16, 3},
+    // ' '
+};
+
+const glyph sans18Glyphs[GLYPH_COUNT] PROGMEM = {
+    {0, 4, 20},  // '0'
+    {4, 1, 20},  // '1'
+    {5, 5, 20},  // '2'
+    {10, 5, 20},  // '3'
+    {15, 4, 20},  // '4'
+    {19, 5, 20},  // '5'
+    {24, 6, 20},  // '6'
+    {30, 2, 20},  // '7'
+    {32, 7, 20},  // '8'
+    {39, 6, 20},  // '9'
+    {45, 1, 7},  // '.'
+    {46, 17, 20},  // '<'
+    {63, 17, 20},  // '>'
+    {80, 4, 20},  // '-'
+    {84, 0, 8},  // ' '
+};
+
+const glyphRect sansBold18Rects[84] PROGMEM = {
+    // '0'
+    {1, 0, 16, 4},
+    {1, 4, 4, 17},
+    {13, 4, 4, 17},
+    {1, 21, 16, 4},
+    // '1'
+    {13, 0, 4, 25},
+    // '2'
+    {1, 0, 16, 4},
+    {13, 4, 4, 6},
+    {1, 10, 16, 4},
+    {1, 14, 4, 7},
+    {1, 21, 16, 4},
+    // '3'
+    {1, 0, 16, 4},
+    {13, 4, 4, 6},
+    {1, 10, 16, 4},
+    {13, 14, 4, 7},
+    {1, 21, 16, 4},
+    // '4'
+    {1, 0, 4, 10},
+    {13, 0, 4, 10},
+    {1, 10, 16, 4},
+    {13, 14, 4, 11},
+    // '5'
+    {1, 0, 16, 4},
+    {1, 4, 4, 6},
+    {1, 10, 16, 4},
+    {13, 14, 4, 7},
+    {1, 21, 16, 4},
+    // '6'
+    {1, 0, 16, 4},
+    {1, 4, 4, 6},
+    {1, 10, 16, 4},
+    {1, 14, 4, 7},
+    {13, 14, 4, 7},
+    {1, 21, 16, 4},
+    // '7'
+    {1, 0, 16, 4},
+    {13, 4, 4, 21},
+    // '8'
+    {1, 0, 16, 4},
+    {1, 4, 4, 6},
+    {13, 4, 4, 6},
+    {1, 10, 16, 4},
+    {1, 14, 4, 7},
+    {13, 14, 4, 7},
+    {1, 21, 16, 4},
+    // '9'
+    {1, 0, 16, 4},
+    {1, 4, 4, 6},
+    {13, 4, 4, 6},
+    {1, 10, 16, 4},
+    {13, 14, 4, 7},
+    {1, 21, 16, 4},
+    // '.'
+    {1, 20, 5, 5},
+    // '<'
+    {13, 7, 4, 1},
+    {12, 8, 4, 1},
+    {11, 9, 4, 1},
+    {9, 10, 4, 1},
+    {8, 11, 4, 1},
+    {7, 12, 4, 1},
+    {5, 13, 4, 1},
+    {4, 14, 4, 1},
+    {3, 15, 4, 2},
+    {4, 17, 4, 1},
+    {5, 18, 4, 1},
+    {7, 19, 4, 1},
+    {8, 20, 4, 1},
+    {9, 21, 4, 1},
+    {11, 22, 4, 1},
+    {12, 23, 4, 1},
+    {13, 24, 4, 1},
+    // '>'
+    {1, 7, 4, 1},
+    {2, 8, 4, 1},
+    {3, 9, 4, 1},
+    {5, 10, 4, 1},
+    {6, 11, 4, 1},
+    {7, 12, 4, 1},
+    {9, 13, 4, 1},
+    {10, 14, 4, 1},
+    {11, 15, 4, 2},
+    {10, 17, 4, 1},
+    {9, 18, 4, 1},
+    {7, 19, 4, 1},
+    {6, 20, 4, 1},
+    {5, 21, 4, 1},
+    {3, 22, 4, 1},
+    {2, 23, 4, 1},
+    {1, 24, 4, 1},
+    // '-'
+    {1, 0, 16, 4},
+    {1, 4, 4, 17},
+    {13, 4, 4, 17},
+    {1, 21, 16, 4},
+    // ' '
+};
+
+const glyph sansBold18Glyphs[GLYPH_COUNT] PROGMEM = {
+    {0, 4, 21},  // '0'
+    {4, 1, 21},  // '1'
+    {5, 5, 21},  // '2'
+    {10, 5, 21},  // '3'
+    {15, 4, 21},  // '4'
+    {19, 5, 21},  // '5'
+    {24, 6, 21},  // '6'
+    {30, 2, 21},  // '7'
+    {32, 7, 21},  // '8'
+    {39, 6, 21},  // '9'
+    {45, 1, 8},  // '.'
+    {46, 17, 21},  // '<'
+    {63, 17, 21},  // '>'
+    {80, 4, 21},  // '-'
+    {84, 0, 8},  // ' '
+};
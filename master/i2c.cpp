@@ -0,0 +1,217 @@
+// ! Implementation of i2c ! ===================================================
+
+#include "i2c.h"
+
+const uint8_t I2C_MASK = I2C_QUEUE - 1;
+
+// TWCR for each step. a STOP goes out without the interrupt, the TWI needs
+// nothing more from us once it's on the bus
+const uint8_t TWI_START   = _BV(TWINT) | _BV(TWSTA) | _BV(TWEN) | _BV(TWIE);
+const uint8_t TWI_RESTART = _BV(TWINT) | _BV(TWSTO) | _BV(TWSTA) | _BV(TWEN) | _BV(TWIE);
+const uint8_t TWI_NEXT    = _BV(TWINT) | _BV(TWEN) | _BV(TWIE);
+const uint8_t TWI_ACK     = _BV(TWINT) | _BV(TWEA) | _BV(TWEN) | _BV(TWIE);
+const uint8_t TWI_STOP    = _BV(TWINT) | _BV(TWSTO) | _BV(TWEN);
+
+void i2cBegin() {
+    // the internal pull-ups, as Wire turns on
+    digitalWrite(I2C_SDA, HIGH);
+    digitalWrite(I2C_SCL, HIGH);
+    TWSR = 0;
+    TWBR = (F_CPU / I2C_CLOCK - 16) / 2;
+    TWCR = _BV(TWEN);
+}
+
+uint8_t i2cDepth() {
+    return (i2c.tail - i2c.head) & I2C_MASK;
+}
+
+// a transfer is waiting and its time has come. a STOP still going out holds
+// it to the next poll, a START written over it would cut the STOP short
+bool i2cDue() {
+    return !i2c.running && i2c.active != i2c.tail && !(TWCR & _BV(TWSTO)) &&
+           long(micros() - i2c.queue[i2c.active].started) >= 0;
+}
+
+// the active transfer goes on the bus. chained means the last one's STOP
+// hasn't gone out yet, so it goes out first
+void i2cStart(bool chained) {
+    i2cTransfer *x = &i2c.queue[i2c.active];
+    x->moved       = 0;
+    x->started     = micros();
+    i2c.running    = true;
+    TWCR           = chained ? TWI_RESTART : TWI_START;
+}
+
+// ends the active attempt, from the interrupt or with interrupts off. a
+// transfer that went through or has no retries left is finished and the next
+// starts straight behind it. one with retries left stays active, and
+// i2cUpdate() starts it again once I2C_BACKOFF has passed
+void i2cEnd(uint8_t status) {
+    i2cTransfer *x = &i2c.queue[i2c.active];
+    i2c.running    = false;
+    if (status == I2C_NACK)
+        i2c.nacks++;
+    if (status == I2C_BUS_ERROR)
+        i2c.busErrors++;
+
+    if (status != I2C_OK && x->retries) {
+        x->retries--;
+        x->started = micros() + I2C_BACKOFF;
+        i2c.retries++;
+        TWCR = TWI_STOP;
+        return;
+    }
+
+    x->status   = status;
+    x->finished = micros();
+    i2c.active  = (i2c.active + 1) & I2C_MASK;
+    if (i2c.active != i2c.tail)
+        i2cStart(true);
+    else
+        TWCR = TWI_STOP;
+}
+
+// claims the tail slot, i2cCommit() hands it over once it's filled in
+i2cTransfer *i2cClaim(uint8_t address, uint8_t length, bool read, i2cCallback callback,
+                      uint16_t timeout, uint8_t retries) {
+    if (length == 0 || length > I2C_DATA || ((i2c.tail + 1) & I2C_MASK) == i2c.head) {
+        i2c.full += length <= I2C_DATA;
+        return 0;
+    }
+    i2cTransfer *x = &i2c.queue[i2c.tail];
+    x->address     = address;
+    x->length      = length;
+    x->read        = read;
+    x->callback    = callback;
+    x->timeout     = timeout;
+    x->retries     = retries;
+    x->status      = I2C_QUEUED;
+    x->queued      = micros();
+    x->started     = x->queued;
+    return x;
+}
+
+void i2cCommit() {
+    noInterrupts();
+    i2c.tail = (i2c.tail + 1) & I2C_MASK;
+    if (i2cDepth() > i2c.depthMax)
+        i2c.depthMax = i2cDepth();
+    if (i2cDue())
+        i2cStart(false);
+    interrupts();
+}
+
+bool i2cWrite(uint8_t address, const uint8_t *data, uint8_t length, i2cCallback callback,
+              uint16_t timeout, uint8_t retries) {
+    i2cTransfer *x = i2cClaim(address, length, false, callback, timeout, retries);
+    if (!x)
+        return false;
+    memcpy(x->data, data, length);
+    i2cCommit();
+    return true;
+}
+
+bool i2cRead(uint8_t address, uint8_t length, i2cCallback callback,
+             uint16_t timeout, uint8_t retries) {
+    if (!i2cClaim(address, length, true, callback, timeout, retries))
+        return false;
+    i2cCommit();
+    return true;
+}
+
+// a device that lost count part way through a read can sit on SDA waiting
+// for the rest of its byte. up to nine clocks walk it to the end, then a
+// STOP by hand leaves the bus idle. the TWI is off, so the pins are ours
+void i2cRecover() {
+    if (digitalRead(I2C_SDA) == HIGH)
+        return;
+    i2c.recoveries++;
+    pinMode(I2C_SCL, OUTPUT);
+    for (uint8_t i = 0; i < 9 && digitalRead(I2C_SDA) == LOW; i++) {
+        digitalWrite(I2C_SCL, LOW);
+        delayMicroseconds(5);
+        digitalWrite(I2C_SCL, HIGH);
+        delayMicroseconds(5);
+    }
+    pinMode(I2C_SDA, OUTPUT);
+    digitalWrite(I2C_SDA, LOW);
+    delayMicroseconds(5);
+    digitalWrite(I2C_SDA, HIGH);
+    pinMode(I2C_SDA, INPUT);
+    pinMode(I2C_SCL, INPUT);
+}
+
+void i2cUpdate() {
+    // a stalled attempt is cut off by switching the TWI off, which drops
+    // whatever it was doing, and the bus is checked before anything else
+    // goes out on it
+    noInterrupts();
+    if (i2c.running && micros() - i2c.queue[i2c.active].started > i2c.queue[i2c.active].timeout) {
+        TWCR = 0;
+        i2c.running = false;
+        i2c.timeouts++;
+        interrupts();
+        i2cRecover();
+        noInterrupts();
+        i2cEnd(I2C_STALLED);
+    }
+    if (i2cDue())
+        i2cStart(false);
+    interrupts();
+
+    while (i2c.head != i2c.active) {
+        i2cTransfer *x = &i2c.queue[i2c.head];
+        i2c.transfers++;
+        if (x->status != I2C_OK)
+            i2c.failed++;
+        i2c.latency = micros() - x->queued;
+        if (i2c.latency > i2c.latencyMax)
+            i2c.latencyMax = i2c.latency;
+        if (x->callback)
+            x->callback(x);
+        i2c.head = (i2c.head + 1) & I2C_MASK;
+    }
+}
+
+void i2cFlush() {
+    while (i2cDepth())
+        i2cUpdate();
+}
+
+ISR(TWI_vect) {
+    i2cTransfer *x = &i2c.queue[i2c.active];
+    switch (TW_STATUS) {
+    case TW_START:
+    case TW_REP_START:
+        TWDR = x->address << 1 | (x->read ? TW_READ : TW_WRITE);
+        TWCR = TWI_NEXT;
+        break;
+    case TW_MT_SLA_ACK:
+    case TW_MT_DATA_ACK:
+        if (x->moved < x->length) {
+            TWDR = x->data[x->moved++];
+            TWCR = TWI_NEXT;
+        } else {
+            i2cEnd(I2C_OK);
+        }
+        break;
+    case TW_MR_DATA_ACK:
+        x->data[x->moved++] = TWDR;
+        // fall through, ack every byte but the last
+    case TW_MR_SLA_ACK:
+        TWCR = x->moved + 1 < x->length ? TWI_ACK : TWI_NEXT;
+        break;
+    case TW_MR_DATA_NACK:
+        x->data[x->moved++] = TWDR;
+        i2cEnd(I2C_OK);
+        break;
+    case TW_MT_SLA_NACK:
+    case TW_MT_DATA_NACK:
+    case TW_MR_SLA_NACK:
+        i2cEnd(I2C_NACK);
+        break;
+    default:  // lost arbitration or a bus error
+        i2cEnd(I2C_BUS_ERROR);
+        break;
+    }
+}
@@ -0,0 +1,105 @@
+// ! Queued I2C Engine ! =======================================================
+
+#pragma once
+#include <util/twi.h>
+
+// every transfer on the bus, the pressure sensor's and the slave's, goes
+// through one queue. the TWI interrupt moves the bytes and starts the next
+// transfer behind one that went through, so loop() never waits on the bus.
+// i2cUpdate() runs in loop() context: it hands finished transfers to their
+// callbacks, times out a transfer that has stalled, and retries a failed one
+// after I2C_BACKOFF. a timeout also checks SDA and clocks a device that is
+// holding it low off the bus before the next attempt
+//
+// a transfer is a write or a read on its own, each with its own START and
+// STOP, which is how Wire talks to the slave and the sensor already
+
+const uint8_t  I2C_QUEUE   = 8;       // Transfers held, a power of two
+const uint8_t  I2C_DATA    = 32;      // Largest transfer, the Wire buffer
+const uint16_t I2C_TIMEOUT = 10000;   // Default stall limit per attempt (us)
+const uint8_t  I2C_RETRIES = 2;       // Default attempts after the first
+const uint16_t I2C_BACKOFF = 1000;    // Wait before a retry (us)
+const uint32_t I2C_CLOCK   = 100000;  // SCL (Hz)
+const uint8_t  I2C_SDA     = 20;      // Mega pins
+const uint8_t  I2C_SCL     = 21;
+
+// transfer status
+const uint8_t I2C_QUEUED    = 0;
+const uint8_t I2C_OK        = 1;
+const uint8_t I2C_NACK      = 2;  // the address or a byte wasn't acked
+const uint8_t I2C_STALLED   = 3;  // an attempt ran past its timeout
+const uint8_t I2C_BUS_ERROR = 4;  // lost arbitration or a misplaced START/STOP
+
+struct i2cTransfer;
+
+// called from i2cUpdate() once the transfer has succeeded or run out of
+// retries. the transfer's slot is reused as soon as it returns
+typedef void (*i2cCallback)(const i2cTransfer *x);
+
+struct i2cTransfer {
+    uint8_t
+        address,
+        length,   // bytes to write or read
+        moved,    // bytes moved so far this attempt
+        retries,  // attempts left after this one
+        status;
+    bool
+        read;
+    uint16_t
+        timeout;  // stall limit per attempt (us)
+    unsigned long
+        queued,    // when it joined the queue
+        started,   // when its current attempt started, or may start
+        finished;  // when it came off the bus
+    i2cCallback
+        callback;
+    uint8_t
+        data[I2C_DATA];  // bytes to write, or bytes read
+};
+
+// slots from head to active are finished and waiting for i2cUpdate(), from
+// active to tail are still to go over the bus, active first
+struct i2cEngine {
+    i2cTransfer queue[I2C_QUEUE];
+    volatile uint8_t
+        head,
+        active,
+        tail;
+    volatile bool
+        running;  // the interrupt owns the active transfer
+    uint8_t
+        depthMax;  // most transfers held at once
+    unsigned long
+        transfers,   // handed to callbacks
+        failed,      // of those, out of retries
+        retries,     // attempts after the first
+        nacks,       // attempts refused
+        timeouts,    // attempts that stalled
+        busErrors,   // attempts that lost the bus
+        recoveries,  // times SDA was found stuck and clocked free
+        full,        // transfers refused because the queue was full
+        latency,     // last queue to callback (us)
+        latencyMax;
+};
+
+struct i2cEngine i2c;
+
+// set the clock and take over the TWI
+void i2cBegin();
+
+// queue a write of length bytes from data, or a read of length bytes. false
+// if the queue is full or the transfer too long, and the callback never runs
+bool i2cWrite(uint8_t address, const uint8_t *data, uint8_t length, i2cCallback callback,
+              uint16_t timeout = I2C_TIMEOUT, uint8_t retries = I2C_RETRIES);
+bool i2cRead(uint8_t address, uint8_t length, i2cCallback callback,
+             uint16_t timeout = I2C_TIMEOUT, uint8_t retries = I2C_RETRIES);
+
+// deliver finished transfers, time out a stalled one and start the next.
+// call every pass of loop(), or as a scheduled task
+void i2cUpdate();
+
+// run i2cUpdate() until everything queued has been called back, for setup()
+void i2cFlush();
+
+// transfers held, waiting, running or finished
+uint8_t i2cDepth();
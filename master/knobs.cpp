@@ -0,0 +1,52 @@
+// ! Implementation of knobs ! =================================================
+
+#include "knobs.h"
+
+// steps by last phase | new phase << 2, each phase clk | dt << 1
+const int8_t knobSteps[16] PROGMEM = {
+    0, 1, -1, 2, -1, 0, -2, 1, 1, -2, 0, -1, 2, -1, 1, 0,
+};
+
+void knobsBegin() {
+    knobs.phases = PINA;
+    TCCR1A       = 0;
+    TCCR1B       = 0;
+    TCNT1        = 0;
+    OCR1A        = KNOB_TICKS - 1;
+    TIFR1        = _BV(OCF1A);
+    TIMSK1 |= _BV(OCIE1A);
+    TCCR1B = _BV(WGM12) | _BV(CS11);  // CTC on OCR1A, clock / 8
+}
+
+int16_t knobRead(uint8_t knob) {
+    noInterrupts();
+    int16_t count = knobs.count[knob];
+    interrupts();
+    return count;
+}
+
+int16_t knobDetents(uint8_t knob) {
+    int16_t steps   = int16_t(uint16_t(knobRead(knob)) - uint16_t(knobs.taken[knob]));
+    int16_t detents = steps / 2;
+    knobs.taken[knob] = int16_t(uint16_t(knobs.taken[knob]) + uint16_t(detents * 2));
+    return detents;
+}
+
+int16_t knobPositions(int16_t detents) {
+    int16_t speed = detents < 0 ? -detents : detents;
+    return detents * (speed < KNOB_GAIN ? speed : KNOB_GAIN);
+}
+
+// PINA is read once, so the three knobs are sampled at the same instant
+ISR(TIMER1_COMPA_vect) {
+    uint8_t now  = PINA;
+    uint8_t last = knobs.phases;
+    for (uint8_t k = 0; k < KNOBS; k++) {
+        uint8_t shift = 2 * k;
+        uint8_t from  = (last >> (shift + 1) & 1) | (last >> shift & 1) << 1;
+        uint8_t to    = (now >> (shift + 1) & 1) | (now >> shift & 1) << 1;
+        if (from != to)
+            knobs.count[k] += (int8_t)pgm_read_byte(knobSteps + (from | to << 2));
+    }
+    knobs.phases = now;
+}
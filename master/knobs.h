@@ -0,0 +1,45 @@
+// ! Knob Decoding ! ===========================================================
+
+#pragma once
+#include <Arduino.h>
+#include <avr/interrupt.h>
+
+// the three encoders sit on pins 22 - 27, which are PA0 - PA5, dt on the even
+// bit and clk on the odd one above it. a Timer1 compare interrupt reads PINA
+// every KNOB_PERIOD and steps each knob's count through a table on its last
+// and new phases, so a turn is counted however long loop() is busy drawing.
+// a quadrature step shorter than the period is missed, a detent is two steps
+// and a fast spin is a few hundred steps a second. a step seen to skip a
+// phase is taken as two in the direction the PJRC library would guess
+const uint8_t  KNOBS       = 3;
+const uint16_t KNOB_PERIOD = 500;              // Between samples of the pins (us)
+const uint16_t KNOB_TICKS  = KNOB_PERIOD * 2;  // Timer1 ticks at clock / 8
+const uint8_t  KNOB_GAIN   = 4;                // Most positions a detent moves a dial
+
+struct knobDecoder {
+    volatile int16_t
+        count[KNOBS];  // quadrature steps, clockwise up
+    volatile uint8_t
+        phases;  // PINA as last sampled
+    int16_t
+        taken[KNOBS];  // count up to the last detent knobDetents() gave
+};
+
+knobDecoder knobs;
+
+// starts sampling from the pins as they are
+void knobsBegin();
+
+// a knob's count, read with the interrupt held off
+int16_t knobRead(uint8_t knob);
+
+// detents turned since the last call, from the count's difference wrapped to
+// 16 bits, so it's right across the count's overflow. a step short of a
+// detent is left for the next call
+int16_t knobDetents(uint8_t knob);
+
+// the dial positions to move for detents turned since the last call of the
+// caller's. a detent or so per call is a slow turn and moves a position each,
+// faster than that each moves as many as there were, up to KNOB_GAIN, so a
+// spin covers a scale in a fraction of a turn and a slow one stays exact
+int16_t knobPositions(int16_t detents);
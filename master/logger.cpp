@@ -0,0 +1,79 @@
+// ! Implementation of logger ! ================================================
+
+#include "logger.h"
+
+const uint8_t LOG_MASK = LOG_BUFFER - 1;
+
+uint8_t logVarint(uint8_t *out, uint32_t v) {
+    uint8_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = v | 0x80;
+        v >>= 7;
+    }
+    out[n++] = v;
+    return n;
+}
+
+uint8_t logDepth() {
+    return (logger.head - logger.tail) & LOG_MASK;
+}
+
+// stamps and copies in one record with interrupts off. the ring always keeps
+// a byte free so head == tail only when it's empty
+bool logPut(uint8_t id, const uint8_t *args, uint8_t length) {
+    uint8_t       record[LOG_RECORD];
+    unsigned long now = millis();
+    uint8_t       n   = 0;
+    record[n++]       = 0x80 | id;
+    n += logVarint(record + n, now - logger.last);
+    memcpy(record + n, args, length);
+    n += length;
+
+    if (n + 1 > LOG_MASK - logDepth())
+        return false;
+    uint8_t head = logger.head;
+    logger.data[head] = n;
+    for (uint8_t i = 0; i < n; i++)
+        logger.data[(head + 1 + i) & LOG_MASK] = record[i];
+    logger.head = (head + 1 + n) & LOG_MASK;
+    logger.last = now;
+    logger.records++;
+    return true;
+}
+
+void logWrite(uint8_t id, const int32_t *args, uint8_t count) {
+    uint8_t encoded[LOG_ARGS * 5];
+    uint8_t length = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        int32_t v = args[i];
+        length += logVarint(encoded + length, uint32_t(v) << 1 ^ uint32_t(v >> 31));
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (logger.lost) {
+            uint8_t lost[5];
+            if (logPut(EVENT_DROPPED, lost, logVarint(lost, logger.lost << 1)))
+                logger.lost = 0;
+        }
+        if (logger.lost || !logPut(id, encoded, length)) {
+            logger.lost++;
+            logger.dropped++;
+        }
+    }
+}
+
+// only this moves tail, so a record can be read out without holding off the
+// writers, and goes to Serial whole
+void logDrain() {
+    while (logger.tail != logger.head) {
+        uint8_t tail = logger.tail;
+        uint8_t n    = logger.data[tail];
+        if (Serial.availableForWrite() < n)
+            return;
+        uint8_t record[LOG_RECORD];
+        for (uint8_t i = 0; i < n; i++)
+            record[i] = logger.data[(tail + 1 + i) & LOG_MASK];
+        Serial.write(record, n);
+        logger.tail = (tail + 1 + n) & LOG_MASK;
+    }
+}
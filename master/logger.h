@@ -0,0 +1,106 @@
+// ! Deferred Binary Logger ! ==================================================
+
+#pragma once
+#include <util/atomic.h>
+#include "events.h"
+
+// events go into a ring as compact binary records instead of being printed
+// as text, and logDrain() hands whole records to Serial while there is room
+// in its transmit buffer. logging costs a few dozen cycles wherever it is,
+// interrupts included, and never waits on the UART. a record that doesn't
+// fit is counted, and a DROPPED event goes out ahead of the next one that
+// does. host/logdecode turns the stream back into text
+//
+//   record  [0x80 | id][ms since last record][arg]...
+//
+// ids are below 0x80 and the rest are LEB128 varints, args zigzag signed, so
+// a byte with its top bit set outside a record starts one. anything else is
+// plain text, as setup() still prints. the ring keeps each record's length
+// in front of it, which isn't sent
+
+// levels, each compiled out with everything in its calls above LOG_LEVEL
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+const uint8_t LOG_BUFFER = 128;  // Ring size, a power of two
+const uint8_t LOG_ARGS   = 4;    // Most arguments to an event
+const uint8_t LOG_RECORD = 1 + 5 + LOG_ARGS * 5;  // Largest record
+
+// the arguments an event's format asks for, one per %
+constexpr uint8_t logArgs(const char *format) {
+    return *format == 0 ? 0 : (*format == '%') + logArgs(format + 1);
+}
+
+#define LOG_EVENT_ID(name, id, format) EVENT_##name = id,
+#define LOG_EVENT_ARGS(name, id, format) \
+    template <>                          \
+    struct logFormat<id> {               \
+        static const uint8_t args = logArgs(format); \
+    };
+
+enum logId : uint8_t { LOG_EVENTS(LOG_EVENT_ID) };
+
+template <uint8_t ID>
+struct logFormat;
+LOG_EVENTS(LOG_EVENT_ARGS)
+
+struct logBuffer {
+    uint8_t data[LOG_BUFFER];
+    volatile uint8_t
+        head,  // next byte written
+        tail;  // next byte sent
+    unsigned long
+        last,     // when the last record was written (ms)
+        records,  // written
+        lost,     // not written since the last DROPPED
+        dropped;  // not written, ever
+};
+
+struct logBuffer logger;
+
+void logWrite(uint8_t id, const int32_t *args, uint8_t count);
+
+// records an event, checking its arguments against the format at compile
+// time. safe from an interrupt
+template <uint8_t ID, typename... A>
+void logEvent(A... args) {
+    static_assert(sizeof...(A) == logFormat<ID>::args, "arguments don't match the event");
+    static_assert(sizeof...(A) <= LOG_ARGS, "too many arguments for a record");
+    const int32_t values[] = {int32_t(args)..., 0};
+    logWrite(ID, values, sizeof...(A));
+}
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(event, ...) logEvent<EVENT_##event>(__VA_ARGS__)
+#else
+#define LOG_ERROR(event, ...) ((void)0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(event, ...) logEvent<EVENT_##event>(__VA_ARGS__)
+#else
+#define LOG_WARN(event, ...) ((void)0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(event, ...) logEvent<EVENT_##event>(__VA_ARGS__)
+#else
+#define LOG_INFO(event, ...) ((void)0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(event, ...) logEvent<EVENT_##event>(__VA_ARGS__)
+#else
+#define LOG_DEBUG(event, ...) ((void)0)
+#endif
+
+// sends whole records while Serial can take them without blocking. call
+// when there is nothing better to do
+void logDrain();
+
+// bytes waiting in the ring
+uint8_t logDepth();
@@ -2,11 +2,21 @@
 
 #include <Arduino.h>
 #include <UTFTGLUE.h>
-#define ENCODER_DO_NOT_USE_INTERUPTS
-#include <Encoder.h>
+#include <alarm.h>
+#include <animation.h>
+#include <analysis.h>
+#include <baseline.h>
+#include <chart.h>
 #include <comm.h>
 #include <dial.h>
+#include <fixed.h>
+#include <i2c.h>
+#include <knobs.h>
+#include <logger.h>
+#include <memory.h>
 #include <pressure.h>
+#include <scheduler.h>
+#include <stream.h>
 #include <util.h>
 
 // * PINS ======================================================================
@@ -17,7 +27,7 @@ const uint8_t WR            = 56;  // LCD Write
 const uint8_t CS            = 55;  // Chip Select
 const uint8_t RST           = 54;  // Reset
 const uint8_t RD            = 58;  // LCD Read
-const uint8_t enc1dtPin     = 22;  // Encoder pins
+const uint8_t enc1dtPin     = 22;  // Encoder pins, 22 - 27 are fixed by knobs.h
 const uint8_t enc1clkPin    = 23;  // Encoder pins
 const uint8_t enc1buttonPin = 28;  // Encoder pins
 const uint8_t enc2dtPin     = 24;  // Encoder pins
@@ -34,41 +44,45 @@ const uint8_t slcPin4       = 37;  // Selector pins
 
 // * SPECIFICATIONS ============================================================
 
-const int     WIDTH     = 480;   // display px
-const int     HEIGHT    = 320;   // display px
-const float   MIN_TV    = 0.2;   // Min tidal volume (L)
-const float   MAX_TV    = 0.8;   // Max tidal volume (L)
-const float   INC_TV    = 0.02;  // Increments of volume (L)
-const uint8_t MIN_BPM   = 5;     // Min breaths per minute
-const uint8_t MAX_BPM   = 40;    // Max breaths per minute
-const uint8_t INC_BPM   = 1;     // Increments of breaths per minute
-const float   MIN_IT    = 0.5;   // Min inhale time (s)
-const float   MAX_IT    = 2.0;   // Max inhale time (s)
-const float   INC_IT    = 0.05;  // Increments of inhale time (s)
-const float   MIN_MV    = 4.0;   // Min minute volume (L)
-const float   MAX_MV    = 10.0;  // Max minute volume (L)
-const float   INC_MV    = 0.02;  // Increments of minute volume (L)
-const float   MIN_PEEP  = 5.0;   // Min positive-end expiratory pressure (cmH20)
-const float   MAX_PEEP  = 20.0;  // Max positive-end expiratory pressure (cmH20)
-const float   INC_PEEP  = 0.5;   // Increments of peep (cmH20)
-const float   MIN_PEAK  = 10.0;  // Min airway Pressure (cmH20)
-const float   MAX_PEAK  = 40.0;  // Max airway pressure (cmH20)
-const float   INC_PEAK  = 0.5;   // Increments of pressure (cmH20)
-const float   HIGH_PEAK = 35;    // Pressure over this is high
-const float   MAX_PLAT  = 30;    // Max plateau pressure
-
-const float   DEFAULT_TV   = 0.5;
+const int     WIDTH     = 480;        // display px
+const int     HEIGHT    = 320;        // display px
+const int     GUI_BAND  = 20;         // display px cleared between yields
+constexpr q16 MIN_TV    = q16(0.2);   // Min tidal volume (L)
+constexpr q16 MAX_TV    = q16(0.8);   // Max tidal volume (L)
+constexpr q16 INC_TV    = q16(0.02);  // Increments of volume (L)
+const uint8_t MIN_BPM   = 5;          // Min breaths per minute
+const uint8_t MAX_BPM   = 40;         // Max breaths per minute
+const uint8_t INC_BPM   = 1;          // Increments of breaths per minute
+constexpr q16 MIN_IT    = q16(0.5);   // Min inhale time (s)
+constexpr q16 MAX_IT    = q16(2.0);   // Max inhale time (s)
+constexpr q16 INC_IT    = q16(0.05);  // Increments of inhale time (s)
+constexpr q16 MIN_MV    = q16(4.0);   // Min minute volume (L)
+constexpr q16 MAX_MV    = q16(10.0);  // Max minute volume (L)
+constexpr q16 INC_MV    = q16(0.02);  // Increments of minute volume (L)
+constexpr q16 MIN_PEEP  = q16(5.0);   // Min positive-end expiratory pressure (cmH20)
+constexpr q16 MAX_PEEP  = q16(20.0);  // Max positive-end expiratory pressure (cmH20)
+constexpr q16 INC_PEEP  = q16(0.5);   // Increments of peep (cmH20)
+constexpr q16 MIN_PEAK  = q16(10.0);  // Min airway Pressure (cmH20)
+constexpr q16 MAX_PEAK  = q16(40.0);  // Max airway pressure (cmH20)
+constexpr q16 INC_PEAK  = q16(0.5);   // Increments of pressure (cmH20)
+constexpr q16 HIGH_PEAK = q16(35.0);  // Pressure over this is high
+constexpr q16 MAX_PLAT  = q16(30.0);  // Max plateau pressure
+
+constexpr q16 DEFAULT_TV   = q16(0.5);
 const uint8_t DEFAULT_BPM  = 12;
-const float   DEFAULT_IT   = 2.0;
-const float   DEFAULT_PEAK = 30;
-const float   DEFAULT_PEEP = 5.0;
+constexpr q16 DEFAULT_IT   = q16(2.0);
+constexpr q16 DEFAULT_PEAK = q16(30.0);
+constexpr q16 DEFAULT_PEEP = q16(5.0);
+
+// knob positions above the bottom of each scale
+const int VOLUME_POSITIONS = ((MAX_TV - MIN_TV) / INC_TV).round();
+const int BPM_POSITIONS    = (MAX_BPM - MIN_BPM) / INC_BPM;
+const int INHALE_POSITIONS = ((MAX_IT - MIN_IT) / INC_IT).round();
+const int PEAK_POSITIONS   = ((MAX_PEAK - MIN_PEAK) / INC_PEAK).round();
 
 // * OBJECTS ===================================================================
 
 UTFTGLUE display(DISPLAY_ID, RS, WR, CS, RST, RD);
-Encoder  enc1obj(enc1clkPin, enc1dtPin);
-Encoder  enc2obj(enc2clkPin, enc2dtPin);
-Encoder  enc3obj(enc3clkPin, enc3dtPin);
 
 // * GLOBALS ===================================================================
 
@@ -84,9 +98,17 @@ const int
     r1 = 70, r2 = 60,
     minDeg = 0, maxDeg = 270, offsetDeg = 45;
 
-bool
-    sweepRequired = false,  // true if a sweep is needed this breath cycle
-    sweepState    = false;  // true if currently in sweeping mode
+uint16_t cyclesShown = 0;  // slave breath last drawn on the current needles
+
+// ms from power up to each stage of the boot, logged once there's a breath
+struct stages {
+    unsigned long
+        sensor,  // pressure sensor answered
+        ui,      // dials and chart drawn
+        breath;  // first inhale seen
+    bool
+        reported;
+} boot;
 
 // * STRUCTURES ================================================================
 
@@ -114,213 +136,76 @@ struct encoder {
         previousCLK;
 } enc1, enc2, enc3;
 
-struct dial volume;
-struct dial bpm;
-struct dial inhale;
-struct dial peak;
-struct dial minute;
-struct dial peep;
+// the six dials, by position on the screen
+const uint8_t DIALS = 6;
+
+// minute volume is volume times rate, so its scale has a step for every pair
+// of their positions
+constexpr dialLayout dialLayouts[DIALS] PROGMEM = {
+    // x, y, min, max, inc, initial, labelX, valueX, precision, derived, label
+    {firstX, firstY, MIN_TV, MAX_TV, INC_TV, DEFAULT_TV, -22, -35, 2, 0, "v(L)"},
+    {secondX, secondY, q16(MIN_BPM), q16(MAX_BPM), q16(INC_BPM), q16(DEFAULT_BPM), -26, -20,
+     0, 0, "bpm"},
+    {thirdX, thirdY, MIN_IT, MAX_IT, INC_IT, DEFAULT_IT, -25, -35, 2, 0, "in(s)"},
+    {fourthX, fourthY, MIN_PEAK, MAX_PEAK, INC_PEAK, DEFAULT_PEAK, -30, -35, 1, 0, "peak"},
+    {fifthX, fifthY, MIN_MV, MAX_MV, (MAX_MV - MIN_MV) / (VOLUME_POSITIONS * BPM_POSITIONS),
+     DEFAULT_TV * q16(DEFAULT_BPM), -30, -35, 2, 1, "mv(L)"},
+    {sixthX, sixthY, MIN_PEEP, MAX_PEEP, INC_PEEP, DEFAULT_PEEP, -30, -35, 1, 0, "peep"},
+};
+
+struct dial dials[DIALS];
+struct dial
+    &volume = dials[0],
+    &bpm    = dials[1],
+    &inhale = dials[2],
+    &peak   = dials[3],
+    &minute = dials[4],
+    &peep   = dials[5];
+
+// * PROTOTYPES ================================================================
+
+void drawCenterLines();
+void drawMode1Heading();
+void drawMode2Heading();
+void drawMode3Heading();
+void drawMode4Heading();
 
 // * INIT DEFAULTS =============================================================
 
 void initDefaults() {
-    // volume dial parameters
-    volume.x               = firstX;
-    volume.y               = firstY;
-    volume.min             = MIN_TV;
-    volume.max             = MAX_TV;
-    volume.inc             = INC_TV;
-    volume.target          = DEFAULT_TV;
-    volume.current         = DEFAULT_TV;
-    volume.maxPosition     = (volume.max - volume.min) / volume.inc;
-    volume.targetPosition  = (volume.target - volume.min) / volume.inc;
-    volume.currentPosition = (volume.current - volume.min) / volume.inc;
-    volume.label           = "v(L)";
-    volume.precision       = 2;
-    volume.labelX          = volume.x - 22;
-    volume.labelY          = volume.y + 30;
-    volume.targetX         = volume.x - 35;
-    volume.targetY         = volume.y - 45;
-    volume.currentX        = volume.x - 35;
-    volume.currentY        = volume.y - 15;
-    volume.cutoutUpperY    = volume.y;
-    volume.cutoutLowerY    = volume.y + r1;
-    volume.cutoutStartX    = volume.x - r1;
-    volume.cutoutMidX      = volume.x;
-    volume.cutoutEndX      = volume.x + r1;
-
-    // bpm dial parameters
-    bpm.x               = secondX;
-    bpm.y               = secondY;
-    bpm.min             = MIN_BPM;
-    bpm.max             = MAX_BPM;
-    bpm.inc             = INC_BPM;
-    bpm.target          = DEFAULT_BPM;
-    bpm.current         = DEFAULT_BPM;
-    bpm.maxPosition     = (bpm.max - bpm.min) / bpm.inc;
-    bpm.targetPosition  = (bpm.target - bpm.min) / bpm.inc;
-    bpm.currentPosition = (bpm.current - bpm.min) / bpm.inc;
-    bpm.label           = "bpm";
-    bpm.precision       = 0;
-    bpm.labelX          = bpm.x - 26;
-    bpm.labelY          = bpm.y + 30;
-    bpm.targetX         = bpm.x - 20;
-    bpm.targetY         = bpm.y - 45;
-    bpm.currentX        = bpm.x - 20;
-    bpm.currentY        = bpm.y - 15;
-    bpm.cutoutUpperY    = bpm.y;
-    bpm.cutoutLowerY    = bpm.y + r1;
-    bpm.cutoutStartX    = bpm.x - r1;
-    bpm.cutoutMidX      = bpm.x;
-    bpm.cutoutEndX      = bpm.x + r1;
-
-    // inhale time dial perameters
-    inhale.x               = thirdX;
-    inhale.y               = thirdY;
-    inhale.min             = MIN_IT;
-    inhale.max             = MAX_IT;
-    inhale.inc             = INC_IT;
-    inhale.target          = DEFAULT_IT;
-    inhale.current         = DEFAULT_IT;
-    inhale.maxPosition     = (inhale.max - inhale.min) / inhale.inc;
-    inhale.targetPosition  = (inhale.target - inhale.min) / inhale.inc;
-    inhale.currentPosition = (inhale.current - inhale.min) / inhale.inc;
-    inhale.label           = "in(s)";
-    inhale.precision       = 2;
-    inhale.labelX          = inhale.x - 25;
-    inhale.labelY          = inhale.y + 30;
-    inhale.targetX         = inhale.x - 35;
-    inhale.targetY         = inhale.y - 45;
-    inhale.currentX        = inhale.x - 35;
-    inhale.currentY        = inhale.y - 15;
-    inhale.cutoutUpperY    = inhale.y;
-    inhale.cutoutLowerY    = inhale.y + r1;
-    inhale.cutoutStartX    = inhale.x - r1;
-    inhale.cutoutMidX      = inhale.x;
-    inhale.cutoutEndX      = inhale.x + r1;
-
-    // peak pressure dial perameters
-    peak.x               = fourthX;
-    peak.y               = fourthY;
-    peak.min             = MIN_PEAK;
-    peak.max             = MAX_PEAK;
-    peak.inc             = INC_PEAK;
-    peak.target          = DEFAULT_PEAK;
-    peak.current         = DEFAULT_PEAK;
-    peak.maxPosition     = (peak.max - peak.min) / peak.inc;
-    peak.targetPosition  = (peak.target - peak.min) / peak.inc;
-    peak.currentPosition = (peak.current - peak.min) / peak.inc;
-    peak.label           = "peak";
-    peak.precision       = 1;
-    peak.labelX          = peak.x - 30;
-    peak.labelY          = peak.y + 30;
-    peak.targetX         = peak.x - 35;
-    peak.targetY         = peak.y - 45;
-    peak.currentX        = peak.x - 35;
-    peak.currentY        = peak.y - 15;
-    peak.cutoutUpperY    = peak.y;
-    peak.cutoutLowerY    = peak.y + r1;
-    peak.cutoutStartX    = peak.x - r1;
-    peak.cutoutMidX      = peak.x;
-    peak.cutoutEndX      = peak.x + r1;
-
-    // minute volume dial perameters
-    minute.x               = fifthX;
-    minute.y               = fifthY;
-    minute.min             = MIN_MV;
-    minute.max             = MAX_MV;
-    minute.target          = volume.target * bpm.target;
-    minute.current         = volume.current * bpm.current;
-    minute.maxPosition     = volume.maxPosition * bpm.maxPosition;
-    minute.inc             = (minute.max - minute.min) / minute.maxPosition;
-    minute.targetPosition  = (minute.target - minute.min) / minute.inc;
-    minute.currentPosition = (minute.current - minute.min) / minute.inc;
-    minute.label           = "mv(L)";
-    minute.errorUpper      = String(">" + String(minute.max, 0));
-    minute.errorLower      = String("<" + String(minute.min, 0));
-    minute.precision       = 2;
-    minute.labelX          = minute.x - 30;
-    minute.labelY          = minute.y + 30;
-    minute.targetX         = minute.x - 35;
-    minute.targetY         = minute.y - 45;
-    minute.currentX        = minute.x - 35;
-    minute.currentY        = minute.y - 15;
-    minute.errorX          = minute.x - 35;
-    minute.errorY          = minute.y - 30;
-    minute.cutoutUpperY    = minute.y;
-    minute.cutoutLowerY    = minute.y + r1;
-    minute.cutoutStartX    = minute.x - r1;
-    minute.cutoutMidX      = minute.x;
-    minute.cutoutEndX      = minute.x + r1;
-
-    // peep pressure dial perameters
-    peep.x               = sixthX;
-    peep.y               = sixthY;
-    peep.min             = MIN_PEEP;
-    peep.max             = MAX_PEEP;
-    peep.inc             = INC_PEEP;
-    peep.target          = DEFAULT_PEEP;
-    peep.current         = DEFAULT_PEEP;
-    peep.maxPosition     = (peep.max - peep.min) / peep.inc;
-    peep.targetPosition  = (peep.target - peep.min) / peep.inc;
-    peep.currentPosition = (peep.current - peep.min) / peep.inc;
-    peep.label           = "peep";
-    peep.precision       = 1;
-    peep.labelX          = peep.x - 30;
-    peep.labelY          = peep.y + 30;
-    peep.targetX         = peep.x - 35;
-    peep.targetY         = peep.y - 45;
-    peep.currentX        = peep.x - 35;
-    peep.currentY        = peep.y - 15;
-    peep.cutoutUpperY    = peep.y;
-    peep.cutoutLowerY    = peep.y + r1;
-    peep.cutoutStartX    = peep.x - r1;
-    peep.cutoutMidX      = peep.x;
-    peep.cutoutEndX      = peep.x + r1;
+    for (uint8_t i = 0; i < DIALS; i++)
+        dialBegin(&dials[i], &dialLayouts[i]);
 }
 
 // * DRAWING ===================================================================
 
+// the screen is cleared in bands and the dials drawn one at a time, with a
+// yield after each, as the whole lot is a few hundred milliseconds
 void drawDialGUI() {
-    display.clrScr();
-    display.fillScr(0, 43, 54);  // c.back
-
-    drawDialBase(volume);
-    drawDialBase(bpm);
-    drawDialBase(inhale);
-    drawDialBase(peak);
-    drawDialBase(minute);
-    drawDialBase(peep);
-
-    updateTargetByPosition(&volume);
-    updateCurrentByPosition(&volume);
-    drawTargetElements(&volume);
-    drawCurrentElements(&volume);
-
-    updateTargetByPosition(&bpm);
-    updateCurrentByPosition(&bpm);
-    drawTargetElements(&bpm);
-    drawCurrentElements(&bpm);
-
-    updateTargetByPosition(&inhale);
-    updateCurrentByPosition(&inhale);
-    drawTargetElements(&inhale);
-    drawCurrentElements(&inhale);
-
-    updateTargetByPosition(&peak);
-    updateCurrentByPosition(&peak);
-    drawTargetElements(&peak);
-    drawCurrentElements(&peak);
-
-    updateTargetByValue(&minute);
-    updateCurrentByValue(&minute);
-    drawTargetElements(&minute);
-    drawCurrentElements(&minute);
-
-    updateTargetByPosition(&peep);
-    updateCurrentByPosition(&peep);
-    drawTargetElements(&peep);
-    drawCurrentElements(&peep);
+    for (int y = 0; y < HEIGHT; y += GUI_BAND) {
+        display.fillRect(0, y, WIDTH, GUI_BAND, c.back);
+        schedulerYield();
+    }
+
+    for (uint8_t i = 0; i < DIALS; i++) {
+        drawDialBase(&dials[i]);
+        schedulerYield();
+    }
+
+    // a derived dial can start out of range, the rest start on a position
+    for (uint8_t i = 0; i < DIALS; i++) {
+        dial *d = &dials[i];
+        if (pgm_read_byte(&dialLayouts[i].derived)) {
+            updateTargetByValue(d);
+            updateCurrentByValue(d);
+        } else {
+            updateTargetByPosition(d);
+            updateCurrentByPosition(d);
+        }
+        drawTargetElements(d);
+        drawCurrentElements(d);
+        schedulerYield();
+    }
 
     drawCenterLines();
 }
@@ -348,7 +233,7 @@ const int
     // Heading Center
     mode1X = 100,
     mode2X = 70,
-    mode3X = 50,
+    mode3X = 35,
     mode4X = 35,
     modeY  = -15;
 
@@ -374,19 +259,19 @@ void clearModeHeading() {
 }
 
 void drawMode1Heading() {
-    display.print(String("Disable"), mode1X, modeY);
+    display.print("Disable", mode1X, modeY);
 }
 
 void drawMode2Heading() {
-    display.print(String("Mandatory Mode"), mode2X, modeY);
+    display.print("Mandatory Mode", mode2X, modeY);
 }
 
 void drawMode3Heading() {
-    display.print(String("Assist Control"), mode3X, modeY);
+    display.print("Pressure Control", mode3X, modeY);
 }
 
 void drawMode4Heading() {
-    display.print(String("Spontaneous Only"), mode4X, modeY);
+    display.print("Spontaneous Only", mode4X, modeY);
 }
 
 // * INPUT =====================================================================
@@ -404,6 +289,7 @@ void checkSelector() {
 
     if (select.modeCurrent != select.modePrevious) {
         clearModeHeading();
+        schedulerYield();  // each heading is a few milliseconds of pixels
         select.mode = select.modeCurrent;
         drawModeHeading();
     }
@@ -411,23 +297,24 @@ void checkSelector() {
     select.modePrevious = select.modeCurrent;
 }
 
-// Count encoder movement
-int countEncoders() {
-    enc1.counterCurrent = enc1obj.read() / 2;
-    enc2.counterCurrent = enc2obj.read() / 2;
-    enc3.counterCurrent = enc3obj.read() / 2;
+// Count encoder movement, in detents. the counters wrap at 16 bits whatever
+// the size of int, and are only ever differenced
+void countEncoders() {
+    enc1.counterCurrent = int16_t(uint16_t(enc1.counter) + uint16_t(knobDetents(0)));
+    enc2.counterCurrent = int16_t(uint16_t(enc2.counter) + uint16_t(knobDetents(1)));
+    enc3.counterCurrent = int16_t(uint16_t(enc3.counter) + uint16_t(knobDetents(2)));
 
     if (enc1.counterCurrent != enc1.counter) {
         enc1.counter = enc1.counterCurrent;
-        Serial.println("encoder 1 counter " + String(enc1.counter));
+        LOG_DEBUG(ENCODER_COUNTER, 1, enc1.counter);
     }
     if (enc2.counterCurrent != enc2.counter) {
         enc2.counter = enc2.counterCurrent;
-        Serial.println("encoder 2 counter " + String(enc2.counter));
+        LOG_DEBUG(ENCODER_COUNTER, 2, enc2.counter);
     }
     if (enc3.counterCurrent != enc3.counter) {
         enc3.counter = enc3.counterCurrent;
-        Serial.println("encoder 3 counter " + String(enc3.counter));
+        LOG_DEBUG(ENCODER_COUNTER, 3, enc3.counter);
     }
 }
 
@@ -435,76 +322,66 @@ int countEncoders() {
 void checkButtons() {
     enc1.buttonCurrent = digitalRead(enc1buttonPin);
     if (enc1.buttonCurrent != enc1.buttonPrevious && enc1.buttonCurrent == HIGH) {
-        sweepSetup();
-        Serial.println("encoder 1 pressed");
+        LOG_INFO(ENCODER_PRESSED, 1);
     }
     enc1.buttonPrevious = enc1.buttonCurrent;
 
     enc2.buttonCurrent = digitalRead(enc2buttonPin);
     if (enc2.buttonCurrent != enc2.buttonPrevious && enc2.buttonCurrent == HIGH) {
-        //sweepSetup();
-        Serial.println("encoder 2 pressed");
+        LOG_INFO(ENCODER_PRESSED, 2);
+        alarmAcknowledge();  // ends the alarms that latched and have gone
     }
     enc2.buttonPrevious = enc2.buttonCurrent;
 
     enc3.buttonCurrent = digitalRead(enc3buttonPin);
     if (enc3.buttonCurrent != enc3.buttonPrevious && enc3.buttonCurrent == HIGH) {
-        //sweepSetup();
-        Serial.println("encoder 3 pressed");
+        LOG_INFO(ENCODER_PRESSED, 3);
     }
     enc3.buttonPrevious = enc3.buttonCurrent;
 }
 
 // * UPDATES ===================================================================
 
-// Constrain change in encoder position to within operating range
-// Runs drawing logic when position updates
+// Constrain change in encoder position to within operating range, a fast
+// turn moving further than a slow one, see knobPositions()
+// Runs drawing logic when position updates. In pressure control the volume
+// is whatever the peak gives, so the first knob sets the peak instead
 void updateTargets() {
-    float volumeRange = volume.max - volume.min;
-    float bpmRange    = bpm.max - bpm.min;
-    float inhaleRange = inhale.max - inhale.min;
-
-    // 1 or -1 for pos and neg direction
-    enc1.counterDirection = enc1.counter - enc1.counterPrevious;
-    if (enc1.counterDirection > 0 && volume.targetPosition < volume.maxPosition) {
-        volume.targetPosition++;
-        Serial.println("Volume Position: " + String(volume.targetPosition));
-    }
-    if (enc1.counterDirection < 0 && volume.targetPosition > 0) {
-        volume.targetPosition--;
-        Serial.println("Volume Position: " + String(volume.targetPosition));
+    enc1.counterDirection = int16_t(uint16_t(enc1.counter) - uint16_t(enc1.counterPrevious));
+    if (enc1.counterDirection && select.mode == MODE_PRESSURE) {
+        peak.targetPosition = constrain(
+            peak.targetPosition + knobPositions(enc1.counterDirection), 0, PEAK_POSITIONS);
+        LOG_DEBUG(PEAK_POSITION, peak.targetPosition);
+        peak.direction = enc1.counterDirection;
+        updateTargetByPosition(&peak);
+        drawTargetElements(&peak);
+        chartReference(peep.target, peak.target);
+        enc1.counterDirection = 0;
     }
     if (enc1.counterDirection) {
+        volume.targetPosition = constrain(
+            volume.targetPosition + knobPositions(enc1.counterDirection), 0, VOLUME_POSITIONS);
+        LOG_DEBUG(VOLUME_POSITION, volume.targetPosition);
         volume.direction = enc1.counterDirection;
         updateTargetByPosition(&volume);
         drawTargetElements(&volume);
     }
 
-    enc2.counterDirection = enc2.counter - enc2.counterPrevious;
-    if (enc2.counterDirection > 0 && bpm.targetPosition < bpm.maxPosition) {
-        bpm.targetPosition++;
-        Serial.println("bpm Position: " + String(bpm.targetPosition));
-    }
-    if (enc2.counterDirection < 0 && bpm.targetPosition > 0) {
-        bpm.targetPosition--;
-        Serial.println("bpm Position: " + String(bpm.targetPosition));
-    }
+    enc2.counterDirection = int16_t(uint16_t(enc2.counter) - uint16_t(enc2.counterPrevious));
     if (enc2.counterDirection) {
+        bpm.targetPosition = constrain(
+            bpm.targetPosition + knobPositions(enc2.counterDirection), 0, BPM_POSITIONS);
+        LOG_DEBUG(BPM_POSITION, bpm.targetPosition);
         bpm.direction = enc2.counterDirection;
         updateTargetByPosition(&bpm);
         drawTargetElements(&bpm);
     }
 
-    enc3.counterDirection = enc3.counter - enc3.counterPrevious;
-    if (enc3.counterDirection > 0 && inhale.targetPosition < inhale.maxPosition) {
-        inhale.targetPosition++;
-        Serial.println("inhale Position: " + String(inhale.targetPosition));
-    }
-    if (enc3.counterDirection < 0 && inhale.targetPosition > 0) {
-        inhale.targetPosition--;
-        Serial.println("inhale Position: " + String(inhale.targetPosition));
-    }
+    enc3.counterDirection = int16_t(uint16_t(enc3.counter) - uint16_t(enc3.counterPrevious));
     if (enc3.counterDirection) {
+        inhale.targetPosition = constrain(
+            inhale.targetPosition + knobPositions(enc3.counterDirection), 0, INHALE_POSITIONS);
+        LOG_DEBUG(INHALE_POSITION, inhale.targetPosition);
         inhale.direction = enc3.counterDirection;
         updateTargetByPosition(&inhale);
         drawTargetElements(&inhale);
@@ -527,107 +404,157 @@ void updateTargets() {
     enc3.counterPrevious  = enc3.counter;
 }
 
-// Update the sweep values for display when breath cycle complete is returned
-// from the slave
-void updateSweeps() {
-    if (sweepRequired && sweepState) {
-        if (volume.currentPosition < volume.targetPosition) {
-            volume.currentPosition++;
-            updateCurrentByPosition(&volume);
-            drawCurrentElements(&volume);
-        }
-
-        if (volume.targetPosition < volume.currentPosition) {
-            volume.currentPosition--;
-            updateCurrentByPosition(&volume);
-            drawCurrentElements(&volume);
-        }
+// Sweep the volume, inhale time and rate the slave reports for its last
+// breath onto the current side of their dials
+void updateDelivered() {
+    pollSlave();
+    if (delivered.cycles == cyclesShown)
+        return;
+    cyclesShown = delivered.cycles;
 
-        if (bpm.currentPosition < bpm.targetPosition) {
-            bpm.currentPosition++;
-            updateCurrentByPosition(&bpm);
-            drawCurrentElements(&bpm);
-        }
+    animateTo(&volume, q16(delivered.volume) / 1000);
+    if (delivered.inhaleTime)
+        animateTo(&inhale, q16(delivered.inhaleTime) / 1000);
 
-        if (bpm.targetPosition < bpm.currentPosition) {
-            bpm.currentPosition--;
-            updateCurrentByPosition(&bpm);
-            drawCurrentElements(&bpm);
-        }
+    // 60000 / ms doesn't fit Q15.16 on the way, 6000 / ms * 10 does
+    if (delivered.cycleTime)
+        animateTo(&bpm, q16(6000) / delivered.cycleTime * 10);
 
-        if (inhale.currentPosition < inhale.targetPosition) {
-            inhale.currentPosition++;
-            updateCurrentByPosition(&inhale);
-            drawCurrentElements(&inhale);
-        }
+    animateTo(&minute, animationTo(&volume) * animationTo(&bpm));
+}
 
-        if (inhale.targetPosition < inhale.currentPosition) {
-            inhale.currentPosition--;
-            updateCurrentByPosition(&inhale);
-            drawCurrentElements(&inhale);
-        }
+// Sweep the peak and peep of the last breath onto the current side of their
+// dials
+void updateReadings() {
+    if (!analysis.done)
+        return;
+    analysis.done = false;
 
-        minute.current = volume.current * bpm.current;
-        updateCurrentByValue(&minute);
-        drawCurrentElements(&minute);
+    animateTo(&peak, cmH20.peak);
+    animateTo(&peep, cmH20.peep);
+}
 
-        if (volume.targetPosition == volume.currentPosition)
-            if (inhale.targetPosition == inhale.currentPosition)
-                if (bpm.targetPosition == bpm.currentPosition)
-                    sweepState = false;
+// * TASKS =====================================================================
+
+// pressure is polled well inside a conversion so the sampler stays on its
+// grid, and each sample goes through the alarms within a millisecond of
+// landing, ahead of everything else, then out to the slave in pressure
+// control. it's analysed at the sensor rate, with
+// the baseline refined on the same samples, the knobs' counts from the timer
+// interrupt and the buttons are read at 1 kHz, the screen goes up once ahead
+// of anything else that draws, the chart takes a column's worth of samples at
+// the sensor rate, the needles sweep at a frame rate, and everything else that
+// draws runs at a screen rate below the lot of them
+
+void analysisTask() {
+    cmH20.airway = getAirway();
+    analysisUpdate();
+    baselineUpdate();
+    if (!boot.breath && analysis.phase)
+        boot.breath = millis();
+}
 
-        sweepRequired = false;
+// the screen is drawn from here rather than setup(), so the sensor and the
+// alarms are running while it goes up. it's ahead of everything that draws,
+// so nothing draws on the screen before it's there
+void bootTask() {
+    if (!boot.ui) {
+        drawDialGUI();
+        chartBegin(peep.target, peak.target);
+        boot.ui = millis();
     }
+    if (boot.reported || !boot.breath || !baseline.settled)
+        return;
+    boot.reported = true;
+    LOG_INFO(BOOT, boot.sensor, boot.ui, baseline.settledAt, boot.breath);
 }
 
-void sweepSetup() {
-    if (minute.error == 0) {
-        sweepState = true;
-    } else {
-        sweepState = false;
-    }
+void inputTask() {
+    countEncoders();
+    checkButtons();
 }
 
+// the slave is polled off analysis.done, which updateReadings() clears, so
+// they stay in this order in one task. neither draws, the animate task does
+void readingsTask() {
+    updateDelivered();
+    updateReadings();
+}
+
+void memoryTask() {
+    memoryUpdate(t.current);
+}
+
+// task names for the cosim report, kept in flash
+const char taskI2c[]        PROGMEM = "i2c";
+const char taskPressure[]   PROGMEM = "pressure";
+const char taskAlarm[]      PROGMEM = "alarm";
+const char taskStream[]     PROGMEM = "stream";
+const char taskAnalysis[]   PROGMEM = "analysis";
+const char taskInput[]      PROGMEM = "input";
+const char taskBoot[]       PROGMEM = "boot";
+const char taskChart[]      PROGMEM = "chart";
+const char taskComm[]       PROGMEM = "comm";
+const char taskTargets[]    PROGMEM = "targets";
+const char taskReadings[]   PROGMEM = "readings";
+const char taskAnimate[]    PROGMEM = "animate";
+const char taskSelector[]   PROGMEM = "selector";
+const char taskShowAlarm[]  PROGMEM = "showAlarm";
+const char taskMemory[]     PROGMEM = "memory";
+
+task tasks[] = {
+    // name, run, period (us), priority
+    {taskI2c, i2cUpdate, 500, 0},
+    {taskPressure, pressureUpdate, 1000, 1},
+    {taskAlarm, alarmUpdate, 1000, 2},
+    {taskStream, streamUpdate, 1000, 3},
+    {taskAnalysis, analysisTask, PRESSURE_PERIOD, 4},
+    {taskInput, inputTask, 1000, 5},
+    {taskBoot, bootTask, 20000, 6},
+    {taskChart, chartUpdate, PRESSURE_PERIOD, 7},
+    {taskComm, openHailingFrequency, 20000, 8},
+    {taskTargets, updateTargets, 20000, 9},
+    {taskReadings, readingsTask, 50000, 10},
+    {taskAnimate, animationFrame, ANIMATION_FRAME, 11},
+    {taskSelector, checkSelector, 50000, 12},
+    {taskShowAlarm, alarmShow, 50000, 13},
+    {taskMemory, memoryTask, 100000, 14},
+};
+
 // * MAIN START ================================================================
 
 void setup() {
-    Wire.begin();
+    memoryBegin();
+    i2cBegin();
 
+    // nothing waits on a serial host, the prints go nowhere without one
     Serial.begin(115200);
-    while (!Serial) {
-        ;  // wait till connected
-    }
-    Serial.println("Begin");
+    Serial.println(F("Begin"));
 
-    if (!sensor.begin(PRESSURE_ID)) {
-        Serial.println("Can't connect to pressure sensor");
+    delay(10);  // sensor startup
+    if (pressureReadStatus() != PRESSURE_POWERED) {
+        Serial.println(F("Can't connect to pressure sensor"));
         while (1) {
             delay(10);
         }
     }
-    Serial.println("Pressure sensor found");
+    Serial.println(F("Pressure sensor found"));
 
     pressureSensorCheck();
+    boot.sensor = millis();
 
-    // calibrate baseline pressure from average over 1 second
-    float sum = 0.0;
-    float num = 0;
-    Serial.println("Calibrating baseline pressure...");
-    while (num < 100) {
-        sum = getPressure() + sum;
-        delay(10);
-        num++;
-    }
-    cmH20.atmosphere = sum / num;
-    Serial.println("Calibration complete.");
-    Serial.println("Baseline Pressure: " + String(cmH20.atmosphere, 2));
-
+    // the display's own reset is the one wait left, so it's over before the
+    // sensor's schedule starts. the rest of the screen is the boot task's
     pinMode(RD, OUTPUT);
     digitalWrite(RD, HIGH);
-
     display.InitLCD();
+    glyphsBegin();
     initDefaults();
-    drawDialGUI();
+
+    char text[12];
+    baselineBegin();
+    Serial.print(baseline.cached ? F("Cached baseline: ") : F("Sampled baseline: "));
+    Serial.println(cmH20.atmosphere.format(text, 2));
 
     pinMode(enc1buttonPin, INPUT_PULLUP);
     pinMode(enc1dtPin, INPUT_PULLUP);
@@ -643,29 +570,27 @@ void setup() {
     pinMode(enc3dtPin, INPUT_PULLUP);
     pinMode(enc3clkPin, INPUT_PULLUP);
     enc3.buttonPrevious = digitalRead(enc3buttonPin);
+    knobsBegin();
 
     pinMode(slcPin1, INPUT_PULLUP);
     pinMode(slcPin2, INPUT_PULLUP);
     pinMode(slcPin3, INPUT_PULLUP);
     pinMode(slcPin4, INPUT_PULLUP);
 
+    pressureBegin();
+    analysisBegin();
+    alarmBegin();
+    uploadBegin();
+    memoryMark();
+    schedulerBegin(tasks, sizeof(tasks) / sizeof(tasks[0]), logDrain);
+
     t.previous = millis();
-    Serial.println("End");
+    Serial.println(F("End"));
 }
 
 void loop() {
     t.current = millis();
-    checkSelector();
-    countEncoders();
-    checkButtons();
-    updateTargets();
-    updateSweeps();
-    openHailingFrequency();
-
-    if (pressureSensorReady()) {
-        cmH20.airway = getAirway();
-        //Serial.println("Airway Pressure: " + String(cmH20.airway, 1));
-    }
+    schedulerRun();
 }
 
 // * MAIN END ==================================================================
\ No newline at end of file
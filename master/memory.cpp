@@ -0,0 +1,90 @@
+// ! Implementation of memory ! ================================================
+
+#include "memory.h"
+
+#ifdef __AVR__
+extern char  __heap_start, *__brkval;  // from avr-libc's malloc
+extern void *__flp;
+
+char *memoryHeapEnd() {
+    return __brkval ? __brkval : &__heap_start;
+}
+
+char *memoryStack() {
+    return (char *)SP;
+}
+
+void *memoryFreeList() {
+    return __flp;
+}
+
+unsigned long memoryStrings() {
+    return 0;
+}
+#else
+// the host's heap and stack aren't the sketch's, only its Strings are counted
+char *memoryHeapEnd() {
+    return 0;
+}
+
+char *memoryStack() {
+    return 0;
+}
+
+void *memoryFreeList() {
+    return 0;
+}
+
+unsigned long memoryStrings() {
+    return hal::current()->strings;
+}
+#endif
+
+uint16_t memoryFree() {
+    return memoryStack() - memoryHeapEnd();
+}
+
+// stops MEMORY_GUARD short of the stack pointer, as an interrupt taken while
+// painting pushes its frame there
+void memoryBegin() {
+    char    *p    = memoryHeapEnd();
+    uint16_t free = memoryFree();
+    for (uint16_t i = 0; i + MEMORY_GUARD < free; i++)
+        p[i] = MEMORY_PAINT;
+}
+
+// the heap as it is now, so a change is counted once
+void memoryTake() {
+    memory.heapEnd  = memoryHeapEnd();
+    memory.freeList = memoryFreeList();
+    memory.strings  = memoryStrings();
+}
+
+void memoryMark() {
+    memoryTake();
+    memory.reported = millis();
+}
+
+uint16_t memoryStackUnused() {
+    const char *p    = memoryHeapEnd();
+    uint16_t    free = memoryFree();
+    uint16_t    n    = 0;
+    while (n < free && uint8_t(p[n]) == MEMORY_PAINT)
+        n++;
+    return n;
+}
+
+void memoryUpdate(unsigned long now) {
+    if (memoryHeapEnd() != memory.heapEnd || memoryFreeList() != memory.freeList ||
+        memoryStrings() != memory.strings) {
+        memory.heapChanges++;
+        LOG_WARN(HEAP_CHANGED, memoryHeapEnd() - memory.heapEnd);
+        memoryTake();
+    }
+
+    if (now - memory.reported >= MEMORY_REPORT_PERIOD) {
+        memory.reported += MEMORY_REPORT_PERIOD;
+        memory.stackUnused = memoryStackUnused();
+        LOG_INFO(MEMORY, memoryFree(), memory.stackUnused, memory.heapChanges);
+    }
+}
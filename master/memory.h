@@ -0,0 +1,46 @@
+// ! SRAM Watermarks ! =========================================================
+
+#pragma once
+#include "logger.h"
+
+// nothing is allocated once setup() is done, so the heap stays where setup()
+// left it and all the SRAM above it belongs to the stack. memoryBegin() fills
+// that space with MEMORY_PAINT, and the lowest byte the stack has ever reached
+// is the first one above the heap that isn't paint any more. memoryUpdate()
+// watches the heap for any change after memoryMark(), and every
+// MEMORY_REPORT_PERIOD logs the space free now and the stack never touched.
+// the host has no SRAM to measure, there the heap is the String objects made
+
+const uint8_t       MEMORY_PAINT         = 0xC5;
+const uint8_t       MEMORY_GUARD         = 64;     // Left unpainted below the stack pointer
+const unsigned long MEMORY_REPORT_PERIOD = 10000;  // Report period (ms)
+
+struct memoryState {
+    char *heapEnd;   // end of the heap as set up
+    void *freeList;  // head of the heap's free list as set up
+    unsigned long
+        strings,   // host only, String objects made as set up
+        reported;  // ms
+    uint16_t
+        stackUnused,  // painted bytes the stack has never reached
+        heapChanges;  // times the heap was seen to move after setup()
+};
+
+struct memoryState memory;
+
+// paints the free SRAM, first thing in setup()
+void memoryBegin();
+
+// takes the heap as it is as set up, last thing in setup()
+void memoryMark();
+
+// bytes between the end of the heap and the stack pointer
+uint16_t memoryFree();
+
+// painted bytes above the heap that the stack has never written. a scan from
+// the end of the heap, a few cycles a byte
+uint16_t memoryStackUnused();
+
+// cheap enough to call every pass with the time in ms, the stack scan only
+// runs when it reports
+void memoryUpdate(unsigned long now);
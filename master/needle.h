@@ -0,0 +1,286 @@
+// ! Needle Geometry ! =========================================================
+
+// generated by host/needlegen, do not edit
+// x,y offsets from the dial origin of needle points 1 to 6 for each whole
+// angle from NEEDLE_MIN_ANGLE to NEEDLE_MAX_ANGLE, see buildNeedle()
+
+#pragma once
+
+#define NEEDLE_R1 70
+#define NEEDLE_R2 60
+#define NEEDLE_MIN_ANGLE -45
+#define NEEDLE_MAX_ANGLE 225
+
+const int8_t needleOffsets[271][12] PROGMEM = {
+    {47, 52, 50, 50, 52, 47, 40, 45, 43, 43, 45, 40},  // -45
+    {48, 51, 51, 49, 53, 46, 41, 44, 43, 42, 46, 40},  // -44
+    {49, 51, 51, 48, 54, 45, 42, 43, 44, 41, 46, 39},  // -43
+    {50, 50, 52, 47, 55, 44, 43, 43, 45, 40, 47, 38},  // -42
+    {51, 49, 53, 46, 55, 43, 43, 42, 46, 40, 48, 37},  // -41
+    {51, 48, 54, 45, 56, 42, 44, 41, 46, 39, 48, 36},  // -40
+    {52, 47, 55, 44, 57, 41, 45, 40, 47, 38, 49, 35},  // -39
+    {53, 46, 55, 43, 58, 40, 46, 40, 48, 37, 49, 34},  // -38
+    {54, 45, 56, 42, 58, 39, 46, 39, 48, 36, 50, 34},  // -37
+    {55, 44, 57, 41, 59, 38, 47, 38, 49, 35, 51, 33},  // -36
+    {55, 43, 58, 40, 60, 37, 48, 37, 49, 34, 51, 32},  // -35
+    {56, 42, 58, 39, 60, 36, 48, 36, 50, 34, 52, 31},  // -34
+    {57, 41, 59, 38, 61, 35, 49, 35, 51, 33, 52, 30},  // -33
+    {58, 40, 60, 37, 62, 34, 49, 34, 51, 32, 53, 29},  // -32
+    {58, 39, 60, 36, 62, 33, 50, 34, 52, 31, 53, 28},  // -31
+    {59, 38, 61, 35, 63, 32, 51, 33, 52, 30, 54, 27},  // -30
+    {60, 37, 62, 34, 63, 31, 51, 32, 53, 29, 54, 26},  // -29
+    {60, 36, 62, 33, 64, 30, 52, 31, 53, 28, 55, 25},  // -28
+    {61, 35, 63, 32, 64, 28, 52, 30, 54, 27, 55, 24},  // -27
+    {62, 34, 63, 31, 65, 27, 53, 29, 54, 26, 56, 23},  // -26
+    {62, 33, 64, 30, 65, 26, 53, 28, 55, 25, 56, 22},  // -25
+    {63, 32, 64, 28, 66, 25, 54, 27, 55, 24, 56, 21},  // -24
+    {63, 31, 65, 27, 66, 24, 54, 26, 56, 23, 57, 20},  // -23
+    {64, 30, 65, 26, 67, 23, 55, 25, 56, 22, 57, 19},  // -22
+    {64, 28, 66, 25, 67, 21, 55, 24, 56, 21, 58, 18},  // -21
+    {65, 27, 66, 24, 67, 20, 56, 23, 57, 20, 58, 17},  // -20
+    {65, 26, 67, 23, 68, 19, 56, 22, 57, 19, 58, 16},  // -19
+    {66, 25, 67, 21, 68, 18, 56, 21, 58, 18, 58, 15},  // -18
+    {66, 24, 67, 20, 68, 17, 57, 20, 58, 17, 59, 14},  // -17
+    {67, 23, 68, 19, 69, 15, 57, 19, 58, 16, 59, 13},  // -16
+    {67, 21, 68, 18, 69, 14, 58, 18, 58, 15, 59, 12},  // -15
+    {67, 20, 68, 17, 69, 13, 58, 17, 59, 14, 59, 11},  // -14
+    {68, 19, 69, 15, 69, 12, 58, 16, 59, 13, 60, 10},  // -13
+    {68, 18, 69, 14, 70, 11, 58, 15, 59, 12, 60, 9},  // -12
+    {68, 17, 69, 13, 70, 9, 59, 14, 59, 11, 60, 8},  // -11
+    {69, 15, 69, 12, 70, 8, 59, 13, 60, 10, 60, 7},  // -10
+    {69, 14, 70, 11, 70, 7, 59, 12, 60, 9, 60, 6},  // -9
+    {69, 13, 70, 9, 70, 6, 59, 11, 60, 8, 60, 5},  // -8
+    {69, 12, 70, 8, 70, 4, 60, 10, 60, 7, 60, 4},  // -7
+    {70, 11, 70, 7, 70, 3, 60, 9, 60, 6, 60, 3},  // -6
+    {70, 9, 70, 6, 70, 2, 60, 8, 60, 5, 60, 2},  // -5
+    {70, 8, 70, 4, 70, 1, 60, 7, 60, 4, 60, 1},  // -4
+    {70, 7, 70, 3, 71, 0, 60, 6, 60, 3, 61, 0},  // -3
+    {70, 6, 70, 2, 70, -1, 60, 5, 60, 2, 60, -1},  // -2
+    {70, 4, 70, 1, 70, -2, 60, 4, 60, 1, 60, -2},  // -1
+    {70, 3, 71, 0, 70, -3, 60, 3, 61, 0, 60, -3},  // 0
+    {70, 2, 70, -1, 70, -4, 60, 2, 60, -1, 60, -4},  // 1
+    {70, 1, 70, -2, 70, -6, 60, 1, 60, -2, 60, -5},  // 2
+    {71, 0, 70, -3, 70, -7, 61, 0, 60, -3, 60, -6},  // 3
+    {70, -1, 70, -4, 70, -8, 60, -1, 60, -4, 60, -7},  // 4
+    {70, -2, 70, -6, 70, -9, 60, -2, 60, -5, 60, -8},  // 5
+    {70, -3, 70, -7, 70, -11, 60, -3, 60, -6, 60, -9},  // 6
+    {70, -4, 70, -8, 69, -12, 60, -4, 60, -7, 60, -10},  // 7
+    {70, -6, 70, -9, 69, -13, 60, -5, 60, -8, 59, -11},  // 8
+    {70, -7, 70, -11, 69, -14, 60, -6, 60, -9, 59, -12},  // 9
+    {70, -8, 69, -12, 69, -15, 60, -7, 60, -10, 59, -13},  // 10
+    {70, -9, 69, -13, 68, -17, 60, -8, 59, -11, 59, -14},  // 11
+    {70, -11, 69, -14, 68, -18, 60, -9, 59, -12, 58, -15},  // 12
+    {69, -12, 69, -15, 68, -19, 60, -10, 59, -13, 58, -16},  // 13
+    {69, -13, 68, -17, 67, -20, 59, -11, 59, -14, 58, -17},  // 14
+    {69, -14, 68, -18, 67, -21, 59, -12, 58, -15, 58, -18},  // 15
+    {69, -15, 68, -19, 67, -23, 59, -13, 58, -16, 57, -19},  // 16
+    {68, -17, 67, -20, 66, -24, 59, -14, 58, -17, 57, -20},  // 17
+    {68, -18, 67, -21, 66, -25, 58, -15, 58, -18, 56, -21},  // 18
+    {68, -19, 67, -23, 65, -26, 58, -16, 57, -19, 56, -22},  // 19
+    {67, -20, 66, -24, 65, -27, 58, -17, 57, -20, 56, -23},  // 20
+    {67, -21, 66, -25, 64, -28, 58, -18, 56, -21, 55, -24},  // 21
+    {67, -23, 65, -26, 64, -30, 57, -19, 56, -22, 55, -25},  // 22
+    {66, -24, 65, -27, 63, -31, 57, -20, 56, -23, 54, -26},  // 23
+    {66, -25, 64, -28, 63, -32, 56, -21, 55, -24, 54, -27},  // 24
+    {65, -26, 64, -30, 62, -33, 56, -22, 55, -25, 53, -28},  // 25
+    {65, -27, 63, -31, 62, -34, 56, -23, 54, -26, 53, -29},  // 26
+    {64, -28, 63, -32, 61, -35, 55, -24, 54, -27, 52, -30},  // 27
+    {64, -30, 62, -33, 60, -36, 55, -25, 53, -28, 52, -31},  // 28
+    {63, -31, 62, -34, 60, -37, 54, -26, 53, -29, 51, -32},  // 29
+    {63, -32, 61, -35, 59, -38, 54, -27, 52, -30, 51, -33},  // 30
+    {62, -33, 60, -36, 58, -39, 53, -28, 52, -31, 50, -34},  // 31
+    {62, -34, 60, -37, 58, -40, 53, -29, 51, -32, 49, -34},  // 32
+    {61, -35, 59, -38, 57, -41, 52, -30, 51, -33, 49, -35},  // 33
+    {60, -36, 58, -39, 56, -42, 52, -31, 50, -34, 48, -36},  // 34
+    {60, -37, 58, -40, 55, -43, 51, -32, 49, -34, 48, -37},  // 35
+    {59, -38, 57, -41, 55, -44, 51, -33, 49, -35, 47, -38},  // 36
+    {58, -39, 56, -42, 54, -45, 50, -34, 48, -36, 46, -39},  // 37
+    {58, -40, 55, -43, 53, -46, 49, -34, 48, -37, 46, -40},  // 38
+    {57, -41, 55, -44, 52, -47, 49, -35, 47, -38, 45, -40},  // 39
+    {56, -42, 54, -45, 51, -48, 48, -36, 46, -39, 44, -41},  // 40
+    {55, -43, 53, -46, 51, -49, 48, -37, 46, -40, 43, -42},  // 41
+    {55, -44, 52, -47, 50, -50, 47, -38, 45, -40, 43, -43},  // 42
+    {54, -45, 51, -48, 49, -51, 46, -39, 44, -41, 42, -43},  // 43
+    {53, -46, 51, -49, 48, -51, 46, -40, 43, -42, 41, -44},  // 44
+    {52, -47, 50, -50, 47, -52, 45, -40, 43, -43, 40, -45},  // 45
+    {51, -48, 49, -51, 46, -53, 44, -41, 42, -43, 40, -46},  // 46
+    {51, -49, 48, -51, 45, -54, 43, -42, 41, -44, 39, -46},  // 47
+    {50, -50, 47, -52, 44, -55, 43, -43, 40, -45, 38, -47},  // 48
+    {49, -51, 46, -53, 43, -55, 42, -43, 40, -46, 37, -48},  // 49
+    {48, -51, 45, -54, 42, -56, 41, -44, 39, -46, 36, -48},  // 50
+    {47, -52, 44, -55, 41, -57, 40, -45, 38, -47, 35, -49},  // 51
+    {46, -53, 43, -55, 40, -58, 40, -46, 37, -48, 34, -49},  // 52
+    {45, -54, 42, -56, 39, -58, 39, -46, 36, -48, 34, -50},  // 53
+    {44, -55, 41, -57, 38, -59, 38, -47, 35, -49, 33, -51},  // 54
+    {43, -55, 40, -58, 37, -60, 37, -48, 34, -49, 32, -51},  // 55
+    {42, -56, 39, -58, 36, -60, 36, -48, 34, -50, 31, -52},  // 56
+    {41, -57, 38, -59, 35, -61, 35, -49, 33, -51, 30, -52},  // 57
+    {40, -58, 37, -60, 34, -62, 34, -49, 32, -51, 29, -53},  // 58
+    {39, -58, 36, -60, 33, -62, 34, -50, 31, -52, 28, -53},  // 59
+    {38, -59, 35, -61, 32, -63, 33, -51, 30, -52, 27, -54},  // 60
+    {37, -60, 34, -62, 31, -63, 32, -51, 29, -53, 26, -54},  // 61
+    {36, -60, 33, -62, 30, -64, 31, -52, 28, -53, 25, -55},  // 62
+    {35, -61, 32, -63, 28, -64, 30, -52, 27, -54, 24, -55},  // 63
+    {34, -62, 31, -63, 27, -65, 29, -53, 26, -54, 23, -56},  // 64
+    {33, -62, 30, -64, 26, -65, 28, -53, 25, -55, 22, -56},  // 65
+    {32, -63, 28, -64, 25, -66, 27, -54, 24, -55, 21, -56},  // 66
+    {31, -63, 27, -65, 24, -66, 26, -54, 23, -56, 20, -57},  // 67
+    {30, -64, 26, -65, 23, -67, 25, -55, 22, -56, 19, -57},  // 68
+    {28, -64, 25, -66, 21, -67, 24, -55, 21, -56, 18, -58},  // 69
+    {27, -65, 24, -66, 20, -67, 23, -56, 20, -57, 17, -58},  // 70
+    {26, -65, 23, -67, 19, -68, 22, -56, 19, -57, 16, -58},  // 71
+    {25, -66, 21, -67, 18, -68, 21, -56, 18, -58, 15, -58},  // 72
+    {24, -66, 20, -67, 17, -68, 20, -57, 17, -58, 14, -59},  // 73
+    {23, -67, 19, -68, 15, -69, 19, -57, 16, -58, 13, -59},  // 74
+    {21, -67, 18, -68, 14, -69, 18, -58, 15, -58, 12, -59},  // 75
+    {20, -67, 17, -68, 13, -69, 17, -58, 14, -59, 11, -59},  // 76
+    {19, -68, 15, -69, 12, -69, 16, -58, 13, -59, 10, -60},  // 77
+    {18, -68, 14, -69, 11, -70, 15, -58, 12, -59, 9, -60},  // 78
+    {17, -68, 13, -69, 9, -70, 14, -59, 11, -59, 8, -60},  // 79
+    {15, -69, 12, -69, 8, -70, 13, -59, 10, -60, 7, -60},  // 80
+    {14, -69, 11, -70, 7, -70, 12, -59, 9, -60, 6, -60},  // 81
+    {13, -69, 9, -70, 6, -70, 11, -59, 8, -60, 5, -60},  // 82
+    {12, -69, 8, -70, 4, -70, 10, -60, 7, -60, 4, -60},  // 83
+    {11, -70, 7, -70, 3, -70, 9, -60, 6, -60, 3, -60},  // 84
+    {9, -70, 6, -70, 2, -70, 8, -60, 5, -60, 2, -60},  // 85
+    {8, -70, 4, -70, 1, -70, 7, -60, 4, -60, 1, -60},  // 86
+    {7, -70, 3, -70, 0, -71, 6, -60, 3, -60, 0, -61},  // 87
+    {6, -70, 2, -70, -1, -70, 5, -60, 2, -60, -1, -60},  // 88
+    {4, -70, 1, -70, -2, -70, 4, -60, 1, -60, -2, -60},  // 89
+    {3, -70, 0, -71, -3, -70, 3, -60, 0, -61, -3, -60},  // 90
+    {2, -70, -1, -70, -4, -70, 2, -60, -1, -60, -4, -60},  // 91
+    {1, -70, -2, -70, -6, -70, 1, -60, -2, -60, -5, -60},  // 92
+    {0, -71, -3, -70, -7, -70, 0, -61, -3, -60, -6, -60},  // 93
+    {-1, -70, -4, -70, -8, -70, -1, -60, -4, -60, -7, -60},  // 94
+    {-2, -70, -6, -70, -9, -70, -2, -60, -5, -60, -8, -60},  // 95
+    {-3, -70, -7, -70, -11, -70, -3, -60, -6, -60, -9, -60},  // 96
+    {-4, -70, -8, -70, -12, -69, -4, -60, -7, -60, -10, -60},  // 97
+    {-6, -70, -9, -70, -13, -69, -5, -60, -8, -60, -11, -59},  // 98
+    {-7, -70, -11, -70, -14, -69, -6, -60, -9, -60, -12, -59},  // 99
+    {-8, -70, -12, -69, -15, -69, -7, -60, -10, -60, -13, -59},  // 100
+    {-9, -70, -13, -69, -17, -68, -8, -60, -11, -59, -14, -59},  // 101
+    {-11, -70, -14, -69, -18, -68, -9, -60, -12, -59, -15, -58},  // 102
+    {-12, -69, -15, -69, -19, -68, -10, -60, -13, -59, -16, -58},  // 103
+    {-13, -69, -17, -68, -20, -67, -11, -59, -14, -59, -17, -58},  // 104
+    {-14, -69, -18, -68, -21, -67, -12, -59, -15, -58, -18, -58},  // 105
+    {-15, -69, -19, -68, -23, -67, -13, -59, -16, -58, -19, -57},  // 106
+    {-17, -68, -20, -67, -24, -66, -14, -59, -17, -58, -20, -57},  // 107
+    {-18, -68, -21, -67, -25, -66, -15, -58, -18, -58, -21, -56},  // 108
+    {-19, -68, -23, -67, -26, -65, -16, -58, -19, -57, -22, -56},  // 109
+    {-20, -67, -24, -66, -27, -65, -17, -58, -20, -57, -23, -56},  // 110
+    {-21, -67, -25, -66, -28, -64, -18, -58, -21, -56, -24, -55},  // 111
+    {-23, -67, -26, -65, -30, -64, -19, -57, -22, -56, -25, -55},  // 112
+    {-24, -66, -27, -65, -31, -63, -20, -57, -23, -56, -26, -54},  // 113
+    {-25, -66, -28, -64, -32, -63, -21, -56, -24, -55, -27, -54},  // 114
+    {-26, -65, -30, -64, -33, -62, -22, -56, -25, -55, -28, -53},  // 115
+    {-27, -65, -31, -63, -34, -62, -23, -56, -26, -54, -29, -53},  // 116
+    {-28, -64, -32, -63, -35, -61, -24, -55, -27, -54, -30, -52},  // 117
+    {-30, -64, -33, -62, -36, -60, -25, -55, -28, -53, -31, -52},  // 118
+    {-31, -63, -34, -62, -37, -60, -26, -54, -29, -53, -32, -51},  // 119
+    {-32, -63, -35, -61, -38, -59, -27, -54, -30, -52, -33, -51},  // 120
+    {-33, -62, -36, -60, -39, -58, -28, -53, -31, -52, -34, -50},  // 121
+    {-34, -62, -37, -60, -40, -58, -29, -53, -32, -51, -34, -49},  // 122
+    {-35, -61, -38, -59, -41, -57, -30, -52, -33, -51, -35, -49},  // 123
+    {-36, -60, -39, -58, -42, -56, -31, -52, -34, -50, -36, -48},  // 124
+    {-37, -60, -40, -58, -43, -55, -32, -51, -34, -49, -37, -48},  // 125
+    {-38, -59, -41, -57, -44, -55, -33, -51, -35, -49, -38, -47},  // 126
+    {-39, -58, -42, -56, -45, -54, -34, -50, -36, -48, -39, -46},  // 127
+    {-40, -58, -43, -55, -46, -53, -34, -49, -37, -48, -40, -46},  // 128
+    {-41, -57, -44, -55, -47, -52, -35, -49, -38, -47, -40, -45},  // 129
+    {-42, -56, -45, -54, -48, -51, -36, -48, -39, -46, -41, -44},  // 130
+    {-43, -55, -46, -53, -49, -51, -37, -48, -40, -46, -42, -43},  // 131
+    {-44, -55, -47, -52, -50, -50, -38, -47, -40, -45, -43, -43},  // 132
+    {-45, -54, -48, -51, -51, -49, -39, -46, -41, -44, -43, -42},  // 133
+    {-46, -53, -49, -51, -51, -48, -40, -46, -42, -43, -44, -41},  // 134
+    {-47, -52, -50, -50, -52, -47, -40, -45, -43, -43, -45, -40},  // 135
+    {-48, -51, -51, -49, -53, -46, -41, -44, -43, -42, -46, -40},  // 136
+    {-49, -51, -51, -48, -54, -45, -42, -43, -44, -41, -46, -39},  // 137
+    {-50, -50, -52, -47, -55, -44, -43, -43, -45, -40, -47, -38},  // 138
+    {-51, -49, -53, -46, -55, -43, -43, -42, -46, -40, -48, -37},  // 139
+    {-51, -48, -54, -45, -56, -42, -44, -41, -46, -39, -48, -36},  // 140
+    {-52, -47, -55, -44, -57, -41, -45, -40, -47, -38, -49, -35},  // 141
+    {-53, -46, -55, -43, -58, -40, -46, -40, -48, -37, -49, -34},  // 142
+    {-54, -45, -56, -42, -58, -39, -46, -39, -48, -36, -50, -34},  // 143
+    {-55, -44, -57, -41, -59, -38, -47, -38, -49, -35, -51, -33},  // 144
+    {-55, -43, -58, -40, -60, -37, -48, -37, -49, -34, -51, -32},  // 145
+    {-56, -42, -58, -39, -60, -36, -48, -36, -50, -34, -52, -31},  // 146
+    {-57, -41, -59, -38, -61, -35, -49, -35, -51, -33, -52, -30},  // 147
+    {-58, -40, -60, -37, -62, -34, -49, -34, -51, -32, -53, -29},  // 148
+    {-58, -39, -60, -36, -62, -33, -50, -34, -52, -31, -53, -28},  // 149
+    {-59, -38, -61, -35, -63, -32, -51, -33, -52, -30, -54, -27},  // 150
+    {-60, -37, -62, -34, -63, -31, -51, -32, -53, -29, -54, -26},  // 151
+    {-60, -36, -62, -33, -64, -30, -52, -31, -53, -28, -55, -25},  // 152
+    {-61, -35, -63, -32, -64, -28, -52, -30, -54, -27, -55, -24},  // 153
+    {-62, -34, -63, -31, -65, -27, -53, -29, -54, -26, -56, -23},  // 154
+    {-62, -33, -64, -30, -65, -26, -53, -28, -55, -25, -56, -22},  // 155
+    {-63, -32, -64, -28, -66, -25, -54, -27, -55, -24, -56, -21},  // 156
+    {-63, -31, -65, -27, -66, -24, -54, -26, -56, -23, -57, -20},  // 157
+    {-64, -30, -65, -26, -67, -23, -55, -25, -56, -22, -57, -19},  // 158
+    {-64, -28, -66, -25, -67, -21, -55, -24, -56, -21, -58, -18},  // 159
+    {-65, -27, -66, -24, -67, -20, -56, -23, -57, -20, -58, -17},  // 160
+    {-65, -26, -67, -23, -68, -19, -56, -22, -57, -19, -58, -16},  // 161
+    {-66, -25, -67, -21, -68, -18, -56, -21, -58, -18, -58, -15},  // 162
+    {-66, -24, -67, -20, -68, -17, -57, -20, -58, -17, -59, -14},  // 163
+    {-67, -23, -68, -19, -69, -15, -57, -19, -58, -16, -59, -13},  // 164
+    {-67, -21, -68, -18, -69, -14, -58, -18, -58, -15, -59, -12},  // 165
+    {-67, -20, -68, -17, -69, -13, -58, -17, -59, -14, -59, -11},  // 166
+    {-68, -19, -69, -15, -69, -12, -58, -16, -59, -13, -60, -10},  // 167
+    {-68, -18, -69, -14, -70, -11, -58, -15, -59, -12, -60, -9},  // 168
+    {-68, -17, -69, -13, -70, -9, -59, -14, -59, -11, -60, -8},  // 169
+    {-69, -15, -69, -12, -70, -8, -59, -13, -60, -10, -60, -7},  // 170
+    {-69, -14, -70, -11, -70, -7, -59, -12, -60, -9, -60, -6},  // 171
+    {-69, -13, -70, -9, -70, -6, -59, -11, -60, -8, -60, -5},  // 172
+    {-69, -12, -70, -8, -70, -4, -60, -10, -60, -7, -60, -4},  // 173
+    {-70, -11, -70, -7, -70, -3, -60, -9, -60, -6, -60, -3},  // 174
+    {-70, -9, -70, -6, -70, -2, -60, -8, -60, -5, -60, -2},  // 175
+    {-70, -8, -70, -4, -70, -1, -60, -7, -60, -4, -60, -1},  // 176
+    {-70, -7, -70, -3, -71, 0, -60, -6, -60, -3, -61, 0},  // 177
+    {-70, -6, -70, -2, -70, 1, -60, -5, -60, -2, -60, 1},  // 178
+    {-70, -4, -70, -1, -70, 2, -60, -4, -60, -1, -60, 2},  // 179
+    {-70, -3, -71, 0, -70, 3, -60, -3, -61, 0, -60, 3},  // 180
+    {-70, -2, -70, 1, -70, 4, -60, -2, -60, 1, -60, 4},  // 181
+    {-70, -1, -70, 2, -70, 6, -60, -1, -60, 2, -60, 5},  // 182
+    {-71, 0, -70, 3, -70, 7, -61, 0, -60, 3, -60, 6},  // 183
+    {-70, 1, -70, 4, -70, 8, -60, 1, -60, 4, -60, 7},  // 184
+    {-70, 2, -70, 6, -70, 9, -60, 2, -60, 5, -60, 8},  // 185
+    {-70, 3, -70, 7, -70, 11, -60, 3, -60, 6, -60, 9},  // 186
+    {-70, 4, -70, 8, -69, 12, -60, 4, -60, 7, -60, 10},  // 187
+    {-70, 6, -70, 9, -69, 13, -60, 5, -60, 8, -59, 11},  // 188
+    {-70, 7, -70, 11, -69, 14, -60, 6, -60, 9, -59, 12},  // 189
+    {-70, 8, -69, 12, -69, 15, -60, 7, -60, 10, -59, 13},  // 190
+    {-70, 9, -69, 13, -68, 17, -60, 8, -59, 11, -59, 14},  // 191
+    {-70, 11, -69, 14, -68, 18, -60, 9, -59, 12, -58, 15},  // 192
+    {-69, 12, -69, 15, -68, 19, -60, 10, -59, 13, -58, 16},  // 193
+    {-69, 13, -68, 17, -67, 20, -59, 11, -59, 14, -58, 17},  // 194
+    {-69, 14, -68, 18, -67, 21, -59, 12, -58, 15, -58, 18},  // 195
+    {-69, 15, -68, 19, -67, 23, -59, 13, -58, 16, -57, 19},  // 196
+    {-68, 17, -67, 20, -66, 24, -59, 14, -58, 17, -57, 20},  // 197
+    {-68, 18, -67, 21, -66, 25, -58, 15, -58, 18, -56, 21},  // 198
+    {-68, 19, -67, 23, -65, 26, -58, 16, -57, 19, -56, 22},  // 199
+    {-67, 20, -66, 24, -65, 27, -58, 17, -57, 20, -56, 23},  // 200
+    {-67, 21, -66, 25, -64, 28, -58, 18, -56, 21, -55, 24},  // 201
+    {-67, 23, -65, 26, -64, 30, -57, 19, -56, 22, -55, 25},  // 202
+    {-66, 24, -65, 27, -63, 31, -57, 20, -56, 23, -54, 26},  // 203
+    {-66, 25, -64, 28, -63, 32, -56, 21, -55, 24, -54, 27},  // 204
+    {-65, 26, -64, 30, -62, 33, -56, 22, -55, 25, -53, 28},  // 205
+    {-65, 27, -63, 31, -62, 34, -56, 23, -54, 26, -53, 29},  // 206
+    {-64, 28, -63, 32, -61, 35, -55, 24, -54, 27, -52, 30},  // 207
+    {-64, 30, -62, 33, -60, 36, -55, 25, -53, 28, -52, 31},  // 208
+    {-63, 31, -62, 34, -60, 37, -54, 26, -53, 29, -51, 32},  // 209
+    {-63, 32, -61, 35, -59, 38, -54, 27, -52, 30, -51, 33},  // 210
+    {-62, 33, -60, 36, -58, 39, -53, 28, -52, 31, -50, 34},  // 211
+    {-62, 34, -60, 37, -58, 40, -53, 29, -51, 32, -49, 34},  // 212
+    {-61, 35, -59, 38, -57, 41, -52, 30, -51, 33, -49, 35},  // 213
+    {-60, 36, -58, 39, -56, 42, -52, 31, -50, 34, -48, 36},  // 214
+    {-60, 37, -58, 40, -55, 43, -51, 32, -49, 34, -48, 37},  // 215
+    {-59, 38, -57, 41, -55, 44, -51, 33, -49, 35, -47, 38},  // 216
+    {-58, 39, -56, 42, -54, 45, -50, 34, -48, 36, -46, 39},  // 217
+    {-58, 40, -55, 43, -53, 46, -49, 34, -48, 37, -46, 40},  // 218
+    {-57, 41, -55, 44, -52, 47, -49, 35, -47, 38, -45, 40},  // 219
+    {-56, 42, -54, 45, -51, 48, -48, 36, -46, 39, -44, 41},  // 220
+    {-55, 43, -53, 46, -51, 49, -48, 37, -46, 40, -43, 42},  // 221
+    {-55, 44, -52, 47, -50, 50, -47, 38, -45, 40, -43, 43},  // 222
+    {-54, 45, -51, 48, -49, 51, -46, 39, -44, 41, -42, 43},  // 223
+    {-53, 46, -51, 49, -48, 51, -46, 40, -43, 42, -41, 44},  // 224
+    {-52, 47, -50, 50, -47, 52, -45, 40, -43, 43, -40, 45},  // 225
+};
@@ -2,32 +2,37 @@
 
 #include "pressure.h"
 
-bool pressureOver() {
-    if (getAirway() > MAX_PEAK)
+bool pressureOver(q16 cmH20) {
+    if (cmH20 > MAX_PEAK)
         return true;
     else
         return false;
 }
 
-bool pressureHigh() {
-    if (getAirway() > HIGH_PEAK)
+bool pressureHigh(q16 cmH20) {
+    if (cmH20 > HIGH_PEAK)
         return true;
     else
         return false;
 }
 
-float getAirway() {
-    return getPressure() - cmH20.atmosphere;
+q16 getAirway() {
+    return mprls.ring[uint8_t(mprls.head - 1) % PRESSURE_SAMPLES].cmH20;
 }
 
-float getPressure() {
-    float p;
-    p = sensor.readPressure();
-    return p * 1.0197;
+void pressureStatus(const i2cTransfer *x) {
+    sensorStatus = x->status == I2C_OK ? x->data[0] : 0;
+}
+
+uint8_t pressureReadStatus() {
+    sensorStatus = 0;
+    i2cRead(PRESSURE_ID, 1, pressureStatus);
+    i2cFlush();
+    return sensorStatus;
 }
 
 void pressureSensorCheck() {
-    uint8_t status = sensor.readStatus();
+    uint8_t status = pressureReadStatus();
 
     // refer to honeywell mpr series datasheet for more details
     bool sensorMathSaturation  = CHECK_BIT(status, 0);  // 1 = saturated
@@ -35,12 +40,126 @@ void pressureSensorCheck() {
     bool sensorBusy            = CHECK_BIT(status, 5);  // 1 = busy
     bool sensorPower           = CHECK_BIT(status, 6);  // 1 = powered
 
-    Serial.println("Saturated: " + String(sensorMathSaturation));
-    Serial.println("Memory Check Failed: " + String(sensorMemoryIntegrity));
-    Serial.println("Busy: " + String(sensorBusy));
-    Serial.println("Powered: " + String(sensorPower));
+    Serial.print(F("Saturated: "));
+    Serial.println(sensorMathSaturation);
+    Serial.print(F("Memory Check Failed: "));
+    Serial.println(sensorMemoryIntegrity);
+    Serial.print(F("Busy: "));
+    Serial.println(sensorBusy);
+    Serial.print(F("Powered: "));
+    Serial.println(sensorPower);
+}
+
+// a trigger that never reached the sensor loses its conversion. the sample is
+// stamped with when the command finished going over, which is when the
+// sensor starts converting
+void pressureTriggered(const i2cTransfer *x) {
+    mprls.busy = false;
+    if (x->status == I2C_OK) {
+        mprls.triggered = x->finished;
+        return;
+    }
+    mprls.state = 0;
+    mprls.dropped++;
+}
+
+// 0xAA 0x00 0x00 starts a conversion, the library does the same then blocks
+void pressureTrigger(unsigned long now) {
+    static const uint8_t command[3] = {0xAA, 0x00, 0x00};
+    mprls.triggered = now;
+    mprls.state     = 1;
+    mprls.busy      = i2cWrite(PRESSURE_ID, command, 3, pressureTriggered);
+    if (!mprls.busy) {
+        mprls.state = 0;
+        mprls.dropped++;
+    }
+}
+
+// status byte then 24 bits of counts. a sensor that is still busy, or a read
+// that failed, is tried again on a later pass until PRESSURE_TIMEOUT
+void pressureCollected(const i2cTransfer *x) {
+    mprls.busy = false;
+    if (x->status != I2C_OK)
+        return;
+    uint8_t status = x->data[0];
+    int32_t counts = int32_t(x->data[1]) << 16;
+    counts |= int32_t(x->data[2]) << 8;
+    counts |= int32_t(x->data[3]);
+
+    if (status & PRESSURE_BUSY)
+        return;
+    mprls.state = 0;
+    if (status & (PRESSURE_SATURATED | PRESSURE_FAILED)) {
+        mprls.faults++;
+        mprls.dropped++;
+        return;
+    }
+
+    int64_t scaled = int64_t(counts - MPRLS_OUTPUT_MIN) * CMH2O_PER_COUNT;
+    sample *s      = &mprls.ring[uint8_t(mprls.head) % PRESSURE_SAMPLES];
+    s->us          = mprls.triggered;
+    s->cmH20       = q16::fromRaw(scaled >> 16) - cmH20.atmosphere;
+    mprls.head++;
+    mprls.samples++;
+    mprls.windowCount++;
 }
 
-bool pressureSensorReady() {
-    return !CHECK_BIT(sensor.readStatus(), 5);
-}
\ No newline at end of file
+void pressureBegin() {
+    mprls.state       = 0;
+    mprls.due         = micros();
+    mprls.windowStart = mprls.due;
+    mprls.windowCount = 0;
+}
+
+void pressureUpdate() {
+    unsigned long now = micros();
+
+    if (now - mprls.windowStart >= 1000000) {
+        mprls.windowStart += 1000000;
+        mprls.rate        = mprls.windowCount;
+        mprls.windowCount = 0;
+#if PRESSURE_REPORT
+        LOG_INFO(PRESSURE_RATE, mprls.rate, mprls.dropped);
+#endif
+    }
+
+    // the last transfer has to be called back before the next goes out
+    if (mprls.busy)
+        return;
+
+    if (mprls.state == 0) {
+        if (long(now - mprls.due) < 0)
+            return;
+        // a loop() that overran whole periods has lost those conversions,
+        // the schedule stays on its grid rather than drifting late
+        unsigned long missed = (now - mprls.due) / PRESSURE_PERIOD;
+        mprls.dropped += missed;
+        mprls.due += (missed + 1) * PRESSURE_PERIOD;
+        pressureTrigger(now);
+        return;
+    }
+
+    unsigned long elapsed = now - mprls.triggered;
+    if (elapsed >= PRESSURE_TIMEOUT) {
+        mprls.state = 0;
+        mprls.dropped++;
+        return;
+    }
+    if (elapsed < PRESSURE_CONVERSION)
+        return;
+#if PRESSURE_EOC != -1
+    if (digitalRead(PRESSURE_EOC) == LOW)
+        return;
+#endif
+    mprls.busy = i2cRead(PRESSURE_ID, 4, pressureCollected);
+}
+
+bool pressureRead(uint16_t *cursor, sample *s) {
+    if (*cursor == mprls.head)
+        return false;
+    if (uint16_t(mprls.head - *cursor) > PRESSURE_SAMPLES)
+        *cursor = mprls.head - PRESSURE_SAMPLES;
+    *s = mprls.ring[uint8_t(*cursor) % PRESSURE_SAMPLES];
+    (*cursor)++;
+    return true;
+}
@@ -2,36 +2,101 @@
 
 #pragma once
 
-#include <Adafruit_MPRLS.h>
+#include "fixed.h"
+#include "i2c.h"
+#include "logger.h"
 #define CHECK_BIT(var, pos) ((var) & (1 << (pos)))  // Bit checking macro
-#define PRESSURE_RST -1                             // Hard reset on begin()
-#define PRESSURE_EOC -1                             // End-of-conversion
+#define PRESSURE_EOC -1                             // End-of-conversion, -1 polls
+#define PRESSURE_ID 0x18                            // I2C address
 
-Adafruit_MPRLS sensor = Adafruit_MPRLS(PRESSURE_RST, PRESSURE_EOC);
-pressure       cmH20;
+// log the achieved sample rate and dropped conversions once a second
+#define PRESSURE_REPORT 0
+
+const unsigned long PRESSURE_PERIOD     = 10000;  // Sample period (us)
+const unsigned long PRESSURE_CONVERSION = 5000;   // Sensor conversion time (us)
+const unsigned long PRESSURE_TIMEOUT    = 20000;  // Give up on a conversion (us)
+const uint8_t       PRESSURE_SAMPLES    = 32;     // Ring size, a power of two
+
+// status byte bits, refer to honeywell mpr series datasheet
+const uint8_t PRESSURE_POWERED   = 0x40;
+const uint8_t PRESSURE_BUSY      = 0x20;
+const uint8_t PRESSURE_FAILED    = 0x04;
+const uint8_t PRESSURE_SATURATED = 0x01;
+
+// the sensor reports 10% to 90% of 2^24 counts over 0 to 25 psi. cmH20 per
+// count is kept scaled by 2^32, so a reading is one 64 bit multiply and shift
+const int32_t MPRLS_OUTPUT_MIN = 0x19999A;
+const int32_t MPRLS_OUTPUT_MAX = 0xE66666;
+const int32_t CMH2O_PER_COUNT  = 25 * 68.947572932 * 1.0197 * 65536.0 * 65536.0 /
+                                    (MPRLS_OUTPUT_MAX - MPRLS_OUTPUT_MIN) +
+                                0.5;
 
 typedef struct {
-    float
+    q16
         atmosphere,
         airway,
         peep,
+        plateau,
         peak;
 } pressure;
 
-// check if airway pressure is over max
-bool pressureOver();
+// one airway pressure reading, stamped with the micros() it was triggered at
+typedef struct {
+    unsigned long us;
+    q16           cmH20;
+} sample;
+
+// trigger, wait out the conversion, collect. loop() only ever queues a
+// transfer, and a conversion starts every PRESSURE_PERIOD regardless of how
+// long the rest of loop() took
+typedef struct {
+    uint8_t
+        state;  // 0 = waiting to trigger, 1 = converting
+    bool
+        busy;  // a transfer is queued and not yet called back
+    unsigned long
+        due,          // when the next conversion should start
+        triggered,    // when the current conversion started
+        windowStart;  // start of the current one second rate window
+    uint16_t
+        head,         // samples written so far, the newest is head - 1
+        windowCount,  // samples so far in this window
+        rate;         // samples in the last full second (Hz)
+    unsigned long
+        samples,  // conversions collected
+        dropped,  // conversions missed, timed out or faulted
+        faults;   // conversions the sensor flagged saturated or failed
+    sample
+        ring[PRESSURE_SAMPLES];
+} sampler;
+
+pressure cmH20;
+sampler  mprls;
+uint8_t  sensorStatus;  // last status byte read by pressureReadStatus()
+
+// check if an airway pressure is over max
+bool pressureOver(q16 cmH20);
 
-// check if airway pressure is high
-bool pressureHigh();
+// check if an airway pressure is high
+bool pressureHigh(q16 cmH20);
 
-// return the current airway pressure
-float getAirway();
+// return the newest airway pressure sample
+q16 getAirway();
 
-// current sensor pressure reporting in cmH20
-float getPressure();
+// read the status byte, waiting on the I2C queue. 0 if the sensor never
+// answered
+uint8_t pressureReadStatus();
 
 // read from sensor state bits to check health of sensor
 void pressureSensorCheck();
 
-// check if sensor is ready to be read
-bool pressureSensorReady();
+// start sampling on a fresh schedule from now
+void pressureBegin();
+
+// advance the sampler, call every pass of loop()
+void pressureUpdate();
+
+// copy the next sample after cursor into s and advance cursor. each reader
+// keeps its own cursor, starting from mprls.head. a reader that falls more
+// than PRESSURE_SAMPLES behind skips to the oldest sample still held
+bool pressureRead(uint16_t *cursor, sample *s);
@@ -0,0 +1,92 @@
+// ! Implementation of scheduler ! =============================================
+
+#include "scheduler.h"
+
+void schedulerBegin(task *tasks, uint8_t count, void (*onIdle)()) {
+    sched.tasks       = tasks;
+    sched.count       = count;
+    sched.onIdle      = onIdle;
+    unsigned long now = micros();
+    for (uint8_t i = 0; i < count; i++)
+        tasks[i].due = now;
+    sched.reported = now;
+}
+
+// the most urgent task due at now with a priority number below limit
+task *schedulerPick(unsigned long now, uint8_t limit) {
+    task *next = 0;
+    for (uint8_t i = 0; i < sched.count; i++) {
+        task *k = &sched.tasks[i];
+        if (k->priority >= limit || long(now - k->due) < 0)
+            continue;
+        if (!next || k->priority < next->priority ||
+            (k->priority == next->priority && long(k->due - next->due) < 0))
+            next = k;
+    }
+    return next;
+}
+
+void schedulerDispatch(task *k, unsigned long now) {
+    // releases that went by while it waited are dropped, the task stays on
+    // its grid rather than drifting late
+    unsigned long late   = now - k->due;
+    unsigned long missed = late / k->period;
+    k->skipped += missed;
+    k->due += (missed + 1) * k->period;
+    if (late > k->lateMax)
+        k->lateMax = late;
+
+    task *outer   = sched.running;
+    sched.running = k;
+    k->run();
+    sched.running = outer;
+
+    unsigned long end  = micros();
+    unsigned long cost = end - now;
+    k->runs++;
+    if (cost > k->costMax)
+        k->costMax = cost;
+    if (long(end - k->due) > 0)
+        k->overruns++;
+}
+
+void schedulerRun() {
+    unsigned long now = micros();
+    sched.passes++;
+
+#if SCHEDULER_REPORT
+    if (now - sched.reported >= SCHEDULER_REPORT_PERIOD) {
+        sched.reported += SCHEDULER_REPORT_PERIOD;
+        schedulerReport();
+    }
+#endif
+
+    task *next = schedulerPick(now, 0xFF);
+    if (next) {
+        schedulerDispatch(next, now);
+    } else {
+        sched.idle++;
+        if (sched.onIdle)
+            sched.onIdle();
+    }
+}
+
+// outside a task, as in setup(), there is nothing to yield to
+void schedulerYield() {
+    if (!sched.running)
+        return;
+    unsigned long now = micros();
+    task         *next;
+    while ((next = schedulerPick(now, sched.running->priority)) != 0) {
+        schedulerDispatch(next, now);
+        now = micros();
+    }
+}
+
+void schedulerReport() {
+    for (uint8_t i = 0; i < sched.count; i++) {
+        const task *k = &sched.tasks[i];
+        LOG_INFO(TASK_TIMING, i, k->runs, k->lateMax, k->costMax);
+        LOG_INFO(TASK_MISSED, i, k->overruns, k->skipped);
+    }
+}
@@ -0,0 +1,57 @@
+// ! Task Scheduler ! ==========================================================
+
+#pragma once
+#include <avr/pgmspace.h>
+#include "logger.h"
+
+// log every task's counts every SCHEDULER_REPORT_PERIOD
+#define SCHEDULER_REPORT 0
+
+const unsigned long SCHEDULER_REPORT_PERIOD = 10000000;  // Report period (us)
+
+// loop() runs one task per pass, the most urgent of those due: lowest priority
+// number first, then the one that has waited longest. nothing is preempted,
+// but a long task can call schedulerYield() between stages of its work to let
+// anything more urgent run, so the worst a high priority task waits is the
+// longest stretch between yields, and that shows up in its lateMax. a task is
+// released every period on a fixed grid. one that falls whole periods behind
+// skips them rather than running back to back to catch up
+struct task {
+    PGM_P name;  // in flash
+    void (*run)();
+    unsigned long period;    // release interval (us)
+    uint8_t       priority;  // 0 is the most urgent
+    unsigned long
+        due,       // next release
+        runs,      // times run
+        overruns,  // runs that finished after the next release
+        skipped,   // releases dropped while waiting to run
+        lateMax,   // longest from release to start (us)
+        costMax;   // longest run, counting tasks it yielded to (us)
+};
+
+struct scheduler {
+    task   *tasks;
+    task   *running;  // innermost task running, 0 between tasks
+    uint8_t count;
+    void (*onIdle)();  // on passes with nothing due, may be 0
+    unsigned long
+        passes,  // calls to schedulerRun()
+        idle,    // passes with nothing due
+        reported;
+};
+
+struct scheduler sched;
+
+// take over the task table and release every task now. onIdle runs on every
+// pass with nothing due, so it should be short
+void schedulerBegin(task *tasks, uint8_t count, void (*onIdle)() = 0);
+
+// run the most urgent task that is due, if any. call every pass of loop()
+void schedulerRun();
+
+// from inside a task, run whatever is due that is more urgent than it
+void schedulerYield();
+
+// log each task's counts
+void schedulerReport();
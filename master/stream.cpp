@@ -0,0 +1,47 @@
+// ! Implementation of stream ! ================================================
+
+#include "stream.h"
+
+void streamUpdate() {
+    streamer *st    = &stream;
+    sample    s;
+    bool      fresh = false;
+    while (pressureRead(&st->cursor, &s)) {
+        st->raw[0] = st->raw[1];
+        st->raw[1] = st->raw[2];
+        st->raw[2] = s.cmH20;
+        fresh      = true;
+    }
+    if (!fresh || send.mode != MODE_PRESSURE)
+        return;
+    if (st->busy) {
+        st->dropped++;
+        return;
+    }
+
+    int16_t       cmH20 = median3(st->raw[0], st->raw[1], st->raw[2]).raw() >> 8;
+    unsigned long age   = micros() - s.us;
+    if (age > 0xFFFF)
+        age = 0xFFFF;
+    uint8_t message[STREAM_SIZE] = {STREAM_START, uint8_t(cmH20), uint8_t(cmH20 >> 8),
+                                    uint8_t(age), uint8_t(age >> 8)};
+    message[STREAM_SIZE - 1]     = crc8(message, STREAM_SIZE - 1);
+    st->busy = i2cWrite(SLAVE_ADDR, message, STREAM_SIZE, streamSent, I2C_TIMEOUT, 0);
+    if (!st->busy)
+        st->dropped++;
+}
+
+// the age went in the message, the time in the queue and on the bus is
+// added here
+void streamSent(const i2cTransfer *x) {
+    streamer *st = &stream;
+    st->busy     = false;
+    if (x->status != I2C_OK) {
+        st->dropped++;
+        return;
+    }
+    st->sent++;
+    st->latency = (x->data[3] | x->data[4] << 8) + (x->finished - x->queued);
+    if (st->latency > st->latencyMax)
+        st->latencyMax = st->latency;
+}
@@ -0,0 +1,43 @@
+// ! Pressure Stream ! =========================================================
+
+#pragma once
+#include "analysis.h"
+#include "comm.h"
+#include "i2c.h"
+#include "pressure.h"
+
+// in pressure control every airway sample goes on to the slave as it lands,
+// for its loop to steer the inhale by. spikes come out with a median of three
+// as in the analyser, but there's no low pass after it, the loop wants the
+// least lag it can get
+//
+//   sample  [STREAM_START][cmH20][age][crc]
+//
+// cmH20 is int16 in 1/256ths, age the us from the conversion starting to the
+// message being queued, and the CRC the frames' CRC-8. a sample gets no reply
+// and leaves the frames' ack alone. one that can't be queued, or fails on the
+// bus, is dropped rather than tried again, the next is due a PRESSURE_PERIOD
+// later and would be fresher
+const uint8_t STREAM_START = 0x5A;  // First byte of a sample, never a frame's
+const uint8_t STREAM_SIZE  = 6;     // Bytes of a sample
+
+struct streamer {
+    uint16_t
+        cursor;  // next sample to take from the pressure ring
+    q16
+        raw[3];  // last three samples for the median
+    bool
+        busy;  // the last sample is still in the I2C queue
+    unsigned long
+        sent,        // off the bus
+        dropped,     // not queued or failed
+        latency,     // conversion start to off the bus, last sample (us)
+        latencyMax;  // of those
+};
+
+streamer stream;
+
+// takes the new samples and, while the mode is pressure control, sends the
+// newest. the stream task
+void streamUpdate();
+void streamSent(const i2cTransfer *x);
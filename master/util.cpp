@@ -2,14 +2,7 @@
 
 #include "util.h"
 
-bool roughlyEqual(float a, float b) {
-    if (abs(a - b) < 0.0001)
-        return true;
-    else
-        return false;
-}
-
-float mapf(float x, float in_min, float in_max, float out_min, float out_max) {
-    float v = (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+q16 mapq(q16 x, q16 in_min, q16 in_max, q16 out_min, q16 out_max) {
+    q16 v = (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
     return v;
-}
\ No newline at end of file
+}
@@ -1,9 +1,16 @@
 // ! Handy Dandy stuff ! =======================================================
 
 #pragma once
+#include <avr/pgmspace.h>
+#include "fixed.h"
 
-// floating point re-implementation of map()
-float mapf(float x, float in_min, float in_max, float out_min, float out_max);
+// fixed point re-implementation of map()
+q16 mapq(q16 x, q16 in_min, q16 in_max, q16 out_min, q16 out_max);
 
-// floating point comparison can fail by rounding tolerances
-bool roughlyEqual(float a, float b);
+// a table entry or field, copied out of flash
+template <typename T>
+T flashRead(const T *field) {
+    T v;
+    memcpy_P(&v, field, sizeof(T));
+    return v;
+}
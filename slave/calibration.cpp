@@ -0,0 +1,106 @@
+// ! Implementation of calibration ! ===========================================
+
+#include "calibration.h"
+
+// every point a step past the last, and the stroke at the top inside the limit
+bool curveRises(const uint16_t *steps) {
+    for (uint8_t i = 1; i < CURVE_POINTS; i++)
+        if (steps[i] <= steps[i - 1])
+            return false;
+    return steps[0] > 0 && steps[CURVE_POINTS - 1] <= CALIBRATION_LIMIT;
+}
+
+void calibrationBegin() {
+    calibrationState *c = &calibration;
+    eeprom_read_block(&c->record, (const void *)CALIBRATION_ADDRESS, sizeof(c->record));
+    c->stored = c->record.check == curveCheck(c->record.steps) && curveRises(c->record.steps);
+    c->saved  = sizeof(c->record);
+    if (!c->stored) {
+        memcpy_P(c->record.steps, curveSteps, sizeof(c->record.steps));
+        c->record.check = curveCheck(c->record.steps);
+    }
+}
+
+int volumeToSteps(int volume) {
+    const uint16_t *steps = calibration.record.steps;
+    if (volume <= CURVE_MIN_TV)
+        return steps[0];
+    uint16_t along = volume - CURVE_MIN_TV;
+    uint16_t i     = along / CURVE_INC_TV;
+    if (i >= CURVE_POINTS - 1)
+        return steps[CURVE_POINTS - 1];
+    uint8_t  part = along - i * CURVE_INC_TV;
+    uint16_t rise = steps[i + 1] - steps[i];
+    return steps[i] + (rise * part + CURVE_INC_TV / 2) / CURVE_INC_TV;
+}
+
+// the curve rises all the way, so the first point at or past steps ends the
+// segment it's on. short of the curve's foot it's taken as straight from 0
+int stepsToVolume(int steps) {
+    const uint16_t *curve = calibration.record.steps;
+    if (steps <= 0)
+        return 0;
+    if (steps < int(curve[0]))
+        return long(CURVE_MIN_TV) * steps / curve[0];
+    if (steps >= int(curve[CURVE_POINTS - 1]))
+        return CURVE_MIN_TV + (CURVE_POINTS - 1) * CURVE_INC_TV;
+    uint8_t i = 1;
+    while (int(curve[i]) < steps)
+        i++;
+    uint16_t rise = curve[i] - curve[i - 1];
+    uint16_t part = steps - curve[i - 1];
+    return CURVE_MIN_TV + (i - 1) * CURVE_INC_TV + (part * CURVE_INC_TV + rise / 2) / rise;
+}
+
+void calibrationStage(uint8_t first, const uint8_t *points) {
+    calibrationState *c = &calibration;
+    for (uint8_t i = 0; i < CALIBRATION_CHUNK && first + i < CURVE_POINTS; i++)
+        c->staged[first + i] = points[2 * i] | points[2 * i + 1] << 8;
+    c->chunks |= 1 << first / CALIBRATION_CHUNK;
+}
+
+bool calibrationCommit(uint16_t check) {
+    calibrationState *c = &calibration;
+    uint16_t          steps[CURVE_POINTS];
+    noInterrupts();
+    memcpy(steps, c->staged, sizeof(steps));
+    uint8_t chunks = c->chunks;
+    c->chunks      = 0;
+    interrupts();
+
+    if (chunks != CALIBRATION_STAGED || curveCheck(steps) != check || !curveRises(steps))
+        return false;
+    memcpy(c->record.steps, steps, sizeof(steps));
+    c->record.check = check;
+    c->saved        = 0;
+    return true;
+}
+
+void calibrationSave() {
+    calibrationState *c = &calibration;
+    while (c->saved < sizeof(c->record) && eeprom_is_ready()) {
+        eeprom_update_byte((uint8_t *)CALIBRATION_ADDRESS + c->saved,
+                           ((const uint8_t *)&c->record)[c->saved]);
+        c->saved++;
+        if (c->saved == sizeof(c->record))
+            LOG_INFO(CURVE_SAVED, c->record.check);
+    }
+}
+
+// Fletcher-16 over the points little endian, the sums kept under 255 by
+// subtracting so there's no divide
+uint16_t curveCheck(const uint16_t *steps) {
+    uint16_t a = 0, b = 0;
+    for (uint8_t i = 0; i < CURVE_POINTS; i++) {
+        uint8_t bytes[2] = {uint8_t(steps[i]), uint8_t(steps[i] >> 8)};
+        for (uint8_t n = 0; n < 2; n++) {
+            a += bytes[n];
+            if (a >= 255)
+                a -= 255;
+            b += a;
+            if (b >= 255)
+                b -= 255;
+        }
+    }
+    return b << 8 | a;
+}
@@ -0,0 +1,66 @@
+// ! Volume Calibration ! ======================================================
+
+#pragma once
+#include <Arduino.h>
+#include <avr/eeprom.h>
+#include "curve.h"
+#include "logger.h"
+
+// the inhale stroke for a volume comes off a curve of steps at every
+// CURVE_INC_TV, read with a multiply and a divide between the two points
+// either side. the nominal curve is in flash. the master can upload another
+// in CALIBRATION_CHUNK point pieces and commit it with its check, and one
+// that rises all the way and stays inside CALIBRATION_LIMIT is used from the
+// next inhale on and written to EEPROM a byte at a time whenever it's free,
+// to be used from boot after that. a record that doesn't check out, blank or
+// torn by a reset part way through writing, leaves the boot on flash
+const uint8_t  CALIBRATION_CHUNK   = 4;     // Points in a frame's field
+const uint16_t CALIBRATION_LIMIT   = 2667;  // Furthest a curve may turn the arm, 30 deg
+const int      CALIBRATION_ADDRESS = 0;     // EEPROM offset of the record
+
+const uint8_t CALIBRATION_CHUNKS = (CURVE_POINTS + CALIBRATION_CHUNK - 1) / CALIBRATION_CHUNK;
+const uint8_t CALIBRATION_STAGED = (1 << CALIBRATION_CHUNKS) - 1;
+
+struct calibrationRecord {
+    uint16_t
+        steps[CURVE_POINTS],
+        check;  // Fletcher-16 of steps
+};
+
+struct calibrationState {
+    calibrationRecord
+        record;  // in use, and as being written back
+    uint16_t
+        staged[CURVE_POINTS];  // from the master, not yet committed
+    volatile uint8_t
+        chunks;  // bit per chunk staged
+    bool
+        stored;  // the boot started from a good record
+    uint8_t
+        saved;  // bytes of record written back, sizeof(record) when done
+};
+
+calibrationState calibration;
+
+// the curve from EEPROM if a good one is kept, otherwise from flash
+void calibrationBegin();
+
+// steps of the inhale stroke for volume in mL, held at the curve's ends
+int volumeToSteps(int volume);
+
+// volume in mL an inhale stroke of steps gave, the curve read the other way
+int stepsToVolume(int steps);
+
+// files CALIBRATION_CHUNK little endian points from first on. runs in the
+// Wire interrupt, points past the curve's end are padding
+void calibrationStage(uint8_t first, const uint8_t *points);
+
+// takes what's staged as the curve if every chunk is there, it matches check
+// and it rises within the limit, and starts writing it back. what's staged is
+// cleared either way
+bool calibrationCommit(uint16_t check);
+
+// one step of writing the record back, at most one byte that changes
+void calibrationSave();
+
+uint16_t curveCheck(const uint16_t *steps);
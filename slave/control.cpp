@@ -0,0 +1,117 @@
+// ! Implementation of control ! ===============================================
+
+#include "control.h"
+
+void controlStream(int16_t cmH20, uint16_t age) {
+    feed.cmH20 = cmH20;
+    feed.age   = age;
+    feed.at    = micros();
+    feed.fresh = true;
+    feed.received++;
+}
+
+void controlBegin(int16_t target, long maxSpeed) {
+    controller *c = &control;
+    c->on         = true;
+    c->sampled    = false;
+    c->started    = false;
+    c->target     = target;
+    c->integral   = 0;
+    c->maxSpeed   = maxSpeed;
+    c->usedAt     = micros();
+    c->used       = 0;
+    c->stale      = 0;
+    c->latency    = 0;
+    c->latencyMax = 0;
+    feed.fresh    = false;  // landed before the stroke, the next is due soon
+}
+
+// the output is in 1/256 sps until it's applied. the integral only moves when
+// that doesn't push the output further past 0 or maxSpeed
+void controlUpdate() {
+    controller *c = &control;
+    if (!c->on)
+        return;
+    unsigned long now = micros();
+    noInterrupts();
+    bool          fresh   = feed.fresh;
+    int16_t       cmH20   = feed.cmH20;
+    unsigned long latency = feed.age + (now - feed.at);
+    feed.fresh            = false;
+    interrupts();
+
+    if (!fresh) {
+        controlHold(now);
+        return;
+    }
+    if (latency >= CONTROL_STALE) {
+        c->stale++;
+        controlHold(now);
+        return;
+    }
+
+    if (!c->sampled) {
+        c->start   = cmH20;
+        c->last    = cmH20;
+        c->sampled = true;
+    }
+    if (!c->started && cmH20 - c->start >= CONTROL_TAKEUP)
+        controlStart(cmH20 - c->start);
+
+    long limit = c->maxSpeed << 8;
+    long out   = CONTROL_SLACK << 8;
+    if (c->started) {
+        unsigned long rising   = millis() - c->began;
+        long          setpoint = c->target;
+        if (rising < CONTROL_RISE)
+            setpoint = c->start + long(c->target - c->start) * long(rising) / long(CONTROL_RISE);
+
+        long error = setpoint - cmH20;
+        long rate  = c->kd * (cmH20 - c->last);
+        if (error <= 0) {
+            c->integral -= c->integral >> CONTROL_BLEED;
+            out = c->integral - rate;
+        } else {
+            long wind = c->ki * error;
+            out       = c->kp * error + c->integral - rate;
+            if (out < limit) {
+                c->integral = constrain(c->integral + wind, 0, limit);
+                out         = c->kp * error + c->integral - rate;
+            }
+        }
+    }
+    c->last = cmH20;
+    stepSpeed(constrain(out, 0, limit) >> 8);
+
+    c->usedAt  = now;
+    c->latency = latency + (micros() - now);
+    if (c->latency > c->latencyMax)
+        c->latencyMax = c->latency;
+    c->used++;
+}
+
+// the jump grows with the airway's resistance
+void controlStart(int16_t jump) {
+    controller *c = &control;
+    c->kp         = CONTROL_KP;
+    c->ki         = CONTROL_KI;
+    c->kd         = CONTROL_KD;
+    if (jump > CONTROL_JUMP) {
+        c->kp = CONTROL_KP * CONTROL_JUMP / jump;
+        c->ki = CONTROL_KI * CONTROL_JUMP / jump;
+        c->kd = CONTROL_KD * CONTROL_JUMP / jump;
+    }
+    c->began   = millis();
+    c->started = true;
+}
+
+void controlHold(unsigned long now) {
+    if (now - control.usedAt >= CONTROL_STALE)
+        stepSpeed(0);
+}
+
+void controlEnd() {
+    controller *c = &control;
+    c->on         = false;
+    LOG_INFO(PRESSURE_LOOP, c->used, c->stale, c->latencyMax);
+}
@@ -0,0 +1,100 @@
+// ! Pressure Control ! ========================================================
+
+#pragma once
+#include <Arduino.h>
+#include "logger.h"
+#include "stepgen.h"
+
+// in pressure control the inhale is a tracking move, steered by a PI loop with
+// a rate term on the airway pressure the master streams, see master/stream.h.
+// the arm first takes up the bag's slack at CONTROL_SLACK, with nothing to
+// steer on until the airway rises CONTROL_TAKEUP over where it started. the
+// setpoint then climbs from there to the peak target over CONTROL_RISE, so the
+// bag isn't thrown at the lung, and holds there for the plateau. the arm never
+// runs back, an output under 0 stands it still and the integral stops winding
+// while the output is held at either end
+//
+// the wye reads the lung plus resistance times flow, so every change of speed
+// shows at once, but the loop only hears of it a sample and its latency later.
+// the rate term takes CONTROL_KD off for each cmH20 the airway rose since the
+// last sample, and at or over the setpoint the proportional drive is dropped
+// and the integral bleeds, so the arm slows before the peak rather than after
+// it. how far the airway jumped when the slack ran out is the resistance at
+// CONTROL_SLACK, and past CONTROL_JUMP the gains come down in proportion, a
+// narrow airway rings at gains a wide one needs. tuned with host/cosim -p on
+// every patient, make -C host check
+//
+// a sample's age is the master's, conversion start to queued. the time it
+// then sat here is added when it's used, and a sample older than CONTROL_STALE
+// by then is thrown away. with nothing usable for CONTROL_STALE the arm holds
+// where it is until samples come back
+const long          CONTROL_KP     = 15;     // sps per cmH20
+const long          CONTROL_KI     = 60;     // sps per cmH20, added each sample
+const long          CONTROL_KD     = 50;     // sps per cmH20 risen since the last sample
+const uint8_t       CONTROL_BLEED  = 3;      // Integral lost at the setpoint, 1/2^n a sample
+const long          CONTROL_SLACK  = 800;    // Speed until the airway rises (sps)
+const int16_t       CONTROL_TAKEUP = 256;    // Rise that ends the slack, 1/256 cmH20
+const int16_t       CONTROL_JUMP   = 768;    // Largest rise at the gains above, 1/256 cmH20
+const unsigned long CONTROL_RISE   = 300;    // Setpoint climb to the target (ms)
+const unsigned long CONTROL_STALE  = 40000;  // Oldest sample used (us)
+
+// the newest sample from the Wire interrupt
+struct streamFeed {
+    volatile int16_t
+        cmH20;  // 1/256ths
+    volatile uint16_t
+        age;  // us from conversion start to queued on the master
+    volatile unsigned long
+        at;  // micros() it landed
+    volatile bool
+        fresh;  // not yet taken by controlUpdate()
+    volatile unsigned long
+        received;
+};
+
+struct controller {
+    bool
+        on,       // an inhale is being steered
+        sampled,  // the airway's start is known
+        started;  // the slack is taken up and the setpoint climbing
+    int16_t
+        target,  // peak, 1/256 cmH20
+        start,   // airway at the first sample, 1/256 cmH20
+        last;    // airway at the last sample used, 1/256 cmH20
+    long
+        kp, ki, kd,  // the gains for this inhale
+        integral,    // 1/256 sps
+        maxSpeed;    // sps
+    unsigned long
+        began,   // ms, the slack taken up
+        usedAt;  // micros() of the last sample used
+    unsigned int
+        used,        // samples steered on this inhale
+        stale,       // thrown away for age this inhale
+        latency,     // conversion start to speed applied, last sample (us)
+        latencyMax;  // of those this inhale
+};
+
+streamFeed feed;
+controller control;
+
+// files a sample, runs in the Wire interrupt
+void controlStream(int16_t cmH20, uint16_t age);
+
+// starts steering toward target, 1/256 cmH20, at up to maxSpeed sps. the
+// tracking move is the caller's
+void controlBegin(int16_t target, long maxSpeed);
+
+// the slack is taken up, sets the inhale's gains from how far the airway
+// jumped and starts the setpoint climbing
+void controlStart(int16_t jump);
+
+// steers on the newest sample if there's one, call every pass of loop()
+// while the inhale runs
+void controlUpdate();
+
+// stops steering and logs how the inhale's samples fared
+void controlEnd();
+
+// stands the arm still once nothing usable has come for CONTROL_STALE
+void controlHold(unsigned long now);
@@ -0,0 +1,31 @@
+// ! Slave Log Events ! ========================================================
+
+// every event the slave logs, as X(name, id, format). ids 64 - 127 are the
+// slave's, the rest are laid out in master/events.h. no include guard, the
+// decoder reads both boards' tables
+#undef LOG_EVENTS
+#define LOG_EVENTS(X)                                                        \
+    X(DROPPED, 0, "log: %u records dropped")                                 \
+    X(EXHALE_MISSED, 64, "exhale missed the limit switch, homing")           \
+    X(INHALE_ERROR, 65, "inhale error: %d ms")                               \
+    X(STEP_JITTER, 66, "step jitter: %u us, late %u - %u us, mean %u us")    \
+    X(VOLUME_TARGET, 67, "volume target: %d")                                \
+    X(INHALE_TARGET, 68, "inhale target: %d")                                \
+    X(BPM_TARGET, 69, "bpm target: %d")                                      \
+    X(MODE_TARGET, 70, "mode: %d")                                           \
+    X(VOLUME_REACHED, 71, "reached target volume")                           \
+    X(VOLUME_CURRENT, 72, "current volume: %d")                              \
+    X(INHALE_REACHED, 73, "reached target inhale")                           \
+    X(INHALE_CURRENT, 74, "current inhale: %d ms")                           \
+    X(BPM_REACHED, 75, "reached bpm target")                                 \
+    X(BPM_CURRENT, 76, "current cycle period: %d ms")                        \
+    X(FRAME_REJECTED, 77, "frame %u rejected, %u bytes")                     \
+    X(HEAP_CHANGED, 78, "heap changed after setup: %d bytes")                \
+    X(MEMORY, 79, "sram: %u free, %u stack unused, %u heap changes")         \
+    X(HOMED, 80, "homed at %u ms, first breath next")                        \
+    X(CURVE_LOADED, 81, "curve %x, from EEPROM %u")                          \
+    X(CURVE_ADOPTED, 82, "curve %x adopted from the master")                 \
+    X(CURVE_REJECTED, 83, "curve %x rejected")                               \
+    X(CURVE_SAVED, 84, "curve %x saved to EEPROM")                           \
+    X(PEAK_TARGET, 85, "peak target: %u / 256 cmH20")                        \
+    X(PRESSURE_LOOP, 86, "pressure loop: %u samples, %u stale, latency max %u us")
@@ -0,0 +1,166 @@
+// ! Fixed Point Arithmetic ! ==================================================
+
+#pragma once
+
+// the sketches build on their own, so this is a copy of master/fixed.h. change
+// the two together
+
+#include <stdint.h>
+
+// storage for a Q format, and its products and quotients worked in 32 bits.
+// the AVR has an 8x8 multiply and no divide, so libgcc's 64 bit routines
+// would cost more than the float they stand in for. each is a single return
+// so the layouts' constants still fold at compile time under C++11
+template <bool SHORT>
+struct fixedStorage {
+    typedef int32_t raw;
+
+    // (a * b + half) >> f as the 64 bit product would give it. the unsigned
+    // product comes from four 16x16 products, and is made signed by taking
+    // each negative operand's partner off the high word
+    static constexpr raw multiply(raw a, raw b, uint8_t f) {
+        return shift(high(a, b) - (a < 0 ? uint32_t(b) : 0) - (b < 0 ? uint32_t(a) : 0),
+                     low(a, b), f);
+    }
+
+    // (a << f) / b truncated toward zero, the whole part by one 32 bit divide
+    // and the f fraction bits by shift and subtract
+    static constexpr raw divide(raw a, raw b, uint8_t f) {
+        return (a < 0) != (b < 0) ? raw(0 - quotient(magnitude(a), magnitude(b), f))
+                                  : raw(quotient(magnitude(a), magnitude(b), f));
+    }
+
+  private:
+    static constexpr uint32_t product(uint16_t a, uint16_t b) { return uint32_t(a) * b; }
+    static constexpr uint16_t lo16(uint32_t v) { return uint16_t(v); }
+    static constexpr uint16_t hi16(uint32_t v) { return uint16_t(v >> 16); }
+
+    static constexpr uint32_t middle(uint32_t a, uint32_t b) {
+        return (product(lo16(a), lo16(b)) >> 16) + lo16(product(lo16(a), hi16(b))) +
+               lo16(product(hi16(a), lo16(b)));
+    }
+    static constexpr uint32_t low(uint32_t a, uint32_t b) {
+        return middle(a, b) << 16 | lo16(product(lo16(a), lo16(b)));
+    }
+    static constexpr uint32_t high(uint32_t a, uint32_t b) {
+        return product(hi16(a), hi16(b)) + (product(lo16(a), hi16(b)) >> 16) +
+               (product(hi16(a), lo16(b)) >> 16) + (middle(a, b) >> 16);
+    }
+    static constexpr raw shift(uint32_t hi, uint32_t lo, uint8_t f) {
+        return raw((hi + (lo + (uint32_t(1) << f >> 1) < lo)) << (32 - f) |
+                   (lo + (uint32_t(1) << f >> 1)) >> f);
+    }
+
+    static constexpr uint32_t magnitude(raw v) { return v < 0 ? 0 - uint32_t(v) : uint32_t(v); }
+    static constexpr uint32_t quotient(uint32_t a, uint32_t b, uint8_t f) {
+        return fraction(a / b, a % b, b, f);
+    }
+    static constexpr uint32_t fraction(uint32_t q, uint32_t rem, uint32_t b, uint8_t f) {
+        return f == 0          ? q
+               : rem << 1 >= b ? fraction(q << 1 | 1, (rem << 1) - b, b, f - 1)
+                               : fraction(q << 1, rem << 1, b, f - 1);
+    }
+};
+
+template <>
+struct fixedStorage<true> {
+    typedef int16_t raw;
+
+    static constexpr raw multiply(raw a, raw b, uint8_t f) {
+        return raw((int32_t(a) * b + (int32_t(1) << f >> 1)) >> f);
+    }
+    static constexpr raw divide(raw a, raw b, uint8_t f) {
+        return raw(int32_t(a) * (int32_t(1) << f) / b);
+    }
+};
+
+// signed Q format number with I integer bits and F fraction bits. values are
+// plain integers scaled by 2^F, so add, subtract and compare cost the same as
+// an int, and multiply and divide stay in 32 bits, see fixedStorage. the
+// double constructor is for constants, where the compiler does the conversion
+template <uint8_t I, uint8_t F>
+class fixed {
+  public:
+    typedef fixedStorage<(I + F < 16)> storage;
+    typedef typename storage::raw      raw_t;
+
+    static const int32_t ONE  = int32_t(1) << F;
+    static const int32_t HALF = ONE >> 1;
+
+    constexpr fixed()
+        : r(0) {}
+    constexpr explicit fixed(int v)
+        : r(raw_t(v * ONE)) {}
+    constexpr explicit fixed(double v)
+        : r(raw_t(v * ONE + (v < 0 ? -0.5 : 0.5))) {}
+
+    static constexpr fixed fromRaw(raw_t raw) { return fixed(raw, true); }
+    constexpr raw_t        raw() const { return r; }
+
+    // whole part, truncated toward zero like a cast from float
+    constexpr int toInt() const { return r / ONE; }
+
+    // nearest whole number, halves away from zero
+    constexpr int round() const { return (r < 0 ? r - HALF : r + HALF) / ONE; }
+
+    constexpr fixed operator-() const { return fromRaw(-r); }
+    constexpr fixed operator+(fixed o) const { return fromRaw(r + o.r); }
+    constexpr fixed operator-(fixed o) const { return fromRaw(r - o.r); }
+    constexpr fixed operator*(int v) const { return fromRaw(raw_t(uint32_t(r) * uint32_t(v))); }
+    constexpr fixed operator/(int v) const { return fromRaw(r / v); }
+    friend constexpr fixed operator*(int v, fixed f) { return f * v; }
+
+    // products round to the nearest fraction bit, quotients truncate
+    constexpr fixed operator*(fixed o) const { return fromRaw(storage::multiply(r, o.r, F)); }
+    constexpr fixed operator/(fixed o) const { return fromRaw(storage::divide(r, o.r, F)); }
+
+    fixed &operator+=(fixed o) { return *this = *this + o; }
+    fixed &operator-=(fixed o) { return *this = *this - o; }
+
+    constexpr bool operator==(fixed o) const { return r == o.r; }
+    constexpr bool operator!=(fixed o) const { return r != o.r; }
+    constexpr bool operator<(fixed o) const { return r < o.r; }
+    constexpr bool operator>(fixed o) const { return r > o.r; }
+    constexpr bool operator<=(fixed o) const { return r <= o.r; }
+    constexpr bool operator>=(fixed o) const { return r >= o.r; }
+
+    // writes the value rounded to places decimals, right aligned in places + 2
+    // columns the way dtostrf() pads, so text lands where the float did. buf
+    // needs room for the digits, sign, point and terminator. the whole and
+    // fraction parts are scaled apart so neither leaves 32 bits
+    char *format(char *buf, uint8_t places) const {
+        uint32_t scale = 1;
+        for (uint8_t i = 0; i < places; i++)
+            scale *= 10;
+        uint32_t mag = r < 0 ? 0 - uint32_t(r) : uint32_t(r);
+        uint32_t v   = (mag >> F) * scale + (((mag & (ONE - 1)) * scale + HALF) >> F);
+        char    digits[16];
+        uint8_t n = 0;
+        do {
+            digits[n++] = '0' + v % 10;
+            v /= 10;
+            if (n == places)
+                digits[n++] = '.';
+        } while (v || n <= places + (places ? 1 : 0));
+
+        uint8_t width = n + (r < 0 ? 1 : 0);
+        char   *p     = buf;
+        while (width++ < places + 2)
+            *p++ = ' ';
+        if (r < 0)
+            *p++ = '-';
+        while (n)
+            *p++ = digits[--n];
+        *p = '\0';
+        return buf;
+    }
+
+  private:
+    constexpr fixed(raw_t raw, bool)
+        : r(raw) {}
+
+    raw_t r;
+};
+
+// dial settings, pressures and angles all fit comfortably in Q15.16
+typedef fixed<15, 16> q16;
@@ -0,0 +1,85 @@
+// ! Step Ramp ! ===============================================================
+
+// generated by host/rampgen, do not edit
+// Timer1 ticks from step k to step k + 1 of a move from rest at
+// RAMP_ACCELERATION, down to the gap of a step at MAX_SPEED
+
+#pragma once
+
+#define RAMP_ACCELERATION 24000
+#define RAMP_TICK_HZ 2000000UL
+#define RAMP_STEPS 854
+
+const uint16_t rampTicks[RAMP_STEPS] PROGMEM = {
+    18257, 7562, 5803, 4892, 4310, 3897, 3583, 3335, 3132, 2963, 2818, 2693,
+    2583, 2485, 2398, 2319, 2248, 2182, 2123, 2067, 2016, 1969, 1925, 1883,
+    1844, 1808, 1773, 1741, 1710, 1681, 1653, 1627, 1601, 1577, 1554, 1532,
+    1511, 1491, 1471, 1453, 1434, 1417, 1400, 1384, 1368, 1353, 1339, 1325,
+    1311, 1298, 1285, 1272, 1260, 1248, 1237, 1225, 1214, 1204, 1194, 1183,
+    1174, 1164, 1155, 1146, 1137, 1128, 1119, 1111, 1103, 1095, 1087, 1080,
+    1072, 1065, 1058, 1051, 1044, 1037, 1030, 1024, 1017, 1011, 1005, 999,
+    993, 987, 982, 976, 970, 965, 960, 954, 949, 944, 939, 934,
+    929, 925, 920, 915, 911, 906, 902, 897, 893, 889, 885, 880,
+    876, 872, 868, 865, 861, 857, 853, 849, 846, 842, 839, 835,
+    832, 828, 825, 821, 818, 815, 812, 808, 805, 802, 799, 796,
+    793, 790, 787, 784, 781, 779, 776, 773, 770, 767, 765, 762,
+    759, 757, 754, 752, 749, 747, 744, 742, 739, 737, 734, 732,
+    730, 727, 725, 723, 721, 718, 716, 714, 712, 710, 707, 705,
+    703, 701, 699, 697, 695, 693, 691, 689, 687, 685, 683, 681,
+    679, 678, 676, 674, 672, 670, 668, 667, 665, 663, 661, 660,
+    658, 656, 655, 653, 651, 650, 648, 646, 645, 643, 642, 640,
+    638, 637, 635, 634, 632, 631, 629, 628, 626, 625, 623, 622,
+    620, 619, 618, 616, 615, 613, 612, 611, 609, 608, 607, 605,
+    604, 603, 601, 600, 599, 597, 596, 595, 594, 592, 591, 590,
+    589, 587, 586, 585, 584, 583, 581, 580, 579, 578, 577, 576,
+    574, 573, 572, 571, 570, 569, 568, 567, 566, 565, 563, 562,
+    561, 560, 559, 558, 557, 556, 555, 554, 553, 552, 551, 550,
+    549, 548, 547, 546, 545, 544, 543, 542, 541, 540, 539, 538,
+    537, 537, 536, 535, 534, 533, 532, 531, 530, 529, 528, 527,
+    527, 526, 525, 524, 523, 522, 521, 521, 520, 519, 518, 517,
+    516, 516, 515, 514, 513, 512, 512, 511, 510, 509, 508, 508,
+    507, 506, 505, 504, 504, 503, 502, 501, 501, 500, 499, 498,
+    498, 497, 496, 495, 495, 494, 493, 493, 492, 491, 490, 490,
+    489, 488, 488, 487, 486, 486, 485, 484, 483, 483, 482, 481,
+    481, 480, 479, 479, 478, 477, 477, 476, 476, 475, 474, 474,
+    473, 472, 472, 471, 470, 470, 469, 469, 468, 467, 467, 466,
+    466, 465, 464, 464, 463, 463, 462, 461, 461, 460, 460, 459,
+    458, 458, 457, 457, 456, 456, 455, 454, 454, 453, 453, 452,
+    452, 451, 451, 450, 449, 449, 448, 448, 447, 447, 446, 446,
+    445, 445, 444, 444, 443, 443, 442, 442, 441, 440, 440, 439,
+    439, 438, 438, 437, 437, 436, 436, 435, 435, 434, 434, 433,
+    433, 432, 432, 432, 431, 431, 430, 430, 429, 429, 428, 428,
+    427, 427, 426, 426, 425, 425, 424, 424, 424, 423, 423, 422,
+    422, 421, 421, 420, 420, 420, 419, 419, 418, 418, 417, 417,
+    416, 416, 416, 415, 415, 414, 414, 413, 413, 413, 412, 412,
+    411, 411, 411, 410, 410, 409, 409, 408, 408, 408, 407, 407,
+    406, 406, 406, 405, 405, 404, 404, 404, 403, 403, 402, 402,
+    402, 401, 401, 401, 400, 400, 399, 399, 399, 398, 398, 397,
+    397, 397, 396, 396, 396, 395, 395, 394, 394, 394, 393, 393,
+    393, 392, 392, 392, 391, 391, 390, 390, 390, 389, 389, 389,
+    388, 388, 388, 387, 387, 387, 386, 386, 386, 385, 385, 385,
+    384, 384, 384, 383, 383, 383, 382, 382, 382, 381, 381, 381,
+    380, 380, 380, 379, 379, 379, 378, 378, 378, 377, 377, 377,
+    376, 376, 376, 375, 375, 375, 374, 374, 374, 373, 373, 373,
+    373, 372, 372, 372, 371, 371, 371, 370, 370, 370, 369, 369,
+    369, 369, 368, 368, 368, 367, 367, 367, 366, 366, 366, 366,
+    365, 365, 365, 364, 364, 364, 364, 363, 363, 363, 362, 362,
+    362, 362, 361, 361, 361, 360, 360, 360, 360, 359, 359, 359,
+    358, 358, 358, 358, 357, 357, 357, 357, 356, 356, 356, 355,
+    355, 355, 355, 354, 354, 354, 354, 353, 353, 353, 353, 352,
+    352, 352, 351, 351, 351, 351, 350, 350, 350, 350, 349, 349,
+    349, 349, 348, 348, 348, 348, 347, 347, 347, 347, 346, 346,
+    346, 346, 345, 345, 345, 345, 344, 344, 344, 344, 343, 343,
+    343, 343, 342, 342, 342, 342, 342, 341, 341, 341, 341, 340,
+    340, 340, 340, 339, 339, 339, 339, 338, 338, 338, 338, 338,
+    337, 337, 337, 337, 336, 336, 336, 336, 335, 335, 335, 335,
+    335, 334, 334, 334, 334, 333, 333, 333, 333, 333, 332, 332,
+    332, 332, 331, 331, 331, 331, 331, 330, 330, 330, 330, 330,
+    329, 329, 329, 329, 328, 328, 328, 328, 328, 327, 327, 327,
+    327, 327, 326, 326, 326, 326, 326, 325, 325, 325, 325, 324,
+    324, 324, 324, 324, 323, 323, 323, 323, 323, 322, 322, 322,
+    322, 322, 321, 321, 321, 321, 321, 320, 320, 320, 320, 320,
+    319, 319, 319, 319, 319, 318, 318, 318, 318, 318, 318, 317,
+    317, 317, 317, 317, 316, 316, 316, 316, 316, 315, 315, 315,
+    315, 315, 315, 314, 314, 314, 314, 314, 313, 313, 313, 313,
+    313, 312};
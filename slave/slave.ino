@@ -3,33 +3,52 @@
 #include <Arduino.h>
 #include <SpeedyStepper.h>
 #include <Wire.h>
+#include "calibration.h"
+#include "control.h"
+#include "fixed.h"
+#include "logger.h"
+#include "memory.h"
+#include "stepgen.h"
 
 // * SPECS =====================================================================
 
-const float MAX_TV  = 0.8;
-const float MIN_TV  = 0.2;
-const float INC_TV  = 0.02;
-const int   MIN_IT  = 500;
-const int   MAX_IT  = 2000;
-const int   INC_IT  = 50;
-const int   MAX_BPM = 40;
-const int   MIN_BPM = 5;
-const int   INC_BPM = 1;
+const int   MAX_TV   = 800;
+const int   MIN_TV   = 200;
+const int   INC_TV   = 20;
+const int   MIN_IT   = 500;
+const int   MAX_IT   = 2000;
+const int   INC_IT   = 50;
+const int   MAX_BPM  = 40;
+const int   MIN_BPM  = 5;
+const int   INC_BPM  = 1;
+const int   MIN_PEAK = 10 * 256;  // 1/256 cmH20, as the master sends it
+const int   MAX_PEAK = 40 * 256;
+const int   INC_PEAK = 128;
+
+const int MODE_PRESSURE = 3;  // selector mode the inhale is pressure controlled in
 
 // * MOTOR PARAMETERS ==========================================================
 
-const float MICRO_STEP       = 1.0;    // Microstepping (0.5 for 1/2)
-const float REDUCTION        = 80.0;   // Reduction Ratio
-const float STEP_ANGLE       = 0.9;    // Angle per step for your motor
-const float STEPS            = 400.0;  // Steps per rotation for your motor
-const float MIN_DEG          = 7.5;    // Angle for min volume
-const float MAX_DEG          = 25.0;   // Angle for max volume
-const float MAX_SPEED        = 16.0;   // Max speed in RPS
-const float MAX_ACCELERATION = 24000;  // Accel in SPS
-const float ACCEL            = 8500;   // A "big enough" value to not matter
-const float DECEL            = 8500;   // A "big enough" value to not matter
-const int   INHALE_DIR       = 1;      // Inhale direction
-const int   EXHALE_DIR       = -1;     // Exhale direction
+const float MICRO_STEP       = 1.0;        // Microstepping (0.5 for 1/2)
+const float REDUCTION        = 80.0;       // Reduction Ratio
+const float STEP_ANGLE       = 0.9;        // Angle per step for your motor
+const float STEPS            = 400.0;      // Steps per rotation for your motor
+const float MAX_SPEED        = 16.0;       // Max speed in RPS
+const float MAX_ACCELERATION = 24000;      // Accel in SPS
+const float ACCEL            = 8500;       // A "big enough" value to not matter
+const float DECEL            = 8500;       // A "big enough" value to not matter
+const int   INHALE_DIR       = 1;          // Inhale direction
+const int   EXHALE_DIR       = -1;         // Exhale direction
+const long  EXHALE_SPEED     = 5600;       // Exhale speed in SPS (14 RPS)
+const q16   OVERTRAVEL       = q16(2.0);   // Exhale past the start to find the switch
+const q16   AWAY_DEG         = q16(0.5);   // Rest this far off the switch
+const long  AWAY_SPEED       = 1000;       // Speed off the switch in SPS
+
+// steps to turn the arm 1 degree
+const q16 STEPS_PER_DEG = q16(STEPS * REDUCTION * MICRO_STEP / 360);
+
+// steps per second the motor can be driven at
+const long MAX_SPS = long(MAX_SPEED * STEPS);
 
 // * PIN DEFINITIONS ===========================================================
 
@@ -45,11 +64,13 @@ SpeedyStepper stepper;
 // * GLOBALS ===================================================================
 
 bool    once = false;
-uint8_t command;
 uint8_t response;
-float   volumeTarget;
+uint8_t ackSeq;
+int     volumeTarget;
 int     inhaleTarget;
 int     bpmTarget;
+int     modeTarget;
+int     peakTarget;
 bool    atVolumeTarget = true;
 bool    atInhaleTarget = true;
 bool    atBpmTarget    = true;
@@ -63,7 +84,8 @@ struct timers {
         current,
         entered,
         elapsed,
-        exited;
+        exited,
+        cycleStart;
 } t;
 
 struct cycle {
@@ -73,19 +95,41 @@ struct cycle {
         exhalePeriod,
         cyclePeriod,
         restPeriod,
-        inhaleDiff,
+        inhaleDiff,  // stroke time less inhale period, the timing error
         steps,
-        speed;
-    float
+        speed,
         volume,
-        angle,
+        peak,        // pressure control's target, 1/256 cmH20
+        delivered,   // volume the last inhale stroke gave (mL)
+        inhaleTime,  // measured length of the last inhale stroke
+        exhaleTime,  // measured length of the last exhale
+        cycleTime;   // measured start to start of the last two inhales
+    unsigned int
+        cycles;  // inhales started since power up
+    q16
         speedAdjustment;
     bool
         ready,
+        pressureControl,  // inhales track peak rather than run to volume
+        planLimited,  // the stroke can't be made in the period
         inhaleComplete,
+        backingOff,  // exhale found the switch and is moving off it
         exhaleComplete;
 } breath;
 
+// * PROTOTYPES ================================================================
+
+int     degreeToSteps(q16 deg);
+void    exhaleUpdate();
+void    stepReport();
+void    updateHandler();
+void    packTelemetry();
+long    planInhale(long steps, long period);
+void    learnTrim();
+int8_t *inhaleTrim();
+void    volumeUpdate();
+void    inhaleUpdate();
+
 // * INIT DEFAULTS =============================================================
 
 void initDefaults() {
@@ -93,7 +137,9 @@ void initDefaults() {
     breath.inhalePeriod = 2000;
     breath.exhalePeriod = 500;  // equal to min inhale time
     breath.restPeriod   = breath.cyclePeriod - (breath.inhalePeriod + breath.exhalePeriod);
-    breath.volume       = 0.5;
+    breath.volume       = 500;
+    breath.peak         = 30 * 256;
+    peakTarget          = breath.peak;
 }
 
 // * HOMING ====================================================================
@@ -103,8 +149,8 @@ void motorDisable() { digitalWrite(ENABLE, HIGH); }
 
 // homing likes to stay on the limit switch, this moves 0.5 deg away from it
 void moveAwayFromHome() {
-    int travel = degreeToSteps(0.5);
-    stepper.setSpeedInStepsPerSecond(1000);
+    int travel = degreeToSteps(AWAY_DEG);
+    stepper.setSpeedInStepsPerSecond(AWAY_SPEED);
     stepper.setAccelerationInStepsPerSecondPerSecond(MAX_ACCELERATION);
     stepper.setCurrentPositionInSteps(0);
     stepper.moveToPositionInSteps(INHALE_DIR * travel);
@@ -119,38 +165,61 @@ void moveToHome() {
 
 // * BREATHING LOGIC ===========================================================
 
-// perform the inhale with corresponding speed for the inhale time
+// strokes run on the step generator, so manager() only starts them and
+// watches for the end. SpeedyStepper is left to homing at power up
+
+// perform the inhale with corresponding speed for the inhale time, less what
+// this setting has been running over by. in pressure control the stroke is
+// whatever the loop drives it to in the period, up to the curve's top
 void inhale() {
-    breath.angle = volumeToDegree(breath.volume);
-    breath.steps = degreeToSteps(breath.angle);
-    breath.speed = float(breath.steps) / (float(breath.inhalePeriod) / 1000.0);
-    //Serial.print("breath.speed: ");
-    //Serial.println(String(breath.speed));
-    // TODO: Implement some kind of speed adjust to meet inhale time target
-    //Serial.print("breath.speed(adjusted): ");
-    //Serial.println(String(breath.speed));
-
-    //Serial.println("breath.angle: " + String(breath.angle, 2));
+    breath.inhaleComplete = false;
+    if (breath.pressureControl) {
+        breath.steps = volumeToSteps(MAX_TV);
+        stepLatenessReset();
+        controlBegin(breath.peak, MAX_SPS);
+        stepTrack(breath.steps, INHALE_DIR);
+        return;
+    }
+    breath.steps = volumeToSteps(breath.volume);
+    breath.speed = planInhale(breath.steps, breath.inhalePeriod - *inhaleTrim());
+
     //Serial.println("breath.steps: " + String(breath.steps));
     //Serial.println("ACCEL: " + String(MAX_ACCELERATION));
-    stepper.setSpeedInStepsPerSecond(breath.speed);
-    stepper.setAccelerationInStepsPerSecondPerSecond(MAX_ACCELERATION);
-    stepper.setCurrentPositionInSteps(0);
-    stepper.setupMoveInSteps(INHALE_DIR * breath.steps);
+    stepLatenessReset();
+    stepMove(breath.steps, INHALE_DIR, breath.speed, false);
 }
 
 // exhale is meant to open the mechanism as fast as possible to let the BVM bag
-// re-fill naturally
+// re-fill naturally. it runs back past where the inhale started and stops on
+// the limit switch, then exhaleUpdate() backs off it
 void exhale() {
-    stepper.setAccelerationInStepsPerSecondPerSecond(MAX_ACCELERATION);
-    stepper.moveToHomeInSteps(EXHALE_DIR, STEPS * 14, STEPS * 6, LIMIT);
-    moveAwayFromHome();
+    breath.backingOff     = false;
+    breath.exhaleComplete = false;
+    stepMove(breath.steps + degreeToSteps(OVERTRAVEL), EXHALE_DIR, EXHALE_SPEED, true);
+}
+
+// follows the exhale through to sitting off the switch. an exhale that never
+// saw the switch has lost steps, so it homes the slow way
+void exhaleUpdate() {
+    if (breath.exhaleComplete || !stepIdle())
+        return;
+    if (breath.backingOff) {
+        breath.exhaleComplete = true;
+    } else if (stepgen.atLimit) {
+        breath.backingOff = true;
+        stepMove(degreeToSteps(AWAY_DEG), INHALE_DIR, AWAY_SPEED, false);
+    } else {
+        LOG_WARN(EXHALE_MISSED);
+        moveToHome();
+        breath.exhaleComplete = true;
+    }
 }
 
 void manager() {
     updateHandler();
 
-    if (digitalRead(LIMIT) == 0) {
+    // the exhale stops on the switch itself, anything else is a bump
+    if (breath.state != 2 && stepIdle() && digitalRead(LIMIT) == 0) {
         moveAwayFromHome();
     }
 
@@ -161,13 +230,16 @@ void manager() {
             once      = true;
             if (!atVolumeTarget) { volumeUpdate(); }
             if (!atInhaleTarget) { inhaleUpdate(); }
+            // the loop ramps its setpoint, so mode and peak go straight in
+            breath.pressureControl = modeTarget == MODE_PRESSURE;
+            breath.peak            = peakTarget;
             //Serial.print("entered rest: ");
             //Serial.println(String(float(t.entered) / 1000.0, 2));
         }
 
         t.elapsed = millis() - t.entered;
 
-        if (t.elapsed >= breath.restPeriod || breath.ready) {
+        if (t.elapsed >= (unsigned long)breath.restPeriod || breath.ready) {
             t.exited = t.elapsed;
             //Serial.print("exited rest: +");
             //Serial.println(String(float(t.exited) / 1000.0, 2));
@@ -188,18 +260,43 @@ void manager() {
         if (!once) {
             t.entered = millis();
             motorEnable();
-            inhale();  // gets called once, processMovement() does the rest
+            inhale();  // gets called once, the step generator does the rest
             once         = true;
             breath.ready = false;  // reset
+            if (breath.cycles > 0)
+                breath.cycleTime = t.entered - t.cycleStart;
+            t.cycleStart = t.entered;
+            breath.cycles++;
+            packTelemetry();
             //Serial.print("entered inhale: ");
             //Serial.println(String(float(t.entered) / 1000.0, 2));
         }
 
         t.elapsed = millis() - t.entered;
 
-        if (t.elapsed >= breath.inhalePeriod && stepper.motionComplete()) {
+        // a pressure controlled stroke is steered till the period is up, or
+        // it reaches the top of the curve
+        if (breath.pressureControl && !breath.inhaleComplete) {
+            controlUpdate();
+            if (t.elapsed >= (unsigned long)breath.inhalePeriod)
+                stepStop();
+            if (stepIdle()) {
+                breath.steps = stepDone();
+                controlEnd();
+            }
+        }
+
+        // the stroke is the inhale the patient gets, anything left of the
+        // period after it is a hold
+        if (!breath.inhaleComplete && stepIdle()) {
+            breath.inhaleComplete = true;
+            breath.inhaleTime     = t.elapsed;
+            breath.delivered      = breath.pressureControl ? stepsToVolume(breath.steps)
+                                                           : breath.volume;
+        }
+
+        if (t.elapsed >= (unsigned long)breath.inhalePeriod && stepIdle()) {
             t.exited = t.elapsed;
-            //breath.inhaleDiff = t.exited - breath.inhalePeriod;
             //Serial.print("exited inhale: +");
             //Serial.println(String(float(t.exited) / 1000.0, 2));
             //Serial.print("breath.inhalePeriod: ");
@@ -207,8 +304,14 @@ void manager() {
             //Serial.print("difference: ");
             //Serial.println(String(float(t.exited - breath.inhalePeriod) / 1000.0, 2));
             //Serial.println("--------------------");
-            breath.state = 2;
-            once         = false;
+            breath.inhaleDiff = breath.inhaleTime - breath.inhalePeriod;
+            breath.state      = 2;
+            once              = false;
+            if (!breath.pressureControl)
+                learnTrim();
+            packTelemetry();
+            LOG_INFO(INHALE_ERROR, breath.inhaleDiff);
+            stepReport();
             t.elapsed    = 0;
             t.entered    = 0;
             t.exited     = 0;
@@ -223,8 +326,13 @@ void manager() {
             //Serial.print("entered exhale: ");
             //Serial.println(String(float(t.entered) / 1000.0, 2));
         }
+        exhaleUpdate();
         t.elapsed = millis() - t.entered;
-        if (t.elapsed >= breath.exhalePeriod && stepper.motionComplete()) {
+        // the homing before the first breath has no bag to wait on
+        bool refilled = t.elapsed >= (unsigned long)breath.exhalePeriod || breath.cycles == 0;
+        if (refilled && breath.exhaleComplete) {
+            if (breath.cycles == 0)
+                LOG_INFO(HOMED, millis());
             t.exited = t.elapsed;
             //Serial.print("exited exhale: +");
             //Serial.println(String(float(t.exited) / 1000.0, 2));
@@ -233,8 +341,10 @@ void manager() {
             //Serial.print("difference: ");
             //Serial.println(String(float(t.exited - breath.exhalePeriod) / 1000.0, 2));
             //Serial.println("--------------------");
-            breath.state = 0;
-            once         = false;
+            breath.exhaleTime = t.exited;
+            breath.state      = 0;
+            once              = false;
+            packTelemetry();
             t.elapsed    = 0;
             t.entered    = 0;
             t.exited     = 0;
@@ -242,48 +352,126 @@ void manager() {
     }
 }
 
-// * MISC ======================================================================
+// * MOTION PLANNING ===========================================================
+
+// trim is learned for bands of 4 increments of volume by 4 of inhale time
+const uint8_t TRIM_BAND     = 4;
+const uint8_t TRIM_BANDS_TV = (MAX_TV - MIN_TV) / INC_TV / TRIM_BAND + 1;
+const uint8_t TRIM_BANDS_IT = (MAX_IT - MIN_IT) / INC_IT / TRIM_BAND + 1;
+const int8_t  TRIM_MAX      = 120;  // Largest correction (ms)
+
+// ms taken off the planned period for each band of settings, learned from
+// how far each stroke ran over
+int8_t trims[TRIM_BANDS_TV][TRIM_BANDS_IT];
+
+// the trim for the current volume and inhale period
+int8_t *inhaleTrim() {
+    return &trims[(breath.volume - MIN_TV) / INC_TV / TRIM_BAND]
+                 [(breath.inhalePeriod - MIN_IT) / INC_IT / TRIM_BAND];
+}
 
-// floating point re-implementation of map()
-float mapf(float x, float in_min, float in_max, float out_min, float out_max) {
-    float val = (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
-    return val;
+unsigned long isqrt(unsigned long n) {
+    unsigned long root = 0;
+    unsigned long bit  = 1UL << 30;
+    while (bit > n)
+        bit >>= 2;
+    while (bit) {
+        if (n >= root + bit) {
+            n -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
 }
 
-// floating point comparison can fail by rounding tolerances
-bool roughlyEqual(float a, float b) {
-    if (abs(a - b) < 0.0001)
-        return true;
+// cruise speed of the trapezoid that covers steps in period ms, ramping at
+// RAMP_ACCELERATION at both ends like the step generator does. a move at
+// cruise speed v and acceleration a takes T = S / v + v / a, so
+// v = (aT - sqrt((aT)^2 - 4aS)) / 2. when (aT)^2 < 4aS not even a triangle
+// makes it, and the fastest move is the triangle peaking at sqrt(aS)
+long planInhale(long steps, long period) {
+    unsigned long a   = RAMP_ACCELERATION;
+    unsigned long aT  = a * period / 1000;
+    unsigned long aS4 = 4 * a * steps;
+    long          speed;
+
+    breath.planLimited = aT * aT < aS4;
+    if (breath.planLimited)
+        speed = isqrt(a * steps);
     else
-        return false;
+        speed = (aT - isqrt(aT * aT - aS4) + 1) / 2;
+
+    if (speed > MAX_SPS) {
+        speed              = MAX_SPS;
+        breath.planLimited = true;
+    }
+    return speed;
 }
 
-// get the amount of steps to travel a given angle
-int degreeToSteps(float deg) {
-    return deg * ((STEPS * REDUCTION * MICRO_STEP) / 360);
+// moves the trim a quarter of the way toward cancelling the last error. part
+// of each error is the plan rounding to whole steps and ramp ticks, which a
+// half step chases back and forth, overshooting by up to 1.3 ms in cosim -c
+// where a quarter settles on 0. a stroke the planner couldn't fit says
+// nothing about the trim
+void learnTrim() {
+    if (breath.planLimited)
+        return;
+    int8_t *trim = inhaleTrim();
+    *trim        = constrain(*trim + breath.inhaleDiff / 4, -TRIM_MAX, TRIM_MAX);
 }
 
-// TODO: Re-implement more volume delivery functions
-// get the travel angle for a given volume
-float volumeToDegree(float volume) {
-    volume = mapf(volume, MIN_TV, MAX_TV, MIN_DEG, MAX_DEG);
-    return volume;
+// logs how late the inhale's steps went out after their timer match. the
+// spread is the jitter on the step intervals, the timer itself doesn't drift
+void stepReport() {
+    uint16_t lateMin, lateMax, lateMean;
+    stepLateness(&lateMin, &lateMax, &lateMean);
+    LOG_INFO(STEP_JITTER, lateMax - lateMin, lateMin, lateMax, lateMean);
+}
+
+// * MISC ======================================================================
+
+// get the amount of steps to travel a given angle, to the nearest step
+int degreeToSteps(q16 deg) {
+    return (deg * STEPS_PER_DEG).round();
 }
 
 // * I2C =======================================================================
 
-const uint8_t SLAVE_ADDR  = 9;                // This slaves address
-const uint8_t ANSWER_SIZE = sizeof(uint8_t);  // Bytes of transmission
-
-uint8_t commandList[] = {
-    3,  // ready for breath
-    4,  // cancel breath part way
-    5,  // enable motor
-    6,  // disable motor
-    7,  // volume control mode
-    8,  // pressure control mode
-    9   // sigh
-};
+// settings arrive as frames from the master, see master/comm.h
+//
+//   frame  [START][seq][fields][type value]...[crc]
+//   reply  [START][seq][status][telemetry][crc]
+//
+// the reply is the ack of the last frame followed by the status block, so the
+// master can poll the block with a read on its own. in pressure control the
+// master also streams airway pressure, see master/stream.h
+//
+//   sample [STREAM_START][cmH20][age][crc]
+//
+// which goes to the loop and leaves the reply as it was
+
+const uint8_t SLAVE_ADDR  = 9;     // This slaves address
+const uint8_t FRAME_START = 0xA5;  // First byte of every frame and reply
+const uint8_t FRAME_SIZE  = 32;    // Largest frame, the Wire buffer
+const uint8_t STREAM_START   = 0x5A;                    // First byte of a pressure sample
+const uint8_t STREAM_SIZE    = 6;                       // Bytes of a sample
+const uint8_t TELEMETRY_SIZE = 17;                      // Bytes of the status block
+const uint8_t REPLY_SIZE     = 3 + TELEMETRY_SIZE + 1;  // Bytes of a reply
+
+// status block, little endian
+//   state        uint8   breath.state
+//   volume       uint16  applied volume (mL), delivered in pressure control
+//   inhale       uint16  applied inhale period (ms)
+//   cycle        uint16  applied cycle period (ms)
+//   inhaleTime   uint16  measured last inhale (ms)
+//   exhaleTime   uint16  measured last exhale (ms)
+//   cycleTime    uint16  measured last cycle (ms)
+//   cycles       uint16  inhales started
+//   curve        uint16  check of the volume curve in use
+uint8_t telemetry[TELEMETRY_SIZE];
 
 struct responses {
     uint8_t
@@ -298,126 +486,364 @@ struct responses {
         , finished{19} {}
 } send;
 
-// populate commandList with valid command ranges for volume, bpm and inhale
-void fillCommandList() {
-    for (i = 20; i <= 115; i++) {
-        commandList[i] = i;
-    }
+// bits of update.fields
+const uint8_t UPDATE_READY  = 0x01;
+const uint8_t UPDATE_VOLUME = 0x02;
+const uint8_t UPDATE_INHALE = 0x04;
+const uint8_t UPDATE_BPM    = 0x08;
+const uint8_t UPDATE_MODE   = 0x10;
+const uint8_t UPDATE_CURVE  = 0x20;
+const uint8_t UPDATE_PEAK   = 0x40;
+
+// settings taken from frames by receive() and not yet applied by
+// updateHandler()
+struct update {
+    uint8_t fields;
+    int
+        volume,
+        inhale,
+        bpm,
+        mode,
+        peak;  // 1/256 cmH20
+    uint16_t
+        check;  // of the curve to commit
+    const uint8_t
+        *chunk;  // the frame's curve field, staged once it's all checked
+} incoming;
+
+uint8_t crc8(const uint8_t *data, uint8_t length);
+bool    readFrame(const uint8_t *frame, uint8_t length, update *u);
+
+// * FIELDS ====================================================================
+
+// each reader range checks a field's value and files it in u, false refuses
+// the frame
+typedef bool (*fieldReader)(const uint8_t *value, update *u);
+
+bool readReady(const uint8_t *value, update *u) {
+    u->fields |= UPDATE_READY;
+    return true;
+}
+
+// known but nothing to do yet
+bool readIgnored(const uint8_t *value, update *u) {
+    return true;
+}
+
+bool readVolume(const uint8_t *value, update *u) {
+    int volume = value[0] | value[1] << 8;
+    if (volume < MIN_TV || volume > MAX_TV || (volume - MIN_TV) % INC_TV)
+        return false;
+    u->volume = volume;
+    u->fields |= UPDATE_VOLUME;
+    return true;
+}
+
+bool readInhale(const uint8_t *value, update *u) {
+    int inhale = value[0] | value[1] << 8;
+    if (inhale < MIN_IT || inhale > MAX_IT || (inhale - MIN_IT) % INC_IT)
+        return false;
+    u->inhale = inhale;
+    u->fields |= UPDATE_INHALE;
+    return true;
+}
+
+bool readBpm(const uint8_t *value, update *u) {
+    if (value[0] < MIN_BPM || value[0] > MAX_BPM)
+        return false;
+    u->bpm = value[0];
+    u->fields |= UPDATE_BPM;
+    return true;
+}
+
+bool readMode(const uint8_t *value, update *u) {
+    if (value[0] < 1 || value[0] > 4)
+        return false;
+    u->mode = value[0];
+    u->fields |= UPDATE_MODE;
+    return true;
+}
+
+bool readPeak(const uint8_t *value, update *u) {
+    int peak = value[0] | value[1] << 8;
+    if (peak < MIN_PEAK || peak > MAX_PEAK || (peak - MIN_PEAK) % INC_PEAK)
+        return false;
+    u->peak = peak;
+    u->fields |= UPDATE_PEAK;
+    return true;
+}
+
+// a frame carries one chunk of curve at most, so it can be staged from the
+// frame once the frame has passed
+bool readCurve(const uint8_t *value, update *u) {
+    if (u->chunk || value[0] % CALIBRATION_CHUNK || value[0] >= CURVE_POINTS)
+        return false;
+    u->chunk = value;
+    return true;
 }
 
-void receive() {
+bool readCurveCommit(const uint8_t *value, update *u) {
+    u->check = value[0] | value[1] << 8;
+    u->fields |= UPDATE_CURVE;
+    return true;
+}
+
+struct field {
+    uint8_t     type;
+    uint8_t     size;  // value bytes after the type
+    fieldReader read;
+};
+
+// field types a frame may carry
+constexpr field fields[] PROGMEM = {
+    {3, 0, readReady},         // ready for breath
+    {4, 0, readIgnored},       // cancel breath part way
+    {5, 0, readIgnored},       // enable motor
+    {6, 0, readIgnored},       // disable motor
+    {7, 0, readIgnored},       // volume control mode
+    {8, 0, readIgnored},       // pressure control mode
+    {9, 0, readIgnored},       // sigh
+    {20, 2, readVolume},       // uint16, tidal volume in mL
+    {21, 2, readInhale},       // uint16, inhale time in ms
+    {22, 1, readBpm},          // uint8, breaths per minute
+    {23, 1, readMode},         // uint8, selector mode 1 - 4
+    {24, 9, readCurve},        // uint8 first point, 4 x uint16 steps
+    {25, 2, readCurveCommit},  // uint16, check of the curve staged
+    {26, 2, readPeak},         // uint16, peak target in 1/256 cmH20
+};
+
+const uint8_t FIELD_COUNT = sizeof(fields) / sizeof(fields[0]);
+
+// position of type in fields[] plus one, or 0 for an unknown type. only ever
+// run by the compiler to fill fieldSlots[]
+constexpr uint8_t fieldSlot(uint8_t type, uint8_t i = 0) {
+    return i == FIELD_COUNT          ? 0
+           : fields[i].type == type ? i + 1
+                                    : fieldSlot(type, i + 1);
+}
+
+#define FIELD_SLOTS_4(n) \
+    fieldSlot(n), fieldSlot(n + 1), fieldSlot(n + 2), fieldSlot(n + 3)
+#define FIELD_SLOTS_16(n) \
+    FIELD_SLOTS_4(n), FIELD_SLOTS_4(n + 4), FIELD_SLOTS_4(n + 8), FIELD_SLOTS_4(n + 12)
+#define FIELD_SLOTS_64(n) \
+    FIELD_SLOTS_16(n), FIELD_SLOTS_16(n + 16), FIELD_SLOTS_16(n + 32), FIELD_SLOTS_16(n + 48)
+
+// every byte value's slot in fields[], so checking a type and finding its
+// reader is one flash read from the Wire interrupt
+const uint8_t fieldSlots[256] PROGMEM = {
+    FIELD_SLOTS_64(0), FIELD_SLOTS_64(64), FIELD_SLOTS_64(128), FIELD_SLOTS_64(192)};
+
+// runs in the Wire interrupt, so it only checks and stashes the frame
+void receive(int bytes) {
+    uint8_t frame[FRAME_SIZE];
+    uint8_t length = 0;
     while (0 < Wire.available()) {
-        command = Wire.read();
+        uint8_t b = Wire.read();
+        if (length < FRAME_SIZE)
+            frame[length++] = b;
+    }
+
+    if (length == STREAM_SIZE && frame[0] == STREAM_START) {
+        if (crc8(frame, STREAM_SIZE - 1) == frame[STREAM_SIZE - 1])
+            controlStream(frame[1] | frame[2] << 8, frame[3] | frame[4] << 8);
+        return;
+    }
+
+    update u = {0};
+    ackSeq   = length > 1 ? frame[1] : 0;
+    response = send.invalid;
+    if (readFrame(frame, length, &u)) {
+        response = send.valid;
+        incoming.fields |= u.fields;
+        if (u.fields & UPDATE_VOLUME) { incoming.volume = u.volume; }
+        if (u.fields & UPDATE_INHALE) { incoming.inhale = u.inhale; }
+        if (u.fields & UPDATE_BPM) { incoming.bpm = u.bpm; }
+        if (u.fields & UPDATE_MODE) { incoming.mode = u.mode; }
+        if (u.fields & UPDATE_PEAK) { incoming.peak = u.peak; }
+        if (u.fields & UPDATE_CURVE) { incoming.check = u.check; }
+        if (u.chunk) { calibrationStage(u.chunk[0], u.chunk + 1); }
+    } else {
+        LOG_WARN(FRAME_REJECTED, ackSeq, length);
     }
-    Serial.println("receive: " + String(command));
-    checkValidity(command);
 }
 
 void respond() {
-    Wire.write(response);
-    Serial.println("response: " + String(response));
-}
-
-// forms the response
-void checkValidity(uint8_t cmd) {
-    response    = send.invalid;
-    size_t size = sizeof(commandList) / sizeof(uint8_t);
-    for (int i = 0; i < size; i++) {
-        if (commandList[i] == cmd) {
-            response = send.valid;
-            break;
-        }
+    uint8_t reply[REPLY_SIZE] = {FRAME_START, ackSeq, response};
+    memcpy(reply + 3, telemetry, TELEMETRY_SIZE);
+    reply[REPLY_SIZE - 1] = crc8(reply, REPLY_SIZE - 1);
+    Wire.write(reply, REPLY_SIZE);
+}
+
+// checks the framing, CRC and every field and its range before filling in u,
+// so a frame with anything wrong in it is refused as a whole. a field is at
+// least a byte, so this is bounded by the frame size
+bool readFrame(const uint8_t *frame, uint8_t length, update *u) {
+    if (length < 4 || frame[0] != FRAME_START)
+        return false;
+    uint8_t end = length - 1;
+    if (crc8(frame, end) != frame[end])
+        return false;
+
+    uint8_t i = 3;
+    for (uint8_t n = frame[2]; n > 0; n--) {
+        if (i >= end)
+            return false;
+        uint8_t slot = pgm_read_byte(fieldSlots + frame[i++]);
+        if (slot == 0)
+            return false;
+        const field *f    = fields + slot - 1;
+        uint8_t      size = pgm_read_byte(&f->size);
+        fieldReader  read = (fieldReader)pgm_read_ptr(&f->read);
+        if (i + size > end || !read(frame + i, u))
+            return false;
+        i += size;
+    }
+    return i == end;
+}
+
+// CRC-8, polynomial 0x07, the same as the master's
+uint8_t crc8(const uint8_t *data, uint8_t length) {
+    uint8_t crc = 0;
+    while (length--) {
+        crc ^= *data++;
+        for (uint8_t i = 0; i < 8; i++)
+            crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
     }
+    return crc;
 }
 
-// runs within manager() always, only updates when necessary
+void packWord(uint8_t *block, unsigned int value) {
+    block[0] = value & 0xFF;
+    block[1] = value >> 8;
+}
+
+// builds the status block in main context, then swaps it in with interrupts
+// off so respond() never sends half of one breath and half of the next
+void packTelemetry() {
+    uint8_t block[TELEMETRY_SIZE];
+    block[0] = breath.state;
+    packWord(block + 1, breath.pressureControl ? breath.delivered : breath.volume);
+    packWord(block + 3, breath.inhalePeriod);
+    packWord(block + 5, breath.cyclePeriod);
+    packWord(block + 7, breath.inhaleTime);
+    packWord(block + 9, breath.exhaleTime);
+    packWord(block + 11, breath.cycleTime);
+    packWord(block + 13, breath.cycles);
+    packWord(block + 15, calibration.record.check);
+    noInterrupts();
+    memcpy(telemetry, block, TELEMETRY_SIZE);
+    interrupts();
+}
+
+// runs within manager() always, only updates when necessary. receive() may
+// add to incoming at any time, so it is taken with interrupts off
 void updateHandler() {
-    if (command == 3) {
+    if (incoming.fields == 0)
+        return;
+    noInterrupts();
+    update u        = incoming;
+    incoming.fields = 0;
+    interrupts();
+
+    if (u.fields & UPDATE_READY) {
         breath.ready = true;
-        command      = 0;
     }
-    if (command >= 20 && command <= 50) {
-        volumeTarget   = (float(command) - 10.0) / 50.0;
+    if (u.fields & UPDATE_VOLUME) {
+        volumeTarget   = u.volume;
         atVolumeTarget = false;
-        command        = 0;
-        Serial.println("volume target: " + String(volumeTarget));
+        LOG_INFO(VOLUME_TARGET, volumeTarget);
     }
-    if (command >= 50 && command <= 80) {
-        inhaleTarget   = ((float(command) / 20.0) - 2.0) * 1000.0;
+    if (u.fields & UPDATE_INHALE) {
+        inhaleTarget   = u.inhale;
         atInhaleTarget = false;
-        command        = 0;
-        Serial.println("inhale target: " + String(inhaleTarget));
+        LOG_INFO(INHALE_TARGET, inhaleTarget);
     }
-    if (command >= 80 && command <= 115) {
-        bpmTarget   = command - 72;
+    if (u.fields & UPDATE_BPM) {
+        bpmTarget   = u.bpm;
         atBpmTarget = false;
-        command     = 0;
-        Serial.println("bpm target: " + String(bpmTarget));
+        LOG_INFO(BPM_TARGET, bpmTarget);
+    }
+    if (u.fields & UPDATE_MODE) {
+        modeTarget = u.mode;
+        LOG_INFO(MODE_TARGET, modeTarget);
+    }
+    if (u.fields & UPDATE_PEAK) {
+        peakTarget = u.peak;
+        LOG_INFO(PEAK_TARGET, peakTarget);
+    }
+    if (u.fields & UPDATE_CURVE) {
+        if (calibrationCommit(u.check)) {
+            LOG_INFO(CURVE_ADOPTED, u.check);
+            packTelemetry();
+        } else {
+            LOG_WARN(CURVE_REJECTED, u.check);
+        }
     }
 }
 
 // updates volume once per breath cycle 1 increment at a time until reached
 void volumeUpdate() {
     // This insures that the current values are only incremented as they're
-    // supposed too. Occasionally a command doesn't get sent.
-    if (roughlyEqual(volumeTarget, breath.volume)) {
-        Serial.println("reached target volume");
+    // supposed too. Occasionally a command doesn't get sent. Volume is whole
+    // mL, so every step lands exactly on the target.
+    if (volumeTarget == breath.volume) {
+        LOG_INFO(VOLUME_REACHED);
         breath.volume  = volumeTarget;
         atVolumeTarget = true;
     } else if (volumeTarget > breath.volume) {
         breath.volume += INC_TV;
-        Serial.println("current volume: " + String(breath.volume, 2));
+        LOG_INFO(VOLUME_CURRENT, breath.volume);
     } else {
         breath.volume -= INC_TV;
-        Serial.println("current volume: " + String(breath.volume, 2));
+        LOG_INFO(VOLUME_CURRENT, breath.volume);
     }
 }
 
 // updates inhale time once per breath cycle 1 increment at a time until reached
 void inhaleUpdate() {
     if (inhaleTarget == breath.inhalePeriod) {
-        Serial.println("reached target inhale");
+        LOG_INFO(INHALE_REACHED);
         atInhaleTarget = true;
     } else if (inhaleTarget > breath.inhalePeriod) {
         breath.inhalePeriod += INC_IT;
-        Serial.print("current inhale: ");
-        Serial.println(String(float(breath.inhalePeriod / 1000.0), 2));
+        LOG_INFO(INHALE_CURRENT, breath.inhalePeriod);
     } else {
         breath.inhalePeriod -= INC_IT;
-        Serial.print("current inhale: ");
-        Serial.println(String(float(breath.inhalePeriod / 1000.0), 2));
+        LOG_INFO(INHALE_CURRENT, breath.inhalePeriod);
     }
 }
 
 // updates bpm once per breath cycle 1 increment at a time until reached
 void bpmUpdate() {
-    int tempCyclePeriod = (60.0 / float(bpmTarget)) * 1000.0;
+    int tempCyclePeriod = 60000L / bpmTarget;
     if (tempCyclePeriod == breath.cyclePeriod) {
-        Serial.println("reached bpm target");
+        LOG_INFO(BPM_REACHED);
     } else if (tempCyclePeriod > breath.cyclePeriod) {
         breath.cyclePeriod += INC_BPM;
-        Serial.print("current bpm: " + String(breath.cyclePeriod));
+        LOG_INFO(BPM_CURRENT, breath.cyclePeriod);
     } else {
         breath.cyclePeriod -= INC_BPM;
-        Serial.println("current bpm: " + String(breath.cyclePeriod));
+        LOG_INFO(BPM_CURRENT, breath.cyclePeriod);
     }
 }
 
 // * MAIN START ================================================================
 
 void setup() {
+    memoryBegin();
     Wire.begin(SLAVE_ADDR);
     Wire.onRequest(respond);
     Wire.onReceive(receive);
 
+    // nothing waits on a serial host, the prints go nowhere without one
     Serial.begin(115200);
-    while (!Serial) {
-        ;  // wait till connected
-    }
-    Serial.println("SETUP START");
+    Serial.println(F("SETUP START"));
 
     initDefaults();
-    fillCommandList();
+    calibrationBegin();
+    LOG_INFO(CURVE_LOADED, calibration.record.check, calibration.stored);
+    packTelemetry();
 
     // Modify Stepper motor mode pins for different microstepping
     //pinMode(MODE0, LOW);
@@ -428,25 +854,30 @@ void setup() {
     pinMode(ENABLE, OUTPUT);
     motorDisable();
 
-    // Stepper motor controller
+    // Stepper motor controller, SpeedyStepper homes and the step generator
+    // runs the breaths
     stepper.connectToPins(STEP, DIR);
+    stepBegin(STEP, DIR, LIMIT);
     pinMode(LIMIT, INPUT_PULLUP);
 
+    // homing is the first exhale, run as far as homing would go to find the
+    // switch. the bag is full at power up, so the first breath follows it
+    // straight away
     motorEnable();
-    moveToHome();
-    t.current = millis();
-    Serial.println("SETUP END");
+    breath.steps = STEPS * 6;
+    breath.state = 2;
+    breath.ready = true;
+    t.current    = millis();
+    memoryMark();
+    Serial.println(F("SETUP END"));
 }
 
 void loop() {
     t.current = millis();
     manager();
-
-    while (!stepper.motionComplete()) {
-        // Code ran in here must be super fast!
-        manager();
-        stepper.processMovement();
-    }
+    calibrationSave();
+    memoryUpdate(t.current);
+    logDrain();
 }
 
 // * MAIN END ==================================================================
\ No newline at end of file
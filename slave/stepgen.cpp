@@ -0,0 +1,161 @@
+// ! Implementation of stepgen ! ===============================================
+
+#include "stepgen.h"
+
+void stepBegin(uint8_t stepPin, uint8_t dirPin, uint8_t limitPin) {
+    stepgen.stepPin  = stepPin;
+    stepgen.dirPin   = dirPin;
+    stepgen.limitPin = limitPin;
+    pinMode(stepPin, OUTPUT);
+    pinMode(dirPin, OUTPUT);
+    TCCR1A = 0;
+    TCCR1B = 0;
+    TIMSK1 &= ~_BV(OCIE1A);
+    stepLatenessReset();
+}
+
+void stepMove(unsigned int count, int dir, long speed, bool stopOnLimit) {
+    stepStop();
+    if (count == 0)
+        return;
+    if (speed < long(RAMP_TICK_HZ / 0xFFFF) + 1)
+        speed = RAMP_TICK_HZ / 0xFFFF + 1;
+
+    digitalWrite(stepgen.dirPin, dir > 0 ? LOW : HIGH);
+    stepgen.total       = count;
+    stepgen.done        = 0;
+    stepgen.cruise      = RAMP_TICK_HZ / speed;
+    stepgen.stopOnLimit = stopOnLimit;
+    stepgen.tracking    = false;
+    stepgen.atLimit     = false;
+    stepgen.running     = true;
+    stepStart();
+}
+
+void stepTrack(unsigned int limit, int dir) {
+    stepStop();
+    if (limit == 0)
+        return;
+    digitalWrite(stepgen.dirPin, dir > 0 ? LOW : HIGH);
+    stepgen.total       = limit;
+    stepgen.done        = 0;
+    stepgen.cruise      = 0;
+    stepgen.level       = 0;
+    stepgen.stopOnLimit = false;
+    stepgen.tracking    = true;
+    stepgen.atLimit     = false;
+    stepgen.running     = true;
+    stepStart();
+}
+
+void stepSpeed(long speed) {
+    if (speed > 0 && speed < long(RAMP_TICK_HZ / 0xFFFF) + 1)
+        speed = RAMP_TICK_HZ / 0xFFFF + 1;
+    uint16_t cruise = speed > 0 ? RAMP_TICK_HZ / speed : 0;
+    noInterrupts();
+    stepgen.cruise = cruise;
+    interrupts();
+}
+
+void stepStart() {
+    TCNT1  = 0;
+    OCR1A  = STEP_LEAD - 1;
+    TIFR1  = _BV(OCF1A);
+    TIMSK1 |= _BV(OCIE1A);
+    TCCR1B = _BV(WGM12) | _BV(CS11);  // CTC on OCR1A, clock / 8
+}
+
+void stepStop() {
+    TIMSK1 &= ~_BV(OCIE1A);
+    TCCR1B          = 0;
+    stepgen.running = false;
+}
+
+bool stepIdle() {
+    return !stepgen.running;
+}
+
+unsigned int stepDone() {
+    noInterrupts();
+    unsigned int done = stepgen.done;
+    interrupts();
+    return done;
+}
+
+void stepLateness(uint16_t *minUs, uint16_t *maxUs, uint16_t *meanUs) {
+    noInterrupts();
+    uint16_t      lateMin = stepgen.lateMin;
+    uint16_t      lateMax = stepgen.lateMax;
+    unsigned long lateSum = stepgen.lateSum;
+    unsigned long pulses  = stepgen.pulses;
+    interrupts();
+    *minUs  = pulses ? lateMin / (RAMP_TICK_HZ / 1000000) : 0;
+    *maxUs  = lateMax / (RAMP_TICK_HZ / 1000000);
+    *meanUs = pulses ? lateSum / pulses / (RAMP_TICK_HZ / 1000000) : 0;
+}
+
+void stepLatenessReset() {
+    noInterrupts();
+    stepgen.lateMin = 0xFFFF;
+    stepgen.lateMax = 0;
+    stepgen.lateSum = 0;
+    stepgen.pulses  = 0;
+    interrupts();
+}
+
+// one ramp entry up or down toward cruise. at the foot of the ramp anything
+// slower goes straight to cruise, a stepper starts and stops that slowly
+uint16_t stepTrackGap() {
+    uint16_t target = stepgen.cruise;
+    uint16_t level  = stepgen.level;
+    uint16_t gap    = pgm_read_word(rampTicks + level);
+    if (target == 0 || target > gap) {
+        if (level > 0)
+            level--;
+    } else if (target < gap && level < RAMP_STEPS - 1) {
+        level++;
+    }
+    stepgen.level = level;
+    gap           = pgm_read_word(rampTicks + level);
+    return level == 0 && target > gap ? target : gap;
+}
+
+// a step of a move from rest is due at sqrt(2k / a), so the gap after step
+// done is the ramp entry done - 1 on the way up and remaining - 1 on the way
+// down, whichever is the slower, but never faster than cruise
+ISR(TIMER1_COMPA_vect) {
+    uint16_t late = TCNT1;
+    if (stepgen.stopOnLimit && digitalRead(stepgen.limitPin) == LOW) {
+        stepgen.atLimit = true;
+        stepStop();
+        return;
+    }
+    if (stepgen.tracking && stepgen.cruise == 0 && stepgen.level == 0) {
+        OCR1A = STEP_HOLD - 1;
+        return;
+    }
+
+    digitalWrite(stepgen.stepPin, HIGH);
+    stepgen.lateLast = late;
+    digitalWrite(stepgen.stepPin, LOW);
+    if (late < stepgen.lateMin)
+        stepgen.lateMin = late;
+    if (late > stepgen.lateMax)
+        stepgen.lateMax = late;
+    stepgen.lateSum += late;
+    stepgen.pulses++;
+
+    unsigned int done = ++stepgen.done;
+    if (done >= stepgen.total) {
+        stepStop();
+        return;
+    }
+    if (stepgen.tracking) {
+        OCR1A = stepTrackGap() - 1;
+        return;
+    }
+    unsigned int remaining = stepgen.total - done;
+    unsigned int k         = done < remaining ? done - 1 : remaining - 1;
+    uint16_t     gap       = k < RAMP_STEPS ? pgm_read_word(rampTicks + k) : 0;
+    OCR1A                  = (gap > stepgen.cruise ? gap : stepgen.cruise) - 1;
+}
@@ -0,0 +1,76 @@
+// ! Step Pulse Generator ! ====================================================
+
+#pragma once
+#include <Arduino.h>
+#include "ramp.h"
+
+// moves run from the Timer1 compare interrupt in CTC mode. each match pulses
+// STEP and loads OCR1A with the gap to the next step, read off the flash ramp
+// for the first and last steps and the cruise gap in between. the timer keeps
+// the time base, so a late interrupt delays one pulse without pushing back
+// the rest, and the main loop only starts moves and checks on them. a
+// tracking move has no profile, it climbs or descends the ramp a step at a
+// time toward whatever speed stepSpeed() last asked for, so the main loop can
+// steer it while it runs and it still never changes speed faster than
+// RAMP_ACCELERATION
+
+// ticks from the start of a move to its first step. it has to outlast the
+// interrupt, or the counter clears again before OCR1A is reloaded
+const uint16_t STEP_LEAD = 200;
+
+// ticks between looks at a tracking move that's been asked to stand still
+const uint16_t STEP_HOLD = 2000;
+
+struct stepEngine {
+    uint8_t
+        stepPin,
+        dirPin,
+        limitPin;
+    bool stopOnLimit;  // end the move early if the limit switch closes
+    bool tracking;     // speed follows stepSpeed() rather than a profile
+    volatile bool
+        running,
+        atLimit;  // the move ended on the limit switch
+    unsigned int total;
+    volatile unsigned int done;  // steps issued this move
+    volatile uint16_t cruise;    // ticks between steps at cruise speed, 0 stands still
+    uint16_t level;              // a tracking move's place on the ramp
+    // how late each pulse went out after its compare match, in ticks
+    volatile uint16_t
+        lateLast,
+        lateMin,
+        lateMax;
+    volatile unsigned long
+        lateSum,
+        pulses;
+};
+
+struct stepEngine stepgen;
+
+void stepBegin(uint8_t stepPin, uint8_t dirPin, uint8_t limitPin);
+
+// start a move of count steps at up to speed steps per second, ramping at
+// RAMP_ACCELERATION at both ends. dir > 0 drives DIR low like SpeedyStepper
+void stepMove(unsigned int count, int dir, long speed, bool stopOnLimit);
+
+// start a tracking move of up to limit steps, standing still until
+// stepSpeed() asks for more
+void stepTrack(unsigned int limit, int dir);
+
+// the speed a tracking move heads for, in steps per second, 0 to stand still
+void stepSpeed(long speed);
+
+// restarts Timer1 so the first step of a move comes STEP_LEAD ticks on
+void stepStart();
+
+void stepStop();
+
+bool stepIdle();
+
+// steps issued so far this move
+unsigned int stepDone();
+
+// how late pulses went out since the last reset, in us. the spread from
+// earliest to latest is the jitter on the step intervals
+void stepLateness(uint16_t *minUs, uint16_t *maxUs, uint16_t *meanUs);
+void stepLatenessReset();